@@ -0,0 +1,247 @@
+#include "AudioCallbackMonitor.h"
+
+namespace
+{
+    constexpr double lateCallbackThreshold = 1.5;
+
+    double ticksToMs(int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    }
+}
+
+//==============================================================================
+AudioCallbackMonitor::ScopedCallback::ScopedCallback(AudioCallbackMonitor& monitorToUse, int numSamplesInBlock) noexcept
+    : monitor(monitorToUse),
+      startTicks(juce::Time::getHighResolutionTicks()),
+      numSamples(numSamplesInBlock)
+{
+    monitor.applyPendingReset();
+}
+
+AudioCallbackMonitor::ScopedCallback::~ScopedCallback() noexcept
+{
+    monitor.recordCallback(startTicks, juce::Time::getHighResolutionTicks(), numSamples);
+}
+
+void AudioCallbackMonitor::ScopedCallback::lockAcquired() noexcept
+{
+    monitor.recordLockWait(juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+//==============================================================================
+AudioCallbackMonitor::AudioCallbackMonitor(const juce::String& monitorName)
+    : name(monitorName)
+{
+    clearCounters();
+}
+
+void AudioCallbackMonitor::prepare(double newSampleRate) noexcept
+{
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+    lastStartTicks.store(0, std::memory_order_relaxed);
+}
+
+void AudioCallbackMonitor::deviceStopped() noexcept
+{
+    lastStartTicks.store(0, std::memory_order_relaxed);
+}
+
+void AudioCallbackMonitor::reset() noexcept
+{
+    resetPending.store(true, std::memory_order_release);
+}
+
+void AudioCallbackMonitor::applyPendingReset() noexcept
+{
+    // The audio thread is the only writer, so clearing here can't interleave with a callback's updates
+    if (resetPending.load(std::memory_order_relaxed) && resetPending.exchange(false, std::memory_order_acquire))
+        clearCounters();
+}
+
+void AudioCallbackMonitor::clearCounters() noexcept
+{
+    callbacks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    lateCallbacks.store(0, std::memory_order_relaxed);
+    lastStartTicks.store(0, std::memory_order_relaxed);
+    totalTicks.store(0, std::memory_order_relaxed);
+    maxTicks.store(0, std::memory_order_relaxed);
+    totalBudgetTicks.store(0, std::memory_order_relaxed);
+    totalLockWaitTicks.store(0, std::memory_order_relaxed);
+    maxLockWaitTicks.store(0, std::memory_order_relaxed);
+    maxLoadPermille.store(0, std::memory_order_relaxed);
+
+    for (auto& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void AudioCallbackMonitor::recordCallback(int64 startTicks, int64 endTicks, int numSamples) noexcept
+{
+    const double rate = sampleRate.load(std::memory_order_relaxed);
+    const int64 elapsedTicks = endTicks - startTicks;
+
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+    totalTicks.fetch_add(elapsedTicks, std::memory_order_relaxed);
+    updateMaximum(maxTicks, elapsedTicks);
+    lastBlockSize.store(numSamples, std::memory_order_relaxed);
+
+    if (rate <= 0.0 || numSamples <= 0)
+        return;
+
+    const auto budgetTicks = static_cast<int64>(juce::Time::secondsToHighResolutionTicks(numSamples / rate));
+    if (budgetTicks <= 0)
+        return;
+
+    totalBudgetTicks.fetch_add(budgetTicks, std::memory_order_relaxed);
+
+    const double load = static_cast<double>(elapsedTicks) / static_cast<double>(budgetTicks);
+    updateMaximum(maxLoadPermille, static_cast<int64>(load * 1000.0));
+
+    if (load > 1.0)
+        overruns.fetch_add(1, std::memory_order_relaxed);
+
+    const int bucket = juce::jlimit(0, numHistogramBuckets - 1, static_cast<int>(load / histogramBucketWidth));
+    histogram[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+
+    const int64 previousStart = lastStartTicks.exchange(startTicks, std::memory_order_relaxed);
+    if (previousStart > 0 && static_cast<double>(startTicks - previousStart) > budgetTicks * lateCallbackThreshold)
+        lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioCallbackMonitor::recordLockWait(int64 waitTicks) noexcept
+{
+    totalLockWaitTicks.fetch_add(waitTicks, std::memory_order_relaxed);
+    updateMaximum(maxLockWaitTicks, waitTicks);
+}
+
+void AudioCallbackMonitor::updateMaximum(std::atomic<int64>& target, int64 value) noexcept
+{
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+//==============================================================================
+AudioCallbackMonitor::Snapshot AudioCallbackMonitor::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.name = name;
+    snapshot.sampleRate = sampleRate.load(std::memory_order_relaxed);
+    snapshot.lastBlockSize = lastBlockSize.load(std::memory_order_relaxed);
+
+    // Reset but no callback has cleared the counters yet, e.g. with the device stopped
+    if (resetPending.load(std::memory_order_acquire))
+    {
+        snapshot.histogram.assign(histogram.size(), 0);
+        return snapshot;
+    }
+
+    snapshot.callbacks = callbacks.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    snapshot.lateCallbacks = lateCallbacks.load(std::memory_order_relaxed);
+
+    const auto elapsed = totalTicks.load(std::memory_order_relaxed);
+    const auto budget = totalBudgetTicks.load(std::memory_order_relaxed);
+    snapshot.averageLoad = budget > 0 ? static_cast<double>(elapsed) / static_cast<double>(budget) : 0.0;
+    snapshot.maxLoad = static_cast<double>(maxLoadPermille.load(std::memory_order_relaxed)) / 1000.0;
+    snapshot.averageCallbackMs = snapshot.callbacks > 0 ? ticksToMs(elapsed) / static_cast<double>(snapshot.callbacks) : 0.0;
+    snapshot.maxCallbackMs = ticksToMs(maxTicks.load(std::memory_order_relaxed));
+    snapshot.totalLockWaitMs = ticksToMs(totalLockWaitTicks.load(std::memory_order_relaxed));
+    snapshot.maxLockWaitMs = ticksToMs(maxLockWaitTicks.load(std::memory_order_relaxed));
+
+    int64 bucketTotal = 0;
+    snapshot.histogram.reserve(histogram.size());
+    for (const auto& bucket : histogram)
+    {
+        snapshot.histogram.push_back(bucket.load(std::memory_order_relaxed));
+        bucketTotal += snapshot.histogram.back();
+    }
+
+    snapshot.p50Load = getLoadPercentile(snapshot.histogram, bucketTotal, 0.50);
+    snapshot.p90Load = getLoadPercentile(snapshot.histogram, bucketTotal, 0.90);
+    snapshot.p99Load = getLoadPercentile(snapshot.histogram, bucketTotal, 0.99);
+    return snapshot;
+}
+
+double AudioCallbackMonitor::getLoadPercentile(const std::vector<int64>& buckets, int64 total, double percentile) const
+{
+    if (total <= 0)
+        return 0.0;
+
+    // Report the upper edge of the bucket the percentile falls into
+    const auto threshold = static_cast<int64>(std::ceil(static_cast<double>(total) * percentile));
+    int64 cumulative = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        cumulative += buckets[i];
+        if (cumulative >= threshold)
+            return static_cast<double>(i + 1) * histogramBucketWidth;
+    }
+
+    return static_cast<double>(buckets.size()) * histogramBucketWidth;
+}
+
+//==============================================================================
+juce::var AudioCallbackMonitor::Snapshot::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("sampleRate", sampleRate);
+    object->setProperty("lastBlockSize", lastBlockSize);
+    object->setProperty("callbacks", callbacks);
+    object->setProperty("overruns", overruns);
+    object->setProperty("lateCallbacks", lateCallbacks);
+    object->setProperty("averageLoad", averageLoad);
+    object->setProperty("p50Load", p50Load);
+    object->setProperty("p90Load", p90Load);
+    object->setProperty("p99Load", p99Load);
+    object->setProperty("maxLoad", maxLoad);
+    object->setProperty("averageCallbackMs", averageCallbackMs);
+    object->setProperty("maxCallbackMs", maxCallbackMs);
+    object->setProperty("totalLockWaitMs", totalLockWaitMs);
+    object->setProperty("maxLockWaitMs", maxLockWaitMs);
+    object->setProperty("histogramBucketWidth", histogramBucketWidth);
+
+    juce::Array<juce::var> buckets;
+    for (auto count : histogram)
+        buckets.add(count);
+    object->setProperty("loadHistogram", buckets);
+
+    return juce::var(object);
+}
+
+juce::String AudioCallbackMonitor::createJSONReport(const std::vector<const AudioCallbackMonitor*>& monitors,
+                                                    juce::AudioDeviceManager* deviceManager)
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+
+    if (deviceManager != nullptr)
+    {
+        if (auto* device = deviceManager->getCurrentAudioDevice())
+        {
+            auto* deviceObject = new juce::DynamicObject();
+            deviceObject->setProperty("name", device->getName());
+            deviceObject->setProperty("type", device->getTypeName());
+            deviceObject->setProperty("sampleRate", device->getCurrentSampleRate());
+            deviceObject->setProperty("bufferSize", device->getCurrentBufferSizeSamples());
+            deviceObject->setProperty("outputLatencySamples", device->getOutputLatencyInSamples());
+            deviceObject->setProperty("deviceXRuns", device->getXRunCount());
+            deviceObject->setProperty("cpuUsage", deviceManager->getCpuUsage());
+            root->setProperty("device", juce::var(deviceObject));
+        }
+    }
+
+    juce::Array<juce::var> callbackStats;
+    for (const auto* monitor : monitors)
+    {
+        if (monitor != nullptr)
+            callbackStats.add(monitor->getSnapshot().toVar());
+    }
+    root->setProperty("callbacks", callbackStats);
+
+    return juce::JSON::toString(juce::var(root));
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+ * Low-overhead timing statistics for one audio device callback.
+ *
+ * The audio thread only touches relaxed atomics: each callback records its
+ * duration as a fraction of the buffer budget into a fixed histogram, along
+ * with overruns, late callbacks and the time spent waiting for the player's
+ * lock. The message thread reads a Snapshot for display or JSON export.
+ */
+class AudioCallbackMonitor
+{
+public:
+    //==============================================================================
+    struct Snapshot
+    {
+        juce::String name;
+        double sampleRate = 0.0;
+        int lastBlockSize = 0;
+        int64 callbacks = 0;
+        int64 overruns = 0;        // callbacks that took longer than their buffer budget
+        int64 lateCallbacks = 0;   // gaps between callbacks over 1.5x the budget (likely xruns)
+        double averageLoad = 0.0;  // fractions of the buffer budget
+        double p50Load = 0.0;
+        double p90Load = 0.0;
+        double p99Load = 0.0;
+        double maxLoad = 0.0;
+        double averageCallbackMs = 0.0;
+        double maxCallbackMs = 0.0;
+        double totalLockWaitMs = 0.0;
+        double maxLockWaitMs = 0.0;
+        std::vector<int64> histogram;
+
+        juce::var toVar() const;
+    };
+
+    //==============================================================================
+    /**
+     * Times one callback. Construct it first thing in the callback and call
+     * lockAcquired() straight after taking the player's lock.
+     */
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback(AudioCallbackMonitor& monitorToUse, int numSamplesInBlock) noexcept;
+        ~ScopedCallback() noexcept;
+
+        void lockAcquired() noexcept;
+
+    private:
+        AudioCallbackMonitor& monitor;
+        const int64 startTicks;
+        const int numSamples;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    //==============================================================================
+    explicit AudioCallbackMonitor(const juce::String& monitorName);
+
+    /** Call from audioDeviceAboutToStart() with the device sample rate. */
+    void prepare(double newSampleRate) noexcept;
+
+    /** Call from audioDeviceStopped() so the restart gap isn't counted as late. */
+    void deviceStopped() noexcept;
+
+    /**
+     * Clear all counters. Safe to call while the device is running: the audio
+     * thread does the clearing at the start of its next callback, so no
+     * callback is ever recorded half into the old stats and half into the new.
+     * Snapshots read as cleared from now on.
+     */
+    void reset() noexcept;
+
+    Snapshot getSnapshot() const;
+    const juce::String& getName() const { return name; }
+
+    /**
+     * Build a JSON report covering several monitors plus the current device setup.
+     * @param monitors Monitors to include
+     * @param deviceManager Optional device manager for buffer size and device xrun count
+     */
+    static juce::String createJSONReport(const std::vector<const AudioCallbackMonitor*>& monitors,
+                                         juce::AudioDeviceManager* deviceManager);
+
+    //==============================================================================
+    static constexpr int numHistogramBuckets = 40;       // 5% of the budget per bucket
+    static constexpr double histogramBucketWidth = 0.05;  // last bucket collects >= 195%
+
+private:
+    //==============================================================================
+    const juce::String name;
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<int> lastBlockSize { 0 };
+    std::atomic<int64> callbacks { 0 };
+    std::atomic<int64> overruns { 0 };
+    std::atomic<int64> lateCallbacks { 0 };
+    std::atomic<int64> lastStartTicks { 0 };
+    std::atomic<int64> totalTicks { 0 };
+    std::atomic<int64> maxTicks { 0 };
+    std::atomic<int64> totalBudgetTicks { 0 };
+    std::atomic<int64> totalLockWaitTicks { 0 };
+    std::atomic<int64> maxLockWaitTicks { 0 };
+    std::atomic<int64> maxLoadPermille { 0 };
+    std::array<std::atomic<int64>, numHistogramBuckets> histogram;
+    std::atomic<bool> resetPending { false };
+
+    void applyPendingReset() noexcept;
+    void clearCounters() noexcept;
+    void recordCallback(int64 startTicks, int64 endTicks, int numSamples) noexcept;
+    void recordLockWait(int64 waitTicks) noexcept;
+    double getLoadPercentile(const std::vector<int64>& buckets, int64 total, double percentile) const;
+    static void updateMaximum(std::atomic<int64>& target, int64 value) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMonitor)
+};
@@ -3,6 +3,8 @@
 namespace
 {
     constexpr double sampleRateToleranceHz = 0.1;
+    constexpr double seamEdgeFadeMs = 3.0;
+    constexpr double seamRepeatGapMs = 250.0;
 }
 
 //==============================================================================
@@ -50,6 +52,185 @@ void AudioPlayer::setPosition(double seconds)
     fractionalSample = static_cast<double>(currentSample);
 }
 
+//==============================================================================
+void AudioPlayer::setSeamAuditionEnabled(bool shouldAudition)
+{
+    if (seamAuditionEnabled == shouldAudition)
+        return;
+
+    seamAuditionEnabled = shouldAudition;
+
+    if (seamAuditionEnabled)
+    {
+        rebuildSeamRender();
+
+        // Jump a running player to the seam; ticking the option alone never starts playback
+        if (playing)
+            restartSeamAudition();
+    }
+    else
+    {
+        std::unique_ptr<SeamRender> oldRender;
+        {
+            const juce::ScopedLock sl(lock);
+            std::swap(oldRender, seamRender);
+            fractionalSample = static_cast<double>(currentSample);
+        }
+    }
+}
+
+void AudioPlayer::setSeamAuditionLengthMs(double lengthMs)
+{
+    lengthMs = juce::jlimit(minSeamAuditionMs, maxSeamAuditionMs, lengthMs);
+    if (std::abs(lengthMs - seamAuditionLengthMs) < 0.5)
+        return;
+
+    seamAuditionLengthMs = lengthMs;
+
+    if (seamAuditionEnabled)
+        rebuildSeamRender();
+}
+
+void AudioPlayer::restartSeamAudition()
+{
+    const juce::ScopedLock sl(lock);
+
+    if (seamRender == nullptr)
+        return;
+
+    seamPosition = 0.0;
+    playing = true;
+}
+
+void AudioPlayer::rebuildSeamRender()
+{
+    // Render on the calling (message) thread, then swap under the lock so
+    // the audio callback only ever copies from a finished buffer.
+    auto newRender = renderSeam();
+    std::unique_ptr<SeamRender> oldRender;
+
+    {
+        const juce::ScopedLock sl(lock);
+        std::swap(oldRender, seamRender);
+        seamRender = std::move(newRender);
+
+        if (seamRender != nullptr)
+            seamPosition = juce::jlimit(0.0, static_cast<double>(seamRender->audio.getNumSamples() - 1), seamPosition);
+    }
+}
+
+std::unique_ptr<AudioPlayer::SeamRender> AudioPlayer::renderSeam() const
+{
+    if (projectState == nullptr || !projectState->hasAudio() || !projectState->hasLoopPoints())
+        return nullptr;
+
+    const auto& source = projectState->getAudioBuffer();
+    const double sourceRate = projectState->getSampleRate();
+    const int64 totalSamples = source.getNumSamples();
+    if (sourceRate <= 0.0 || totalSamples <= 0)
+        return nullptr;
+
+    const int64 loopStart = juce::jlimit(static_cast<int64>(0), totalSamples - 1, projectState->getLoopStart());
+    const int64 loopEnd = juce::jlimit(loopStart + 1, totalSamples, projectState->getLoopEnd());
+    const int64 loopLength = loopEnd - loopStart;
+    const auto seamLength = static_cast<int64>(seamAuditionLengthMs * sourceRate / 1000.0);
+
+    auto render = std::make_unique<SeamRender>();
+    render->preRollLength = static_cast<int>(juce::jmin(seamLength, loopEnd));
+    render->preRollStart = loopEnd - render->preRollLength;
+    render->postRollStart = loopStart;
+    render->postRollLength = static_cast<int>(juce::jmin(seamLength, loopLength, totalSamples - loopStart));
+
+    const int gapLength = static_cast<int>(seamRepeatGapMs * sourceRate / 1000.0);
+    const int contentLength = render->preRollLength + render->postRollLength;
+    const int numChannels = source.getNumChannels();
+
+    render->audio.setSize(numChannels, contentLength + gapLength);
+    render->audio.clear();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        render->audio.copyFrom(ch, 0, source, ch, static_cast<int>(render->preRollStart), render->preRollLength);
+        render->audio.copyFrom(ch, render->preRollLength, source, ch, static_cast<int>(render->postRollStart), render->postRollLength);
+    }
+
+    // Short fades on the outer edges only, so the repeat doesn't click but the seam itself is untouched
+    const int fadeLength = juce::jmin(contentLength / 4, static_cast<int>(seamEdgeFadeMs * sourceRate / 1000.0));
+    if (fadeLength > 0)
+    {
+        render->audio.applyGainRamp(0, fadeLength, 0.0f, 1.0f);
+        render->audio.applyGainRamp(contentLength - fadeLength, fadeLength, 1.0f, 0.0f);
+    }
+
+    return render;
+}
+
+void AudioPlayer::renderSeamBlock(float* const* outputChannelData, int numOutputChannels, int numSamples)
+{
+    const auto& audio = seamRender->audio;
+    const int seamLength = audio.getNumSamples();
+    const int channelCount = juce::jmin(numOutputChannels, audio.getNumChannels());
+    const double sourceRate = projectState->getSampleRate();
+
+    if (resamplingActive)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (seamPosition >= seamLength)
+                seamPosition -= seamLength;
+
+            const int index = static_cast<int>(seamPosition);
+            const int nextIndex = index + 1 < seamLength ? index + 1 : 0;
+            const float fraction = static_cast<float>(seamPosition - index);
+
+            for (int channel = 0; channel < channelCount; ++channel)
+            {
+                if (outputChannelData[channel] != nullptr)
+                {
+                    const float sample1 = audio.getSample(channel, index);
+                    const float sample2 = audio.getSample(channel, nextIndex);
+                    outputChannelData[channel][i] = sample1 + fraction * (sample2 - sample1);
+                }
+            }
+
+            seamPosition += resamplingRatio;
+        }
+    }
+    else
+    {
+        int samplesWritten = 0;
+        while (samplesWritten < numSamples)
+        {
+            auto index = static_cast<int>(seamPosition);
+            if (index >= seamLength)
+                index = 0;
+
+            const int samplesToCopy = juce::jmin(numSamples - samplesWritten, seamLength - index);
+            for (int channel = 0; channel < channelCount; ++channel)
+            {
+                if (outputChannelData[channel] != nullptr)
+                    juce::FloatVectorOperations::copy(outputChannelData[channel] + samplesWritten,
+                                                      audio.getReadPointer(channel, index),
+                                                      samplesToCopy);
+            }
+
+            samplesWritten += samplesToCopy;
+            seamPosition = static_cast<double>(index + samplesToCopy);
+        }
+    }
+
+    // Report the playhead in the loop editor's timeline
+    const int seamIndex = juce::jlimit(0, seamLength - 1, static_cast<int>(seamPosition));
+    int64 bufferIndex = seamRender->postRollStart + seamRender->postRollLength;
+    if (seamIndex < seamRender->preRollLength)
+        bufferIndex = seamRender->preRollStart + seamIndex;
+    else if (seamIndex < seamRender->preRollLength + seamRender->postRollLength)
+        bufferIndex = seamRender->postRollStart + (seamIndex - seamRender->preRollLength);
+
+    currentSample = static_cast<int>(juce::jmax(static_cast<int64>(0), bufferIndex - projectState->getEffectivePlaybackStart()));
+    currentPosition = static_cast<double>(currentSample) / sourceRate;
+}
+
 //==============================================================================
 void AudioPlayer::setProjectState(MSUProjectState* state)
 {
@@ -76,6 +257,7 @@ void AudioPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChan
                                                    const juce::AudioIODeviceCallbackContext& context)
 {
     juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    AudioCallbackMonitor::ScopedCallback callbackTiming(callbackMonitor, numSamples);
 
     auto clearOutput = [&](int startSample)
     {
@@ -93,6 +275,7 @@ void AudioPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChan
     clearOutput(0);
     
     const juce::ScopedLock sl(lock);
+    callbackTiming.lockAcquired();
     
     if (!playing || projectState == nullptr || !projectState->hasAudio())
         return;
@@ -107,6 +290,12 @@ void AudioPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChan
     updateResamplingState();
     const bool shouldResample = resamplingActive;
     
+    if (seamAuditionEnabled && seamRender != nullptr && seamRender->audio.getNumSamples() > 0)
+    {
+        renderSeamBlock(outputChannelData, numOutputChannels, numSamples);
+        return;
+    }
+    
     // Get trim and padding settings
     const int64 paddingSamples = projectState->getPaddingSamples();
     const int64 effectiveStart = projectState->getEffectivePlaybackStart();
@@ -299,6 +488,7 @@ void AudioPlayer::audioDeviceAboutToStart(juce::AudioIODevice* device)
     }
 
     deviceSampleRate = device->getCurrentSampleRate();
+    callbackMonitor.prepare(deviceSampleRate);
     fractionalSample = static_cast<double>(currentSample);
     updateResamplingState();
     DBG("Audio device starting: " + device->getName() + " at " + juce::String(deviceSampleRate) + " Hz");
@@ -309,6 +499,7 @@ void AudioPlayer::audioDeviceStopped()
     const juce::ScopedLock sl(lock);
     deviceSampleRate = 0.0;
     resamplingActive = false;
+    callbackMonitor.deviceStopped();
     DBG("Audio device stopped");
 }
 
@@ -335,4 +526,8 @@ void AudioPlayer::changeListenerCallback(juce::ChangeBroadcaster* source)
 
         updateResamplingState();
     }
+
+    // Loop points, trim or audio may have moved; keep the seam in sync
+    if (source == projectState && seamAuditionEnabled)
+        rebuildSeamRender();
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
 #include "../Core/MSUProjectState.h"
+#include "AudioCallbackMonitor.h"
 
 //==============================================================================
 /**
@@ -31,10 +33,30 @@ public:
     void setPosition(double seconds);
     double getPosition() const { return currentPosition; }
     
+    //==============================================================================
+    // Loop-seam audition: repeatedly plays the last N ms before the loop end
+    // followed by the first N ms after the loop start, from a pre-rendered buffer.
+    void setSeamAuditionEnabled(bool shouldAudition);
+    bool isSeamAuditionEnabled() const { return seamAuditionEnabled; }
+    
+    /** Set the seam half-length in milliseconds; takes effect immediately while playing */
+    void setSeamAuditionLengthMs(double lengthMs);
+    double getSeamAuditionLengthMs() const { return seamAuditionLengthMs; }
+    
+    /** Jump back to the start of the seam and play */
+    void restartSeamAudition();
+    
+    static constexpr double minSeamAuditionMs = 50.0;
+    static constexpr double maxSeamAuditionMs = 5000.0;
+    
     //==============================================================================
     // Project state
     void setProjectState(MSUProjectState* state);
     
+    //==============================================================================
+    /** Callback timing statistics for the diagnostics panel */
+    AudioCallbackMonitor& getCallbackMonitor() { return callbackMonitor; }
+    
     //==============================================================================
     // AudioIODeviceCallback implementation
     void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
@@ -55,9 +77,10 @@ private:
     //==============================================================================
     MSUProjectState* projectState = nullptr;
     
-    bool playing = false;
+    // Read by the UI every frame without taking the lock
+    std::atomic<bool> playing { false };
     bool looping = false;
-    double currentPosition = 0.0;
+    std::atomic<double> currentPosition { 0.0 };
     int currentSample = 0;
     double fractionalSample = 0.0;
     
@@ -65,9 +88,27 @@ private:
     double resamplingRatio = 1.0;
     bool resamplingActive = false;
     
+    struct SeamRender
+    {
+        juce::AudioBuffer<float> audio;  // pre-roll, post-roll, then a short silent gap
+        int64 preRollStart = 0;          // buffer index of the first pre-roll sample
+        int preRollLength = 0;
+        int64 postRollStart = 0;         // loop start
+        int postRollLength = 0;
+    };
+    
+    std::atomic<bool> seamAuditionEnabled { false };
+    double seamAuditionLengthMs = 1000.0;
+    std::unique_ptr<SeamRender> seamRender;
+    double seamPosition = 0.0;
+    
     juce::CriticalSection lock;
+    AudioCallbackMonitor callbackMonitor { "AudioPlayer" };
 
     void updateResamplingState();
+    void rebuildSeamRender();
+    std::unique_ptr<SeamRender> renderSeam() const;
+    void renderSeamBlock(float* const* outputChannelData, int numOutputChannels, int numSamples);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPlayer)
 };
@@ -1,5 +1,7 @@
 #include "BeforeAfterPreviewPlayer.h"
 
+#include <cmath>
+
 BeforeAfterPreviewPlayer::BeforeAfterPreviewPlayer()
 {
     updatePlaybackIncrement();
@@ -16,6 +18,17 @@ void BeforeAfterPreviewPlayer::setSourceBuffers(const juce::AudioBuffer<float>*
     currentSample = 0.0;
     playing = false;
     updatePlaybackIncrement();
+    publishProgress();
+}
+
+void BeforeAfterPreviewPlayer::setAfterGain(float gainDb)
+{
+    const juce::ScopedLock sl(lock);
+    afterGain = std::isfinite(gainDb) ? juce::Decibels::decibelsToGain(gainDb) : 1.0f;
+
+    // Nothing audible to ramp from
+    if (!playing || activeTarget != Target::After)
+        appliedAfterGain = afterGain;
 }
 
 void BeforeAfterPreviewPlayer::play(Target target, bool restartPlayback)
@@ -29,12 +42,15 @@ void BeforeAfterPreviewPlayer::play(Target target, bool restartPlayback)
     {
         activeTarget = target;
         currentSample = juce::jlimit(0.0, static_cast<double>(buffer->getNumSamples()), currentSample);
+        publishProgress();
         return;
     }
 
     activeTarget = target;
     currentSample = 0.0;
+    appliedAfterGain = afterGain;
     playing = true;
+    publishProgress();
 }
 
 void BeforeAfterPreviewPlayer::stop()
@@ -42,6 +58,7 @@ void BeforeAfterPreviewPlayer::stop()
     const juce::ScopedLock sl(lock);
     playing = false;
     currentSample = 0.0;
+    publishProgress();
 }
 
 bool BeforeAfterPreviewPlayer::isPlaying() const
@@ -56,21 +73,26 @@ bool BeforeAfterPreviewPlayer::hasContent(Target target) const
     return bufferHasContent(getBufferFor(target));
 }
 
-bool BeforeAfterPreviewPlayer::getPlaybackProgress(double& currentSeconds, double& totalSeconds) const
+BeforeAfterPreviewPlayer::Progress BeforeAfterPreviewPlayer::getProgress() const noexcept
 {
-    const juce::ScopedLock sl(lock);
-    const auto* buffer = getBufferFor(activeTarget);
+    Progress progress;
+    progress.playing = publishedPlaying.load(std::memory_order_relaxed);
+    progress.target = publishedAfter.load(std::memory_order_relaxed) ? Target::After : Target::Before;
+    progress.currentSeconds = publishedSeconds.load(std::memory_order_relaxed);
+    progress.totalSeconds = publishedTotalSeconds.load(std::memory_order_relaxed);
+    return progress;
+}
 
-    if (!playing || !bufferHasContent(buffer) || sourceSampleRate <= 0.0)
-    {
-        currentSeconds = 0.0;
-        totalSeconds = 0.0;
-        return false;
-    }
+void BeforeAfterPreviewPlayer::publishProgress() noexcept
+{
+    const auto* buffer = getBufferFor(activeTarget);
+    const bool active = playing && bufferHasContent(buffer) && sourceSampleRate > 0.0;
 
-    totalSeconds = static_cast<double>(buffer->getNumSamples()) / sourceSampleRate;
-    currentSeconds = currentSample / sourceSampleRate;
-    return totalSeconds > 0.0;
+    publishedPlaying.store(playing, std::memory_order_relaxed);
+    publishedAfter.store(activeTarget == Target::After, std::memory_order_relaxed);
+    publishedSeconds.store(active ? currentSample / sourceSampleRate : 0.0, std::memory_order_relaxed);
+    publishedTotalSeconds.store(active ? static_cast<double>(buffer->getNumSamples()) / sourceSampleRate : 0.0,
+                                std::memory_order_relaxed);
 }
 
 void BeforeAfterPreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
@@ -81,13 +103,16 @@ void BeforeAfterPreviewPlayer::audioDeviceIOCallbackWithContext(const float* con
                                                                 const juce::AudioIODeviceCallbackContext& context)
 {
     juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    AudioCallbackMonitor::ScopedCallback callbackTiming(callbackMonitor, numSamples);
 
     const juce::ScopedLock sl(lock);
+    callbackTiming.lockAcquired();
     auto* buffer = getBufferFor(activeTarget);
     if (!playing || !bufferHasContent(buffer))
     {
         playing = false;
         writeSilence(outputChannelData, numOutputChannels, numSamples);
+        publishProgress();
         return;
     }
 
@@ -95,6 +120,12 @@ void BeforeAfterPreviewPlayer::audioDeviceIOCallbackWithContext(const float* con
     auto channels = juce::jmax(1, buffer->getNumChannels());
     double position = currentSample;
 
+    // Before plays at unity; After ramps linearly to its target gain across the block
+    const bool applyAfterGain = activeTarget == Target::After;
+    const float startGain = applyAfterGain ? appliedAfterGain : 1.0f;
+    const float endGain = applyAfterGain ? afterGain : 1.0f;
+    const float gainStep = (endGain - startGain) / static_cast<float>(juce::jmax(1, numSamples));
+
     for (int sample = 0; sample < numSamples; ++sample)
     {
         auto index = static_cast<int>(position);
@@ -107,6 +138,7 @@ void BeforeAfterPreviewPlayer::audioDeviceIOCallbackWithContext(const float* con
 
         auto nextIndex = juce::jmin(index + 1, totalSamples - 1);
         auto fraction = position - static_cast<double>(index);
+        const float gain = startGain + gainStep * static_cast<float>(sample + 1);
 
         for (int ch = 0; ch < numOutputChannels; ++ch)
         {
@@ -116,15 +148,19 @@ void BeforeAfterPreviewPlayer::audioDeviceIOCallbackWithContext(const float* con
             auto sourceChannel = ch % channels;
             auto sampleA = buffer->getSample(sourceChannel, index);
             auto sampleB = buffer->getSample(sourceChannel, nextIndex);
-            outputChannelData[ch][sample] = sampleA + static_cast<float>(fraction) * (sampleB - sampleA);
+            outputChannelData[ch][sample] = gain * (sampleA + static_cast<float>(fraction) * (sampleB - sampleA));
         }
 
         position += playbackIncrement;
     }
 
+    if (applyAfterGain)
+        appliedAfterGain = afterGain;
+
     currentSample = position;
     if (!playing)
         currentSample = 0.0;
+    publishProgress();
 }
 
 void BeforeAfterPreviewPlayer::audioDeviceAboutToStart(juce::AudioIODevice* device)
@@ -133,6 +169,7 @@ void BeforeAfterPreviewPlayer::audioDeviceAboutToStart(juce::AudioIODevice* devi
     deviceSampleRate = (device != nullptr && device->getCurrentSampleRate() > 0.0)
         ? device->getCurrentSampleRate()
         : fallbackSampleRate;
+    callbackMonitor.prepare(deviceSampleRate);
     updatePlaybackIncrement();
 }
 
@@ -140,6 +177,7 @@ void BeforeAfterPreviewPlayer::audioDeviceStopped()
 {
     const juce::ScopedLock sl(lock);
     deviceSampleRate = fallbackSampleRate;
+    callbackMonitor.deviceStopped();
     updatePlaybackIncrement();
 }
 
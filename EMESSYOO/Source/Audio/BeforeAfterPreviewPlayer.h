@@ -1,10 +1,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
+#include "AudioCallbackMonitor.h"
 
 /**
  * Lightweight audio callback that can preview two in-memory buffers ("Before" and "After")
  * using the shared AudioDeviceManager. Designed for Audio Level Studio A/B comparisons.
+ *
+ * The "After" target is played with a gain applied at render time, so a preset
+ * preview can pass the same buffer for both targets instead of a gained copy.
  */
 class BeforeAfterPreviewPlayer : public juce::AudioIODeviceCallback
 {
@@ -15,6 +20,14 @@ public:
         After
     };
 
+    struct Progress
+    {
+        bool playing = false;
+        Target target = Target::Before;
+        double currentSeconds = 0.0;
+        double totalSeconds = 0.0;
+    };
+
     BeforeAfterPreviewPlayer();
     ~BeforeAfterPreviewPlayer() override = default;
 
@@ -22,13 +35,19 @@ public:
                           const juce::AudioBuffer<float>* afterBuffer,
                           double bufferSampleRate);
 
+    /** Gain for the "After" target; changes are ramped over one block while playing. */
+    void setAfterGain(float gainDb);
+
     void play(Target target, bool restartPlayback);
     void stop();
 
     bool isPlaying() const;
     bool hasContent(Target target) const;
     Target getActiveTarget() const { return activeTarget; }
-    bool getPlaybackProgress(double& currentSeconds, double& totalSeconds) const;
+
+    // Lock-free, so the UI can poll it every frame without contending with the audio thread
+    Progress getProgress() const noexcept;
+    AudioCallbackMonitor& getCallbackMonitor() { return callbackMonitor; }
 
     void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
                                           int numInputChannels,
@@ -48,13 +67,23 @@ private:
     double playbackIncrement = 1.0;
 
     mutable juce::CriticalSection lock;
+    AudioCallbackMonitor callbackMonitor { "BeforeAfterPreviewPlayer" };
     bool playing = false;
     double currentSample = 0.0;
     Target activeTarget = Target::Before;
+    float afterGain = 1.0f;         // target linear gain for the After buffer
+    float appliedAfterGain = 1.0f;  // gain reached at the end of the last block
+
+    // Copies of the state above for getProgress(), refreshed under the lock
+    std::atomic<bool> publishedPlaying { false };
+    std::atomic<bool> publishedAfter { false };
+    std::atomic<double> publishedSeconds { 0.0 };
+    std::atomic<double> publishedTotalSeconds { 0.0 };
 
     const juce::AudioBuffer<float>* getBufferFor(Target target) const;
     bool bufferHasContent(const juce::AudioBuffer<float>* buffer) const;
     void updatePlaybackIncrement();
+    void publishProgress() noexcept;
     void writeSilence(float* const* outputChannelData, int numOutputChannels, int numSamples) const;
 
     static constexpr double fallbackSampleRate = 44100.0;
@@ -0,0 +1,514 @@
+#include "LoopFinder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace
+{
+    // Analysis frames: roughly 80 ms, half overlapping
+    constexpr double frameSeconds = 0.08;
+
+    // Frames either side of a loop start that must match the frames one loop later
+    constexpr double seamWindowSeconds = 1.5;
+
+    // Raw audio compared around each seam when refining to sample accuracy
+    constexpr double refineSeconds = 0.2;
+
+    // Frames quieter than this carry no features, so silence never matches silence
+    constexpr float silenceMeanSquare = 1.0e-6f; // -60 dBFS
+
+    constexpr float chromaMinHz = 55.0f;
+    constexpr float chromaMaxHz = 5000.0f;
+    constexpr float bandMinHz = 40.0f;
+    constexpr float bandMaxHz = 16000.0f;
+
+    // Loop lengths examined per requested candidate
+    constexpr int lengthsPerCandidate = 3;
+
+    // Candidates closer than this at both ends are treated as the same loop
+    constexpr double duplicateSeconds = 0.5;
+
+    // Frames handled between shouldExit polls
+    constexpr int exitCheckInterval = 64;
+
+    int getOrderForSize(int minimumSize)
+    {
+        int order = 1;
+        while ((1 << order) < minimumSize)
+            ++order;
+        return order;
+    }
+
+    void normalise(float* values, int count, float targetLength)
+    {
+        float sumOfSquares = 0.0f;
+        for (int i = 0; i < count; ++i)
+            sumOfSquares += values[i] * values[i];
+
+        if (sumOfSquares <= 0.0f)
+            return;
+
+        const float scale = targetLength / std::sqrt(sumOfSquares);
+        for (int i = 0; i < count; ++i)
+            values[i] *= scale;
+    }
+}
+
+//==============================================================================
+struct LoopFinder::Analysis
+{
+    std::vector<float> mono;
+    double sampleRate = 44100.0;
+
+    int fftOrder = 0;
+    int fftSize = 0;
+    int hopSize = 0;
+    int numFrames = 0;
+    int seamWindowFrames = 0;
+
+    // Per FFT bin: pitch class and band index, -1 when outside the analysed range
+    std::vector<int> chromaBinForBin;
+    std::vector<int> bandForBin;
+
+    // numFrames * numFeatures, unit length per frame (or all zero for silence)
+    std::vector<float> features;
+
+    int64 getNumSamples() const { return static_cast<int64>(mono.size()); }
+    const float* getFeatures(int frame) const { return features.data() + static_cast<size_t>(frame) * numFeatures; }
+    int64 getFrameCentre(int frame) const { return static_cast<int64>(frame) * hopSize + fftSize / 2; }
+
+    float getSimilarity(int frameA, int frameB) const
+    {
+        const float* a = getFeatures(frameA);
+        const float* b = getFeatures(frameB);
+        float dot = 0.0f;
+        for (int i = 0; i < numFeatures; ++i)
+            dot += a[i] * b[i];
+        return dot;
+    }
+};
+
+//==============================================================================
+LoopFinder::LoopFinder()
+    : workers(juce::jlimit(1, maxWorkers, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+std::vector<LoopFinder::Candidate> LoopFinder::findLoops(const juce::AudioBuffer<float>& buffer,
+                                                         double sampleRate,
+                                                         const Settings& settings,
+                                                         const std::function<bool()>& shouldExit)
+{
+    auto exitRequested = [&shouldExit] { return shouldExit && shouldExit(); };
+
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 0)
+        return {};
+
+    Analysis analysis;
+    analysis.sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    analysis.fftOrder = getOrderForSize(static_cast<int>(analysis.sampleRate * frameSeconds));
+    analysis.fftSize = 1 << analysis.fftOrder;
+    analysis.hopSize = analysis.fftSize / 2;
+    analysis.seamWindowFrames = juce::jmax(2, juce::roundToInt(seamWindowSeconds * analysis.sampleRate / analysis.hopSize));
+
+    if (numSamples < analysis.fftSize * 4)
+        return {};
+
+    // Seams are judged on the mono mixdown
+    analysis.mono.assign(buffer.getReadPointer(0), buffer.getReadPointer(0) + numSamples);
+    for (int ch = 1; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::add(analysis.mono.data(), buffer.getReadPointer(ch), numSamples);
+    if (numChannels > 1)
+        juce::FloatVectorOperations::multiply(analysis.mono.data(), 1.0f / static_cast<float>(numChannels), numSamples);
+
+    analysis.numFrames = (numSamples - analysis.fftSize) / analysis.hopSize + 1;
+
+    extractFeatures(analysis, shouldExit);
+    if (exitRequested())
+        return {};
+
+    const int minLag = juce::jmax(1, static_cast<int>(std::ceil(settings.minLoopSeconds * analysis.sampleRate / analysis.hopSize)));
+    const int firstFrame = juce::jmax(0, static_cast<int>(std::ceil(static_cast<double>(settings.searchStart - analysis.fftSize / 2)
+                                                                     / analysis.hopSize)));
+    const int maxCandidates = juce::jmax(1, settings.maxCandidates);
+
+    const auto lags = pickLoopLengths(analysis, minLag, maxCandidates * lengthsPerCandidate, shouldExit);
+    if (lags.empty() || exitRequested())
+        return {};
+
+    // Best start for each loop length
+    std::vector<Candidate> coarse(lags.size());
+    parallelFor(static_cast<int>(lags.size()), [&](int i)
+    {
+        if (!exitRequested())
+            coarse[static_cast<size_t>(i)] = findBestStart(analysis, lags[static_cast<size_t>(i)], firstFrame);
+    });
+    if (exitRequested())
+        return {};
+
+    coarse.erase(std::remove_if(coarse.begin(), coarse.end(), [](const Candidate& c) { return c.score <= 0.0f; }),
+                 coarse.end());
+    std::sort(coarse.begin(), coarse.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+    if (coarse.size() > static_cast<size_t>(maxCandidates * 2))
+        coarse.resize(static_cast<size_t>(maxCandidates * 2));
+
+    // Sample-accurate loop lengths
+    std::vector<Candidate> refined(coarse.size());
+    parallelFor(static_cast<int>(coarse.size()), [&](int i)
+    {
+        if (!exitRequested())
+            refined[static_cast<size_t>(i)] = refine(analysis, coarse[static_cast<size_t>(i)]);
+    });
+    if (exitRequested())
+        return {};
+
+    std::sort(refined.begin(), refined.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    const auto duplicateSamples = static_cast<int64>(duplicateSeconds * analysis.sampleRate);
+    std::vector<Candidate> results;
+    for (const auto& candidate : refined)
+    {
+        const bool duplicate = std::any_of(results.begin(), results.end(), [&](const Candidate& kept)
+        {
+            return std::abs(kept.loopStart - candidate.loopStart) < duplicateSamples
+                && std::abs(kept.loopEnd - candidate.loopEnd) < duplicateSamples;
+        });
+
+        if (!duplicate)
+            results.push_back(candidate);
+        if (static_cast<int>(results.size()) >= maxCandidates)
+            break;
+    }
+
+    return results;
+}
+
+//==============================================================================
+void LoopFinder::extractFeatures(Analysis& analysis, const std::function<bool()>& shouldExit)
+{
+    const int numBins = analysis.fftSize / 2 + 1;
+    const float binHz = static_cast<float>(analysis.sampleRate / analysis.fftSize);
+    const float topBandHz = juce::jmin(bandMaxHz, static_cast<float>(analysis.sampleRate * 0.5));
+
+    analysis.chromaBinForBin.assign(static_cast<size_t>(numBins), -1);
+    analysis.bandForBin.assign(static_cast<size_t>(numBins), -1);
+    for (int bin = 1; bin < numBins; ++bin)
+    {
+        const float hz = static_cast<float>(bin) * binHz;
+
+        if (hz >= chromaMinHz && hz <= chromaMaxHz)
+        {
+            const int midiNote = juce::roundToInt(12.0f * std::log2(hz / 440.0f) + 69.0f);
+            analysis.chromaBinForBin[static_cast<size_t>(bin)] = ((midiNote % numChromaBins) + numChromaBins) % numChromaBins;
+        }
+
+        if (hz >= bandMinHz && hz < topBandHz)
+        {
+            const int band = static_cast<int>(numBands * std::log(hz / bandMinHz) / std::log(topBandHz / bandMinHz));
+            analysis.bandForBin[static_cast<size_t>(bin)] = juce::jlimit(0, numBands - 1, band);
+        }
+    }
+
+    analysis.features.assign(static_cast<size_t>(analysis.numFrames) * numFeatures, 0.0f);
+
+    const int numTasks = workers.getNumThreads() * 4;
+    const int framesPerTask = (analysis.numFrames + numTasks - 1) / numTasks;
+    const float chromaWeight = std::sqrt(0.5f);
+    const float bandWeight = std::sqrt(0.5f);
+
+    parallelFor(numTasks, [&](int task)
+    {
+        const int firstFrame = task * framesPerTask;
+        const int endFrame = juce::jmin(analysis.numFrames, firstFrame + framesPerTask);
+        if (firstFrame >= endFrame)
+            return;
+
+        juce::dsp::FFT fft(analysis.fftOrder);
+        juce::dsp::WindowingFunction<float> window(static_cast<size_t>(analysis.fftSize),
+                                                   juce::dsp::WindowingFunction<float>::hann, false);
+        std::vector<float> scratch(static_cast<size_t>(analysis.fftSize) * 2);
+
+        for (int frame = firstFrame; frame < endFrame; ++frame)
+        {
+            if (shouldExit && (frame - firstFrame) % exitCheckInterval == 0 && shouldExit())
+                return;
+
+            const float* samples = analysis.mono.data() + static_cast<size_t>(frame) * static_cast<size_t>(analysis.hopSize);
+            float meanSquare = 0.0f;
+            for (int i = 0; i < analysis.fftSize; ++i)
+                meanSquare += samples[i] * samples[i];
+            meanSquare /= static_cast<float>(analysis.fftSize);
+
+            if (meanSquare < silenceMeanSquare)
+                continue;
+
+            std::copy(samples, samples + analysis.fftSize, scratch.begin());
+            std::fill(scratch.begin() + analysis.fftSize, scratch.end(), 0.0f);
+            window.multiplyWithWindowingTable(scratch.data(), static_cast<size_t>(analysis.fftSize));
+            fft.performFrequencyOnlyForwardTransform(scratch.data(), true);
+
+            float* chroma = analysis.features.data() + static_cast<size_t>(frame) * numFeatures;
+            float* bands = chroma + numChromaBins;
+
+            for (int bin = 1; bin < numBins; ++bin)
+            {
+                const float power = scratch[static_cast<size_t>(bin)] * scratch[static_cast<size_t>(bin)];
+                if (const int pitchClass = analysis.chromaBinForBin[static_cast<size_t>(bin)]; pitchClass >= 0)
+                    chroma[pitchClass] += power;
+                if (const int band = analysis.bandForBin[static_cast<size_t>(bin)]; band >= 0)
+                    bands[band] += power;
+            }
+
+            // Band envelope in dB relative to its own mean, so overall level doesn't matter
+            float meanLog = 0.0f;
+            for (int b = 0; b < numBands; ++b)
+            {
+                bands[b] = std::log(bands[b] + 1.0e-9f);
+                meanLog += bands[b];
+            }
+            meanLog /= static_cast<float>(numBands);
+            for (int b = 0; b < numBands; ++b)
+                bands[b] -= meanLog;
+
+            normalise(chroma, numChromaBins, chromaWeight);
+            normalise(bands, numBands, bandWeight);
+        }
+    });
+}
+
+std::vector<int> LoopFinder::pickLoopLengths(const Analysis& analysis, int minLag, int numLengths,
+                                             const std::function<bool()>& shouldExit)
+{
+    // Lags need enough overlap left for a full seam window either side
+    const int maxLag = analysis.numFrames - 2 * analysis.seamWindowFrames;
+    if (maxLag <= minLag)
+        return {};
+
+    // Summed autocorrelation of every feature dimension: R[lag] = sum over t of f[t] . f[t + lag]
+    const int order = getOrderForSize(analysis.numFrames * 2);
+    const int size = 1 << order;
+    const int numBins = size / 2 + 1;
+
+    const int numTasks = juce::jmin(numFeatures, workers.getNumThreads());
+    std::vector<std::vector<float>> partialPower(static_cast<size_t>(numTasks), std::vector<float>(static_cast<size_t>(numBins), 0.0f));
+
+    parallelFor(numTasks, [&](int task)
+    {
+        juce::dsp::FFT fft(order);
+        std::vector<float> scratch(static_cast<size_t>(size) * 2);
+        auto& power = partialPower[static_cast<size_t>(task)];
+
+        for (int feature = task; feature < numFeatures; feature += numTasks)
+        {
+            if (shouldExit && shouldExit())
+                return;
+
+            std::fill(scratch.begin(), scratch.end(), 0.0f);
+            for (int frame = 0; frame < analysis.numFrames; ++frame)
+                scratch[static_cast<size_t>(frame)] = analysis.getFeatures(frame)[feature];
+
+            fft.performRealOnlyForwardTransform(scratch.data(), true);
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                const float re = scratch[static_cast<size_t>(bin) * 2];
+                const float im = scratch[static_cast<size_t>(bin) * 2 + 1];
+                power[static_cast<size_t>(bin)] += re * re + im * im;
+            }
+        }
+    });
+
+    if (shouldExit && shouldExit())
+        return {};
+
+    std::vector<float> correlation(static_cast<size_t>(size) * 2, 0.0f);
+    for (const auto& power : partialPower)
+    {
+        for (int bin = 0; bin < numBins; ++bin)
+            correlation[static_cast<size_t>(bin) * 2] += power[static_cast<size_t>(bin)];
+    }
+
+    juce::dsp::FFT inverse(order);
+    inverse.performRealOnlyInverseTransform(correlation.data());
+
+    // Mean similarity per overlapping frame pair, so long lags aren't penalised for their short overlap
+    std::vector<float> meanSimilarity(static_cast<size_t>(maxLag + 2), 0.0f);
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+    {
+        if (lag > 0)
+            meanSimilarity[static_cast<size_t>(lag)] = correlation[static_cast<size_t>(lag)] / static_cast<float>(analysis.numFrames - lag);
+    }
+
+    std::vector<int> peaks;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        const float value = meanSimilarity[static_cast<size_t>(lag)];
+        if (value > 0.0f
+            && value >= meanSimilarity[static_cast<size_t>(lag - 1)]
+            && value > meanSimilarity[static_cast<size_t>(lag + 1)])
+            peaks.push_back(lag);
+    }
+
+    std::sort(peaks.begin(), peaks.end(), [&](int a, int b)
+    {
+        return meanSimilarity[static_cast<size_t>(a)] > meanSimilarity[static_cast<size_t>(b)];
+    });
+
+    if (peaks.size() > static_cast<size_t>(numLengths))
+        peaks.resize(static_cast<size_t>(numLengths));
+
+    return peaks;
+}
+
+LoopFinder::Candidate LoopFinder::findBestStart(const Analysis& analysis, int lag, int firstFrame) const
+{
+    // similarity[t] compares frame t with frame t + lag; a loop starting at t needs a run of
+    // high similarity both before t (what leads into the seam) and after it (what follows it)
+    const int length = analysis.numFrames - lag;
+    const int window = analysis.seamWindowFrames;
+
+    std::vector<double> runningSum(static_cast<size_t>(length) + 1, 0.0);
+    for (int t = 0; t < length; ++t)
+        runningSum[static_cast<size_t>(t) + 1] = runningSum[static_cast<size_t>(t)] + analysis.getSimilarity(t, t + lag);
+
+    Candidate best;
+    best.score = -1.0f;
+
+    for (int start = juce::jmax(firstFrame, 1); start < length; ++start)
+    {
+        const int from = juce::jmax(0, start - window);
+        const int to = juce::jmin(length, start + window);
+        if (to - from < window)
+            continue;
+
+        const auto score = static_cast<float>((runningSum[static_cast<size_t>(to)] - runningSum[static_cast<size_t>(from)]) / (to - from));
+        if (score > best.score)
+        {
+            best.score = score;
+            best.loopStart = analysis.getFrameCentre(start);
+            best.loopEnd = best.loopStart + static_cast<int64>(lag) * analysis.hopSize;
+        }
+    }
+
+    if (best.loopEnd > analysis.getNumSamples())
+        best.score = -1.0f;
+
+    return best;
+}
+
+LoopFinder::Candidate LoopFinder::refine(const Analysis& analysis, const Candidate& coarse) const
+{
+    const int64 numSamples = analysis.getNumSamples();
+    const int length = juce::jmin(static_cast<int>(refineSeconds * analysis.sampleRate), static_cast<int>(numSamples / 4));
+    const int64 loopLength = coarse.loopEnd - coarse.loopStart;
+    if (length <= 0 || loopLength <= 0)
+        return coarse;
+
+    // Reference: the audio just after the loop start. Search: the same span one loop later,
+    // shifted by up to a hop either way, which covers the frame grid's uncertainty
+    const int64 referenceStart = juce::jlimit<int64>(0, numSamples - length, coarse.loopStart);
+    const int64 minShift = juce::jmax<int64>(-analysis.hopSize, -(referenceStart + loopLength));
+    const int64 maxShift = juce::jmin<int64>(analysis.hopSize, numSamples - length - (referenceStart + loopLength));
+    if (maxShift < minShift)
+        return coarse;
+
+    const float* reference = analysis.mono.data() + referenceStart;
+    const float* search = analysis.mono.data() + referenceStart + loopLength + minShift;
+    const int searchLength = length + static_cast<int>(maxShift - minShift);
+
+    // Cross-correlate through the FFT: X = conj(FFT(reference)) * FFT(search)
+    const int order = getOrderForSize(length + searchLength);
+    const int size = 1 << order;
+    juce::dsp::FFT fft(order);
+
+    std::vector<float> referenceSpectrum(static_cast<size_t>(size) * 2, 0.0f);
+    std::vector<float> searchSpectrum(static_cast<size_t>(size) * 2, 0.0f);
+    std::copy(reference, reference + length, referenceSpectrum.begin());
+    std::copy(search, search + searchLength, searchSpectrum.begin());
+    fft.performRealOnlyForwardTransform(referenceSpectrum.data(), true);
+    fft.performRealOnlyForwardTransform(searchSpectrum.data(), true);
+
+    for (int bin = 0; bin <= size / 2; ++bin)
+    {
+        const float ar = referenceSpectrum[static_cast<size_t>(bin) * 2];
+        const float ai = referenceSpectrum[static_cast<size_t>(bin) * 2 + 1];
+        const float br = searchSpectrum[static_cast<size_t>(bin) * 2];
+        const float bi = searchSpectrum[static_cast<size_t>(bin) * 2 + 1];
+        searchSpectrum[static_cast<size_t>(bin) * 2] = ar * br + ai * bi;
+        searchSpectrum[static_cast<size_t>(bin) * 2 + 1] = ar * bi - ai * br;
+    }
+    fft.performRealOnlyInverseTransform(searchSpectrum.data());
+
+    // Normalise by the energy under each shifted window; the FFT's own scaling cancels in the comparison
+    double windowEnergy = 0.0;
+    for (int i = 0; i < length; ++i)
+        windowEnergy += static_cast<double>(search[i]) * search[i];
+
+    int bestOffset = -1;
+    double bestValue = 0.0;
+    for (int offset = 0; offset <= searchLength - length; ++offset)
+    {
+        if (offset > 0)
+        {
+            windowEnergy -= static_cast<double>(search[offset - 1]) * search[offset - 1];
+            windowEnergy += static_cast<double>(search[offset + length - 1]) * search[offset + length - 1];
+        }
+
+        if (windowEnergy <= 1.0e-12)
+            continue;
+
+        const double value = searchSpectrum[static_cast<size_t>(offset)] / std::sqrt(windowEnergy);
+        if (bestOffset < 0 || value > bestValue)
+        {
+            bestOffset = offset;
+            bestValue = value;
+        }
+    }
+
+    if (bestOffset < 0)
+        return coarse;
+
+    // Exact normalised correlation at the chosen shift
+    double dot = 0.0, referenceEnergy = 0.0, candidateEnergy = 0.0;
+    for (int i = 0; i < length; ++i)
+    {
+        const double a = reference[i];
+        const double b = search[bestOffset + i];
+        dot += a * b;
+        referenceEnergy += a * a;
+        candidateEnergy += b * b;
+    }
+
+    const double denominator = std::sqrt(referenceEnergy * candidateEnergy);
+    const float correlation = denominator > 0.0 ? static_cast<float>(dot / denominator) : 0.0f;
+
+    Candidate result;
+    result.loopStart = referenceStart;
+    result.loopEnd = juce::jlimit<int64>(result.loopStart + 1, numSamples, referenceStart + loopLength + minShift + bestOffset);
+    result.score = 0.5f * juce::jlimit(0.0f, 1.0f, coarse.score) + 0.5f * juce::jmax(0.0f, correlation);
+    return result;
+}
+
+//==============================================================================
+void LoopFinder::parallelFor(int numTasks, const std::function<void(int)>& task)
+{
+    if (numTasks <= 0)
+        return;
+
+    std::atomic<int> remaining { numTasks };
+    juce::WaitableEvent finished;
+
+    for (int i = 0; i < numTasks; ++i)
+    {
+        workers.addJob([&task, &remaining, &finished, i]
+        {
+            task(i);
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+ * Searches a track for seamless loop points.
+ *
+ * The mono mixdown is cut into overlapping FFT frames, each summarised by a
+ * chroma vector (harmony) and a log band-energy envelope (timbre). The
+ * autocorrelation of that feature sequence, computed with FFTs, scores every
+ * loop length at once; the strongest lengths are then scanned for the start
+ * whose surrounding frames best match the frames one loop later. Finally each
+ * candidate's length is refined to sample accuracy by cross-correlating the
+ * raw audio around the start with the audio around the end.
+ *
+ * Work is spread over a private worker pool; one LoopFinder runs one search
+ * at a time.
+ */
+class LoopFinder
+{
+public:
+    //==============================================================================
+    struct Candidate
+    {
+        int64 loopStart = 0;
+        int64 loopEnd = 0;     // exclusive, as in MSUProjectState
+        float score = 0.0f;    // 0..1, higher is more seamless
+    };
+
+    struct Settings
+    {
+        int64 searchStart = 0;          // earliest allowed loop start, e.g. the trim point
+        double minLoopSeconds = 8.0;
+        int maxCandidates = 8;
+    };
+
+    //==============================================================================
+    LoopFinder();
+
+    /**
+     * Find loop candidates in a buffer.
+     * @param buffer Source audio
+     * @param sampleRate Sample rate of the source audio
+     * @param settings Search limits
+     * @param shouldExit Polled throughout; returning true abandons the search
+     * @return candidates ordered best first, empty if none were found or the search was abandoned
+     */
+    std::vector<Candidate> findLoops(const juce::AudioBuffer<float>& buffer,
+                                     double sampleRate,
+                                     const Settings& settings,
+                                     const std::function<bool()>& shouldExit = {});
+
+private:
+    //==============================================================================
+    static constexpr int numChromaBins = 12;
+    static constexpr int numBands = 16;
+    static constexpr int numFeatures = numChromaBins + numBands;
+    static constexpr int maxWorkers = 8;
+
+    juce::ThreadPool workers;
+
+    struct Analysis;
+
+    void extractFeatures(Analysis& analysis, const std::function<bool()>& shouldExit);
+    std::vector<int> pickLoopLengths(const Analysis& analysis, int minLag, int numLengths,
+                                     const std::function<bool()>& shouldExit);
+    Candidate findBestStart(const Analysis& analysis, int lag, int firstFrame) const;
+    Candidate refine(const Analysis& analysis, const Candidate& coarse) const;
+
+    /** Run task(0) .. task(numTasks - 1) on the worker pool and wait for all of them. */
+    void parallelFor(int numTasks, const std::function<void(int)>& task);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopFinder)
+};
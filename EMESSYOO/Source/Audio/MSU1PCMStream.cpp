@@ -0,0 +1,188 @@
+#include "MSU1PCMStream.h"
+
+//==============================================================================
+MSU1PCMStream::MSU1PCMStream()
+{
+    rawBlock.malloc(static_cast<size_t>(readChunkFrames * bytesPerFrame));
+    ring.clear();
+}
+
+MSU1PCMStream::~MSU1PCMStream() = default;
+
+//==============================================================================
+bool MSU1PCMStream::open(const juce::File& file, int framesToPrime, int64 startFrame)
+{
+    input = std::make_unique<juce::FileInputStream>(file);
+
+    if (!input->openedOk())
+    {
+        setError("Could not open PCM file: " + file.getFullPathName());
+        input.reset();
+        return false;
+    }
+
+    juce::String headerError;
+    if (!readHeader(*input, totalSamples, loopPoint, headerError))
+    {
+        setError(headerError);
+        input.reset();
+        return false;
+    }
+
+    // A start frame at or past the end simply wraps to the loop point on the first fill
+    nextFileFrame = juce::jlimit(static_cast<int64>(0), totalSamples, startFrame);
+    if (nextFileFrame > 0 && nextFileFrame < totalSamples
+        && !input->setPosition(headerSize + nextFileFrame * bytesPerFrame))
+    {
+        setError("Could not seek in PCM file: " + file.getFullPathName());
+        input.reset();
+        return false;
+    }
+
+    fifo.reset();
+    readFailed = false;
+
+    const int target = juce::jmin(framesToPrime, ringBufferFrames - 1);
+    while (fifo.getNumReady() < target)
+    {
+        if (fillFromDisk(target - fifo.getNumReady()) <= 0)
+            break;
+    }
+
+    if (target > 0 && fifo.getNumReady() == 0)
+    {
+        setError("Failed to read audio data from PCM file");
+        input.reset();
+        return false;
+    }
+
+    lastError.clear();
+    return true;
+}
+
+int MSU1PCMStream::read(float* left, float* right, int numFrames)
+{
+    const auto scope = fifo.read(numFrames);
+
+    if (scope.blockSize1 > 0)
+    {
+        juce::FloatVectorOperations::copy(left, ring.getReadPointer(0, scope.startIndex1), scope.blockSize1);
+        juce::FloatVectorOperations::copy(right, ring.getReadPointer(1, scope.startIndex1), scope.blockSize1);
+    }
+
+    if (scope.blockSize2 > 0)
+    {
+        juce::FloatVectorOperations::copy(left + scope.blockSize1, ring.getReadPointer(0, scope.startIndex2), scope.blockSize2);
+        juce::FloatVectorOperations::copy(right + scope.blockSize1, ring.getReadPointer(1, scope.startIndex2), scope.blockSize2);
+    }
+
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+int64 MSU1PCMStream::getFilePositionForFramesConsumed(int64 framesConsumed) const
+{
+    if (totalSamples <= 0 || framesConsumed <= 0)
+        return 0;
+
+    if (framesConsumed < totalSamples)
+        return framesConsumed;
+
+    const int64 loopLength = totalSamples - loopPoint;
+    return loopPoint + (framesConsumed - totalSamples) % loopLength;
+}
+
+//==============================================================================
+int MSU1PCMStream::useTimeSlice()
+{
+    if (input == nullptr || readFailed)
+        return 100;
+
+    // Keep reading back-to-back while there is room, then back off briefly
+    const int framesRead = fillFromDisk(readChunkFrames);
+    return framesRead > 0 ? 0 : 10;
+}
+
+int MSU1PCMStream::fillFromDisk(int maxFrames)
+{
+    int framesToRead = juce::jmin(maxFrames, readChunkFrames, fifo.getFreeSpace());
+    if (framesToRead <= 0 || input == nullptr)
+        return 0;
+
+    if (nextFileFrame >= totalSamples)
+    {
+        // Wrap to the header loop point, exactly like MSU-1 hardware does on repeat
+        if (!input->setPosition(headerSize + loopPoint * bytesPerFrame))
+        {
+            readFailed = true;
+            return 0;
+        }
+        nextFileFrame = loopPoint;
+    }
+
+    framesToRead = static_cast<int>(juce::jmin(static_cast<int64>(framesToRead), totalSamples - nextFileFrame));
+
+    const int bytesRead = input->read(rawBlock.getData(), framesToRead * bytesPerFrame);
+    const int framesRead = juce::jmax(0, bytesRead) / bytesPerFrame;
+    if (framesRead <= 0)
+    {
+        readFailed = true;
+        return 0;
+    }
+
+    const auto scope = fifo.write(framesRead);
+    if (scope.blockSize1 > 0)
+        decodeFrames(rawBlock.getData(), ring.getWritePointer(0, scope.startIndex1),
+                     ring.getWritePointer(1, scope.startIndex1), scope.blockSize1);
+    if (scope.blockSize2 > 0)
+        decodeFrames(rawBlock.getData() + scope.blockSize1 * bytesPerFrame, ring.getWritePointer(0, scope.startIndex2),
+                     ring.getWritePointer(1, scope.startIndex2), scope.blockSize2);
+
+    nextFileFrame += framesRead;
+    return framesRead;
+}
+
+//==============================================================================
+bool MSU1PCMStream::readHeader(juce::InputStream& input, int64& totalSamples, int64& loopPoint, juce::String& error)
+{
+    char header[headerSize];
+    if (input.read(header, static_cast<int>(headerSize)) != static_cast<int>(headerSize))
+    {
+        error = "Could not read PCM file header";
+        return false;
+    }
+
+    if (std::memcmp(header, "MSU1", 4) != 0)
+    {
+        error = "Invalid MSU-1 PCM file: missing MSU1 header";
+        return false;
+    }
+
+    totalSamples = (input.getTotalLength() - headerSize) / bytesPerFrame;
+    if (totalSamples <= 0)
+    {
+        error = "PCM file contains no audio data";
+        return false;
+    }
+
+    loopPoint = static_cast<int64>(juce::ByteOrder::littleEndianInt(header + 4));
+    if (loopPoint >= totalSamples)
+        loopPoint = 0;
+
+    return true;
+}
+
+void MSU1PCMStream::decodeFrames(const char* source, float* left, float* right, int numFrames)
+{
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const auto* frame = source + i * bytesPerFrame;
+        left[i] = static_cast<int16_t>(juce::ByteOrder::littleEndianShort(frame)) / 32768.0f;
+        right[i] = static_cast<int16_t>(juce::ByteOrder::littleEndianShort(frame + 2)) / 32768.0f;
+    }
+}
+
+void MSU1PCMStream::setError(const juce::String& error)
+{
+    lastError = error;
+    DBG("MSU1PCMStream Error: " + error);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * Streams an MSU-1 .pcm file from disk into a small lock-free ring buffer.
+ *
+ * A TimeSliceThread keeps the ring topped up while the audio thread pops
+ * de-interleaved frames with read(). When the end of the file is reached the
+ * reader seeks back to the loop point stored in the MSU1 header, so the ring
+ * always contains a seamless continuation of the track.
+ */
+class MSU1PCMStream : public juce::TimeSliceClient
+{
+public:
+    //==============================================================================
+    MSU1PCMStream();
+    ~MSU1PCMStream() override;
+
+    //==============================================================================
+    /**
+     * Open a .pcm file, validate its MSU1 header and synchronously buffer
+     * the first frames so playback can start immediately.
+     * Must be called before the stream is attached to a TimeSliceThread.
+     * @param file The MSU-1 PCM file
+     * @param framesToPrime Number of frames to read before returning (0 leaves it to the read-ahead thread)
+     * @param startFrame First frame to stream, e.g. the end of an already-cached head
+     * @return true if the header was valid and, when priming was requested, audio was buffered
+     */
+    bool open(const juce::File& file, int framesToPrime, int64 startFrame = 0);
+
+    /**
+     * Pop up to numFrames frames from the ring buffer. Safe to call from the
+     * audio thread; never blocks or touches the disk.
+     * @return the number of frames actually written to left/right
+     */
+    int read(float* left, float* right, int numFrames);
+
+    /** Number of frames currently buffered and ready for read(). */
+    int getNumReady() const { return fifo.getNumReady(); }
+
+    /** Total number of stereo frames in the file (excluding the header). */
+    int64 getTotalSamples() const { return totalSamples; }
+
+    /** Loop point from the MSU1 header, clamped to the file length. */
+    int64 getLoopPoint() const { return loopPoint; }
+
+    /** Map a count of consumed frames to a position inside the file, following the loop. */
+    int64 getFilePositionForFramesConsumed(int64 framesConsumed) const;
+
+    /** Get the last error message. */
+    juce::String getLastError() const { return lastError; }
+
+    //==============================================================================
+    /**
+     * Read and validate the 8-byte MSU1 header from the start of a stream.
+     * @param input Stream positioned at the start of the file
+     * @param totalSamples Receives the number of stereo frames after the header
+     * @param loopPoint Receives the header loop point, clamped to the file length
+     * @param error Receives a description if the header is invalid
+     * @return true if the header is valid and the file contains audio
+     */
+    static bool readHeader(juce::InputStream& input, int64& totalSamples, int64& loopPoint, juce::String& error);
+
+    /** Convert interleaved 16-bit little-endian stereo frames to two float channels. */
+    static void decodeFrames(const char* source, float* left, float* right, int numFrames);
+
+    //==============================================================================
+    int useTimeSlice() override;
+
+    //==============================================================================
+    static constexpr int ringBufferFrames = 32768;   // ~0.75 s, 256 KB of float stereo
+    static constexpr int readChunkFrames = 4096;
+    static constexpr int64 headerSize = 8;
+    static constexpr int bytesPerFrame = 4;
+
+private:
+    //==============================================================================
+    std::unique_ptr<juce::FileInputStream> input;
+    juce::AbstractFifo fifo { ringBufferFrames };
+    juce::AudioBuffer<float> ring { 2, ringBufferFrames };
+    juce::HeapBlock<char> rawBlock;
+
+    int64 totalSamples = 0;
+    int64 loopPoint = 0;
+    int64 nextFileFrame = 0;
+    std::atomic<bool> readFailed { false };
+    juce::String lastError;
+
+    int fillFromDisk(int maxFrames);
+    void setError(const juce::String& error);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MSU1PCMStream)
+};
@@ -1,4 +1,15 @@
 #include "NormalizationAnalyzer.h"
+#include "TruePeakDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double loudnessBlockSeconds = 0.1;
+    constexpr int shortTermBlocks = 30;                       // 3 s short-term loudness window
+    constexpr double loudnessRangeAbsoluteGateDb = -70.0;
+    constexpr double loudnessRangeRelativeGateDb = -20.0;
+}
 
 //==============================================================================
 NormalizationAnalyzer::NormalizationAnalyzer()
@@ -10,46 +21,160 @@ NormalizationAnalyzer::~NormalizationAnalyzer()
 }
 
 //==============================================================================
-NormalizationAnalyzer::AudioStats NormalizationAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& buffer)
+NormalizationAnalyzer::AudioStats NormalizationAnalyzer::analyzeBuffer(const juce::AudioBuffer<float>& buffer,
+                                                                       double sampleRate)
 {
     AudioStats stats;
     
-    if (buffer.getNumSamples() == 0)
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || numChannels == 0)
         return stats;
     
-    // Calculate peak
+    // Walk the audio once in detector-sized blocks, closing a loudness block every 100 ms
+    const int loudnessBlockSize = juce::jmax(1, juce::roundToInt(sampleRate * loudnessBlockSeconds));
+    TruePeakDetector detector(numChannels);
+    std::vector<float> truePeaks(TruePeakDetector::maxBlockSize);
+    std::vector<double> blockPowers;
+    blockPowers.reserve(static_cast<size_t>(numSamples / loudnessBlockSize) + 1);
+    
     float maxPeak = 0.0f;
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    float maxTruePeak = 0.0f;
+    double sumSquares = 0.0;
+    double blockSquares = 0.0;
+    int blockFill = 0;
+    
+    for (int start = 0; start < numSamples;)
     {
-        float channelPeak = buffer.getMagnitude(channel, 0, buffer.getNumSamples());
-        maxPeak = juce::jmax(maxPeak, channelPeak);
+        const int length = juce::jmin(numSamples - start,
+                                      TruePeakDetector::maxBlockSize,
+                                      loudnessBlockSize - blockFill);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            maxPeak = juce::jmax(maxPeak, buffer.getMagnitude(channel, start, length));
+            const double rms = buffer.getRMSLevel(channel, start, length);
+            blockSquares += rms * rms * length;
+        }
+        
+        detector.process(buffer, start, length, truePeaks.data());
+        maxTruePeak = juce::jmax(maxTruePeak, juce::FloatVectorOperations::findMaximum(truePeaks.data(), length));
+        
+        start += length;
+        blockFill += length;
+        if (blockFill == loudnessBlockSize)
+        {
+            blockPowers.push_back(blockSquares / (static_cast<double>(blockFill) * numChannels));
+            sumSquares += blockSquares;
+            blockSquares = 0.0;
+            blockFill = 0;
+        }
     }
     
+    sumSquares += blockSquares;
+    if (blockPowers.empty())
+        blockPowers.push_back(blockSquares / (static_cast<double>(blockFill) * numChannels));
+    
     stats.peakLinear = maxPeak;
     stats.peakDb = juce::Decibels::gainToDecibels(maxPeak, -96.0f);
     
-    // Calculate RMS
-    float sumSquares = 0.0f;
-    int totalSamples = 0;
+    // The detector's last few estimates are still in flight; those samples' own peak bounds them
+    stats.truePeakLinear = juce::jmax(maxTruePeak, maxPeak);
+    stats.truePeakDb = juce::Decibels::gainToDecibels(stats.truePeakLinear, -96.0f);
     
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    const float rms = static_cast<float>(std::sqrt(sumSquares / (static_cast<double>(numSamples) * numChannels)));
+    stats.rmsLinear = rms;
+    stats.rmsDb = juce::Decibels::gainToDecibels(rms, -96.0f);
+    
+    stats.loudnessRangeDb = calculateLoudnessRange(blockPowers);
+    stats.loudnessMeasured = true;
+    
+    return stats;
+}
+
+NormalizationAnalyzer::AudioStats NormalizationAnalyzer::analyzeLevels(const juce::AudioBuffer<float>& buffer)
+{
+    AudioStats stats;
+    
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || numChannels == 0)
+        return stats;
+    
+    float maxPeak = 0.0f;
+    double sumSquares = 0.0;
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        const float* data = buffer.getReadPointer(channel);
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            sumSquares += data[sample] * data[sample];
-            totalSamples++;
-        }
+        maxPeak = juce::jmax(maxPeak, buffer.getMagnitude(channel, 0, numSamples));
+        const double rms = buffer.getRMSLevel(channel, 0, numSamples);
+        sumSquares += rms * rms * numSamples;
     }
     
-    float rms = std::sqrt(sumSquares / totalSamples);
+    stats.peakLinear = maxPeak;
+    stats.peakDb = juce::Decibels::gainToDecibels(maxPeak, -96.0f);
+    
+    const float rms = static_cast<float>(std::sqrt(sumSquares / (static_cast<double>(numSamples) * numChannels)));
     stats.rmsLinear = rms;
     stats.rmsDb = juce::Decibels::gainToDecibels(rms, -96.0f);
     
     return stats;
 }
 
+float NormalizationAnalyzer::calculateLoudnessRange(const std::vector<double>& blockPowers)
+{
+    // Short-term loudness over 3 s windows, stepped by one block
+    const size_t window = juce::jmin(blockPowers.size(), static_cast<size_t>(shortTermBlocks));
+    std::vector<double> shortTerm;
+    shortTerm.reserve(blockPowers.size() - window + 1);
+    
+    double windowSum = 0.0;
+    for (size_t i = 0; i < blockPowers.size(); ++i)
+    {
+        windowSum += blockPowers[i];
+        if (i >= window)
+            windowSum -= blockPowers[i - window];
+        if (i + 1 >= window)
+            shortTerm.push_back(juce::jmax(0.0, windowSum) / static_cast<double>(window));
+    }
+    
+    // Gate out silence, then anything far below the programme's own level
+    const double absoluteGate = std::pow(10.0, loudnessRangeAbsoluteGateDb / 10.0);
+    double gatedSum = 0.0;
+    int gatedCount = 0;
+    for (double power : shortTerm)
+    {
+        if (power > absoluteGate)
+        {
+            gatedSum += power;
+            ++gatedCount;
+        }
+    }
+    
+    if (gatedCount == 0)
+        return 0.0f;
+    
+    const double relativeGate = gatedSum / gatedCount * std::pow(10.0, loudnessRangeRelativeGateDb / 10.0);
+    std::vector<float> levels;
+    levels.reserve(static_cast<size_t>(gatedCount));
+    for (double power : shortTerm)
+    {
+        if (power > absoluteGate && power > relativeGate)
+            levels.push_back(static_cast<float>(10.0 * std::log10(power)));
+    }
+    
+    if (levels.size() < 2)
+        return 0.0f;
+    
+    std::sort(levels.begin(), levels.end());
+    auto percentile = [&levels](double fraction)
+    {
+        const auto index = static_cast<size_t>(std::round(fraction * static_cast<double>(levels.size() - 1)));
+        return levels[index];
+    };
+    
+    return percentile(0.95) - percentile(0.10);
+}
+
 bool NormalizationAnalyzer::analyzeDirectory(const juce::File& directory,
                                              std::map<juce::File, AudioStats>& stats)
 {
@@ -88,7 +213,7 @@ bool NormalizationAnalyzer::analyzeDirectory(const juce::File& directory,
             
             if (reader->read(&buffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true))
             {
-                stats[file] = analyzeBuffer(buffer);
+                stats[file] = analyzeLevels(buffer);
             }
         }
     }
@@ -136,7 +261,7 @@ void NormalizationAnalyzer::normalizeToRMS(juce::AudioBuffer<float>& buffer,
                                           bool limitPeak)
 {
     // Analyze current buffer
-    AudioStats stats = analyzeBuffer(buffer);
+    AudioStats stats = analyzeLevels(buffer);
     
     // Calculate required gain
     float gainDb = calculateGainToTarget(stats.rmsDb, targetRmsDb);
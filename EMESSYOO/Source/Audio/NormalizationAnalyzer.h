@@ -1,11 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <vector>
 
 //==============================================================================
 /**
  * Analyzes audio for normalization purposes.
- * Calculates RMS, peak levels, and applies gain adjustments.
+ * Calculates RMS, sample and true peak levels and loudness range, and applies
+ * gain adjustments.
  */
 class NormalizationAnalyzer
 {
@@ -17,6 +19,10 @@ public:
         float rmsDb = -96.0f;
         float peakLinear = 0.0f;
         float rmsLinear = 0.0f;
+        float truePeakDb = -96.0f;         // inter-sample peak, dBTP
+        float truePeakLinear = 0.0f;
+        float loudnessRangeDb = 0.0f;      // spread of short-term loudness, 10th to 95th percentile
+        bool loudnessMeasured = false;     // true peak and loudness range are only set by analyzeBuffer()
     };
     
     //==============================================================================
@@ -25,11 +31,19 @@ public:
     
     //==============================================================================
     /**
-     * Analyze an audio buffer and return statistics.
+     * Analyze an audio buffer and return statistics, in one pass over the audio.
+     * Includes the 4x oversampled true peak and the loudness range.
      * @param buffer The buffer to analyze
+     * @param sampleRate Rate of the buffer, which sets the loudness range windows
      * @return Statistics structure
      */
-    static AudioStats analyzeBuffer(const juce::AudioBuffer<float>& buffer);
+    static AudioStats analyzeBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    /**
+     * Sample peak and RMS only, for callers that need nothing more; much
+     * cheaper than analyzeBuffer(). The result has loudnessMeasured unset.
+     */
+    static AudioStats analyzeLevels(const juce::AudioBuffer<float>& buffer);
     
     /**
      * Analyze all PCM files in a directory.
@@ -81,6 +95,9 @@ private:
     //==============================================================================
     juce::String lastError;
     
+    /** Loudness range from the mean-square power of consecutive 100 ms blocks. */
+    static float calculateLoudnessRange(const std::vector<double>& blockPowers);
+    
     void setError(const juce::String& error);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NormalizationAnalyzer)
@@ -0,0 +1,71 @@
+#include "PackLoudnessSolver.h"
+
+namespace
+{
+    constexpr float silenceThresholdDb = -70.0f;
+    constexpr float fullBudgetRangeDb = 12.0f;    // loudness range up to which a track gets the whole budget
+    constexpr float halfBudgetRangeDb = 20.0f;    // and from which it gets half
+}
+
+//==============================================================================
+PackLoudnessSolver::Solution PackLoudnessSolver::solve(const std::vector<Track>& tracks, const Settings& settings)
+{
+    Solution solution;
+    solution.tracks.resize(tracks.size());
+
+    // The loudest each track can get before its peak exceeds what the ceiling and its budget allow
+    float packLimitDb = std::numeric_limits<float>::infinity();
+    std::vector<float> maxGains(tracks.size(), 0.0f);
+
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        const auto& track = tracks[i];
+        if (track.loudnessDb <= silenceThresholdDb)
+            continue;
+
+        solution.tracks[i].included = true;
+        maxGains[i] = settings.ceilingDb + getLimitingBudget(track, settings) - track.truePeakDb;
+
+        const float limitDb = track.loudnessDb + maxGains[i];
+        if (limitDb < packLimitDb)
+        {
+            packLimitDb = limitDb;
+            solution.constrainingTrack = static_cast<int>(i);
+        }
+    }
+
+    if (solution.constrainingTrack < 0)
+        return solution;
+
+    // Spread is however far the target sits above the most constrained track
+    solution.targetLoudnessDb = juce::jmin(settings.preferredLoudnessDb, packLimitDb + settings.spreadToleranceDb);
+
+    float loudest = -std::numeric_limits<float>::infinity();
+    float quietest = std::numeric_limits<float>::infinity();
+
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto& result = solution.tracks[i];
+        if (!result.included)
+            continue;
+
+        const auto& track = tracks[i];
+        const float wantedGain = solution.targetLoudnessDb - track.loudnessDb;
+        result.gainDb = juce::jmin(wantedGain, maxGains[i]);
+        result.constrained = result.gainDb < wantedGain;
+        result.limitingDb = juce::jmax(0.0f, track.truePeakDb + result.gainDb - settings.ceilingDb);
+        result.loudnessDb = track.loudnessDb + result.gainDb;
+
+        loudest = juce::jmax(loudest, result.loudnessDb);
+        quietest = juce::jmin(quietest, result.loudnessDb);
+    }
+
+    solution.spreadDb = loudest - quietest;
+    return solution;
+}
+
+float PackLoudnessSolver::getLimitingBudget(const Track& track, const Settings& settings)
+{
+    const float range = juce::jlimit(fullBudgetRangeDb, halfBudgetRangeDb, track.loudnessRangeDb);
+    return settings.limitingBudgetDb * juce::jmap(range, fullBudgetRangeDb, halfBudgetRangeDb, 1.0f, 0.5f);
+}
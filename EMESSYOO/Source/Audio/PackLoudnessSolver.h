@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <limits>
+#include <vector>
+
+//==============================================================================
+/**
+ * Chooses one gain per track so a whole pack plays back at matching loudness.
+ *
+ * Every track is raised or lowered toward a shared target, but no further
+ * than its true peak allows: up to the ceiling, plus whatever limiting budget
+ * the track is given when the export limiter is on. Tracks with a wide
+ * loudness range get less of the budget, since limiting their transients is
+ * easier to hear.
+ *
+ * The track with the least room sets how loud the pack can be. The target is
+ * the preferred loudness, lowered until every track can reach within the
+ * spread tolerance of it, so the quietest result is never more than the
+ * tolerance below the loudest.
+ */
+class PackLoudnessSolver
+{
+public:
+    //==============================================================================
+    struct Track
+    {
+        float loudnessDb = -96.0f;        // RMS, as NormalizationAnalyzer measures it
+        float truePeakDb = -96.0f;
+        float loudnessRangeDb = 0.0f;
+    };
+
+    struct Settings
+    {
+        float preferredLoudnessDb = std::numeric_limits<float>::infinity();   // as loud as the ceiling allows
+        float ceilingDb = -1.0f;          // dBTP
+        float limitingBudgetDb = 0.0f;    // most gain reduction the limiter may apply to any track
+        float spreadToleranceDb = 0.5f;
+    };
+
+    struct TrackGain
+    {
+        bool included = false;            // false for silent tracks, which are left alone
+        float gainDb = 0.0f;
+        float limitingDb = 0.0f;          // how far the true peak ends up above the ceiling
+        float loudnessDb = -96.0f;        // after the gain
+        bool constrained = false;         // held below the target by its peak
+    };
+
+    struct Solution
+    {
+        float targetLoudnessDb = std::numeric_limits<float>::quiet_NaN();
+        float spreadDb = 0.0f;            // loudest minus quietest result
+        int constrainingTrack = -1;       // the track with the least room, which set the target
+        std::vector<TrackGain> tracks;    // in input order
+    };
+
+    static Solution solve(const std::vector<Track>& tracks, const Settings& settings);
+
+    /** The limiting budget a track gets, scaled down for wide loudness ranges. */
+    static float getLimitingBudget(const Track& track, const Settings& settings);
+};
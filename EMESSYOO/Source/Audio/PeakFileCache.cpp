@@ -0,0 +1,165 @@
+#include "PeakFileCache.h"
+
+namespace
+{
+    constexpr int64 edgeBytes = 64 * 1024;
+    constexpr int64 chunkBytes = 4096;
+    constexpr int numInteriorChunks = 16;
+
+    // Bump when decoding changes in a way DecodeSettings doesn't capture
+    constexpr uint32 decoderRevision = 1;
+
+    constexpr uint64 fnvOffsetBasis = 14695981039346656037ull;
+    constexpr uint64 fnvPrime = 1099511628211ull;
+
+    void hashBytes(uint64& hash, const void* data, size_t numBytes)
+    {
+        const auto* bytes = static_cast<const uint8*>(data);
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+    }
+
+    bool hashFileRange(uint64& hash, juce::FileInputStream& stream, int64 position, int64 numBytes)
+    {
+        juce::HeapBlock<char> block(static_cast<size_t>(numBytes));
+        if (!stream.setPosition(position))
+            return false;
+
+        const int bytesRead = stream.read(block.get(), static_cast<int>(numBytes));
+        if (bytesRead != static_cast<int>(numBytes))
+            return false;
+
+        hashBytes(hash, block.get(), static_cast<size_t>(bytesRead));
+        return true;
+    }
+
+    // Entries are written from worker threads; keep pruning from racing itself
+    juce::CriticalSection& getCacheLock()
+    {
+        static juce::CriticalSection lock;
+        return lock;
+    }
+}
+
+//==============================================================================
+uint64 PeakFileCache::computeKey(const juce::File& audioFile, const DecodeSettings& decode)
+{
+    juce::FileInputStream stream(audioFile);
+    if (!stream.openedOk())
+        return 0;
+
+    const int64 fileSize = stream.getTotalLength();
+    const int64 modified = audioFile.getLastModificationTime().toMilliseconds();
+
+    uint64 hash = fnvOffsetBasis;
+    const auto path = audioFile.getFullPathName().toStdString();
+    hashBytes(hash, path.data(), path.size());
+    hashBytes(hash, &fileSize, sizeof(fileSize));
+    hashBytes(hash, &modified, sizeof(modified));
+    hashBytes(hash, &decoderRevision, sizeof(decoderRevision));
+    hashBytes(hash, &decode.sampleRate, sizeof(decode.sampleRate));
+    hashBytes(hash, &decode.numChannels, sizeof(decode.numChannels));
+    hashBytes(hash, &decode.numSamples, sizeof(decode.numSamples));
+
+    const int64 headBytes = juce::jmin(edgeBytes, fileSize);
+    if (!hashFileRange(hash, stream, 0, headBytes))
+        return 0;
+
+    if (fileSize > edgeBytes * 2)
+    {
+        const int64 interior = fileSize - edgeBytes * 2 - chunkBytes;
+        for (int i = 0; i < numInteriorChunks && interior > 0; ++i)
+        {
+            const int64 position = edgeBytes + interior * (i + 1) / (numInteriorChunks + 1);
+            if (!hashFileRange(hash, stream, position, chunkBytes))
+                return 0;
+        }
+    }
+
+    if (fileSize > edgeBytes)
+    {
+        const int64 tailBytes = juce::jmin(edgeBytes, fileSize - edgeBytes);
+        if (!hashFileRange(hash, stream, fileSize - tailBytes, tailBytes))
+            return 0;
+    }
+
+    // 0 means "no key"
+    return hash != 0 ? hash : 1;
+}
+
+PeakPyramid::Ptr PeakFileCache::load(uint64 key, uint32 version)
+{
+    if (key == 0)
+        return nullptr;
+
+    const juce::ScopedLock sl(getCacheLock());
+    auto entryFile = getEntryFile(key);
+    auto pyramid = PeakPyramid::mapFromFile(entryFile, key, version);
+
+    // Recently used entries are the last to be pruned
+    if (pyramid != nullptr)
+        entryFile.setLastModificationTime(juce::Time::getCurrentTime());
+
+    return pyramid;
+}
+
+void PeakFileCache::store(uint64 key, const PeakPyramid& pyramid)
+{
+    if (key == 0)
+        return;
+
+    const juce::ScopedLock sl(getCacheLock());
+    if (!pyramid.writeToFile(getEntryFile(key), key))
+    {
+        DBG("PeakFileCache: could not write " + getEntryFile(key).getFullPathName());
+        return;
+    }
+
+    prune();
+}
+
+juce::File PeakFileCache::getCacheDirectory()
+{
+   #if JUCE_MAC
+    auto base = juce::File::getSpecialLocation(juce::File::userHomeDirectory).getChildFile("Library/Caches");
+   #else
+    auto base = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+   #endif
+    return base.getChildFile("MSU1PrepStudio").getChildFile("PeakCache");
+}
+
+//==============================================================================
+juce::File PeakFileCache::getEntryFile(uint64 key)
+{
+    return getCacheDirectory().getChildFile(juce::String::toHexString(static_cast<int64>(key)) + ".peaks");
+}
+
+void PeakFileCache::prune()
+{
+    auto entries = getCacheDirectory().findChildFiles(juce::File::findFiles, false, "*.peaks");
+
+    int64 totalBytes = 0;
+    for (const auto& entry : entries)
+        totalBytes += entry.getSize();
+
+    if (totalBytes <= maxCacheBytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    for (const auto& entry : entries)
+    {
+        if (totalBytes <= maxCacheBytes)
+            break;
+
+        const int64 size = entry.getSize();
+        if (entry.deleteFile())
+            totalBytes -= size;
+    }
+}
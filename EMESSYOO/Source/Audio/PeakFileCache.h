@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PeakPyramid.h"
+
+//==============================================================================
+/**
+ * Per-user disk cache of waveform peak pyramids, so reopening a long track or
+ * a pack PCM shows its waveform straight away instead of rebuilding it.
+ *
+ * Entries are keyed by the audio file's path, size and modification time plus
+ * a hash of its first and last 64 KB and evenly spaced chunks in between, so
+ * an edited or replaced file never matches an old entry, and by the format it
+ * was decoded to, so peaks of one import never stand in for another. Entries are
+ * memory-mapped on load and the oldest are pruned once the cache grows past
+ * its size budget.
+ */
+class PeakFileCache
+{
+public:
+    //==============================================================================
+    /** What the file was decoded to: the buffer the peaks are built from. */
+    struct DecodeSettings
+    {
+        double sampleRate = 0.0;  // after any resampling
+        int numChannels = 0;      // after any channel mixing
+        int64 numSamples = 0;
+    };
+
+    /**
+     * Compute the cache key for an audio file as decoded. Reads about 200 KB of
+     * the file, so call it from a background thread.
+     * @return the key, or 0 if the file cannot be read
+     */
+    static uint64 computeKey(const juce::File& audioFile, const DecodeSettings& decode);
+
+    /**
+     * Map a cached pyramid.
+     * @param key Key from computeKey()
+     * @param version Audio version to stamp on the result
+     * @return the pyramid, or nullptr if there is no valid entry
+     */
+    static PeakPyramid::Ptr load(uint64 key, uint32 version);
+
+    /** Save a pyramid under a key and prune the cache. Safe to call from any thread. */
+    static void store(uint64 key, const PeakPyramid& pyramid);
+
+    /** Where entries are kept. */
+    static juce::File getCacheDirectory();
+
+    //==============================================================================
+    static constexpr int64 maxCacheBytes = 256 * 1024 * 1024;
+
+private:
+    static juce::File getEntryFile(uint64 key);
+    static void prune();
+};
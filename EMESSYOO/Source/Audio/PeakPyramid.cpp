@@ -0,0 +1,248 @@
+#include "PeakPyramid.h"
+
+namespace
+{
+    // Blocks processed between shouldExit polls
+    constexpr int64 exitCheckInterval = 4096;
+
+    // File layout: fixed little-endian header, then the peak data as stored in memory
+    constexpr char fileMagic[4] = { 'M', 'S', 'P', 'K' };
+    constexpr size_t fileHeaderSize = 64;
+
+    PeakPyramid::Peak combinePeaks(const PeakPyramid::Peak* peaks, int64 count)
+    {
+        PeakPyramid::Peak result { peaks[0].minValue, peaks[0].maxValue, 0.0f };
+        double sumOfSquares = 0.0;
+
+        for (int64 i = 0; i < count; ++i)
+        {
+            result.minValue = juce::jmin(result.minValue, peaks[i].minValue);
+            result.maxValue = juce::jmax(result.maxValue, peaks[i].maxValue);
+            sumOfSquares += static_cast<double>(peaks[i].rms) * peaks[i].rms;
+        }
+
+        result.rms = static_cast<float>(std::sqrt(sumOfSquares / static_cast<double>(count)));
+        return result;
+    }
+}
+
+//==============================================================================
+PeakPyramid::Ptr PeakPyramid::build(const juce::AudioBuffer<float>& buffer,
+                                    double sampleRate,
+                                    uint32 version,
+                                    const std::function<bool()>& shouldExit)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int64 numSamples = buffer.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 0)
+        return nullptr;
+
+    std::shared_ptr<PeakPyramid> pyramid(new PeakPyramid());
+    pyramid->numChannels = numChannels;
+    pyramid->numSamples = numSamples;
+    pyramid->sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    pyramid->version = version;
+
+    // Lay out every level up front so the whole pyramid is one allocation
+    pyramid->layOutLevels();
+    pyramid->storage.resize(pyramid->getTotalPeaks());
+    pyramid->peakData = pyramid->storage.data();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* samples = buffer.getReadPointer(ch);
+        Peak* level0 = pyramid->getWritablePeaks(ch, 0);
+
+        for (int64 block = 0; block < pyramid->levelSizes[0]; ++block)
+        {
+            if (shouldExit && block % exitCheckInterval == 0 && shouldExit())
+                return nullptr;
+
+            const int64 start = block * baseBlockSize;
+            const int count = static_cast<int>(juce::jmin<int64>(baseBlockSize, numSamples - start));
+            const float* data = samples + start;
+
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, count);
+
+            float sumOfSquares = 0.0f;
+            for (int i = 0; i < count; ++i)
+                sumOfSquares += data[i] * data[i];
+
+            level0[block] = { range.getStart(), range.getEnd(), std::sqrt(sumOfSquares / static_cast<float>(count)) };
+        }
+
+        for (int level = 1; level < pyramid->getNumLevels(); ++level)
+        {
+            const Peak* below = pyramid->getPeaks(ch, level - 1);
+            const int64 belowSize = pyramid->levelSizes[static_cast<size_t>(level - 1)];
+            Peak* current = pyramid->getWritablePeaks(ch, level);
+
+            for (int64 i = 0; i < pyramid->levelSizes[static_cast<size_t>(level)]; ++i)
+            {
+                const int64 first = i * levelRatio;
+                current[i] = combinePeaks(below + first, juce::jmin<int64>(levelRatio, belowSize - first));
+            }
+        }
+    }
+
+    return pyramid;
+}
+
+void PeakPyramid::layOutLevels()
+{
+    levelSizes.clear();
+    levelOffsets.clear();
+
+    size_t totalPeaks = 0;
+    int64 levelSize = (numSamples + baseBlockSize - 1) / baseBlockSize;
+    for (;;)
+    {
+        levelSizes.push_back(levelSize);
+        levelOffsets.push_back(totalPeaks);
+        totalPeaks += static_cast<size_t>(levelSize) * static_cast<size_t>(numChannels);
+
+        if (levelSize <= 1)
+            break;
+        levelSize = (levelSize + levelRatio - 1) / levelRatio;
+    }
+}
+
+size_t PeakPyramid::getTotalPeaks() const
+{
+    if (levelSizes.empty())
+        return 0;
+    return levelOffsets.back() + static_cast<size_t>(levelSizes.back()) * static_cast<size_t>(numChannels);
+}
+
+//==============================================================================
+bool PeakPyramid::writeToFile(const juce::File& file, uint64 key) const
+{
+   #if JUCE_BIG_ENDIAN
+    // Peaks are written as they sit in memory; only little-endian files are supported
+    juce::ignoreUnused(file, key);
+    return false;
+   #else
+    if (peakData == nullptr || !file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        out.write(fileMagic, sizeof(fileMagic));
+        out.writeInt(static_cast<int>(fileFormatVersion));
+        out.writeInt64(static_cast<int64>(key));
+        out.writeInt64(numSamples);
+        out.writeDouble(sampleRate);
+        out.writeInt(numChannels);
+        out.writeInt(baseBlockSize);
+        out.writeInt(levelRatio);
+        out.writeInt(static_cast<int>(sizeof(Peak)));
+
+        while (out.getPosition() < static_cast<int64>(fileHeaderSize))
+            out.writeByte(0);
+
+        if (!out.write(peakData, getMemoryUsage()))
+            return false;
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+   #endif
+}
+
+PeakPyramid::Ptr PeakPyramid::mapFromFile(const juce::File& file, uint64 expectedKey, uint32 version)
+{
+   #if JUCE_BIG_ENDIAN
+    juce::ignoreUnused(file, expectedKey, version);
+    return nullptr;
+   #else
+    if (!file.existsAsFile() || file.getSize() < static_cast<int64>(fileHeaderSize))
+        return nullptr;
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapped->getData() == nullptr || mapped->getSize() < fileHeaderSize)
+        return nullptr;
+
+    const auto* header = static_cast<const char*>(mapped->getData());
+    if (std::memcmp(header, fileMagic, sizeof(fileMagic)) != 0
+        || juce::ByteOrder::littleEndianInt(header + 4) != fileFormatVersion
+        || static_cast<uint64>(juce::ByteOrder::littleEndianInt64(header + 8)) != expectedKey
+        || static_cast<int>(juce::ByteOrder::littleEndianInt(header + 36)) != baseBlockSize
+        || static_cast<int>(juce::ByteOrder::littleEndianInt(header + 40)) != levelRatio
+        || juce::ByteOrder::littleEndianInt(header + 44) != sizeof(Peak))
+        return nullptr;
+
+    std::shared_ptr<PeakPyramid> pyramid(new PeakPyramid());
+    pyramid->numSamples = static_cast<int64>(juce::ByteOrder::littleEndianInt64(header + 16));
+
+    double storedRate = 0.0;
+    std::memcpy(&storedRate, header + 24, sizeof(storedRate));
+    pyramid->sampleRate = storedRate;
+    pyramid->numChannels = static_cast<int>(juce::ByteOrder::littleEndianInt(header + 32));
+    pyramid->version = version;
+
+    if (pyramid->numSamples <= 0 || pyramid->numChannels <= 0 || pyramid->sampleRate <= 0.0)
+        return nullptr;
+
+    pyramid->layOutLevels();
+    if (mapped->getSize() != fileHeaderSize + pyramid->getMemoryUsage())
+        return nullptr;
+
+    pyramid->peakData = reinterpret_cast<const Peak*>(header + fileHeaderSize);
+    pyramid->mappedFile = std::move(mapped);
+    return pyramid;
+   #endif
+}
+
+//==============================================================================
+int64 PeakPyramid::getSamplesPerPeak(int level) const
+{
+    int64 samplesPerPeak = baseBlockSize;
+    for (int i = 0; i < level; ++i)
+        samplesPerPeak *= levelRatio;
+    return samplesPerPeak;
+}
+
+const PeakPyramid::Peak* PeakPyramid::getPeaks(int channel, int level) const
+{
+    return peakData + getOffset(channel, level);
+}
+
+PeakPyramid::Peak* PeakPyramid::getWritablePeaks(int channel, int level)
+{
+    return storage.data() + getOffset(channel, level);
+}
+
+size_t PeakPyramid::getOffset(int channel, int level) const
+{
+    const auto levelIndex = static_cast<size_t>(level);
+    return levelOffsets[levelIndex] + static_cast<size_t>(channel) * static_cast<size_t>(levelSizes[levelIndex]);
+}
+
+PeakPyramid::Peak PeakPyramid::getRange(int channel, int64 startSample, int64 endSample) const
+{
+    startSample = juce::jlimit<int64>(0, numSamples, startSample);
+    endSample = juce::jlimit<int64>(startSample, numSamples, endSample);
+    if (endSample <= startSample || channel < 0 || channel >= numChannels)
+        return {};
+
+    // Coarsest level whose peaks are no wider than the range
+    const int64 span = endSample - startSample;
+    int level = 0;
+    int64 samplesPerPeak = baseBlockSize;
+    while (level + 1 < getNumLevels() && samplesPerPeak * levelRatio <= span)
+    {
+        ++level;
+        samplesPerPeak *= levelRatio;
+    }
+
+    const int64 first = startSample / samplesPerPeak;
+    const int64 last = juce::jmin(getNumPeaks(level), (endSample + samplesPerPeak - 1) / samplesPerPeak);
+    return combinePeaks(getPeaks(channel, level) + first, juce::jmax<int64>(1, last - first));
+}
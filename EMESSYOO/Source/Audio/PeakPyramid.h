@@ -0,0 +1,119 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * Multi-resolution min/max/RMS summary of an audio buffer for waveform drawing.
+ *
+ * Level 0 holds one peak per baseBlockSize samples; each level above it
+ * combines levelRatio peaks of the level below, until a single peak covers
+ * the whole buffer. Any sample range can then be summarised from a handful of
+ * entries on the coarsest level that still resolves it, so drawing costs
+ * O(pixels) at every zoom.
+ *
+ * Pyramids are immutable once built and shared between threads as
+ * std::shared_ptr<const PeakPyramid>. They can be saved to a compact binary
+ * file and memory-mapped back without copying the peak data.
+ */
+class PeakPyramid
+{
+public:
+    //==============================================================================
+    struct Peak
+    {
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        float rms = 0.0f;
+    };
+
+    using Ptr = std::shared_ptr<const PeakPyramid>;
+
+    static constexpr int baseBlockSize = 64;
+    static constexpr int levelRatio = 4;
+
+    //==============================================================================
+    /**
+     * Build a pyramid from a buffer.
+     * @param buffer Source audio
+     * @param sampleRate Sample rate of the source audio
+     * @param version Caller's identifier for the audio content, stored with the result
+     * @param shouldExit Polled between blocks; returning true abandons the build
+     * @return the pyramid, or nullptr if the build was abandoned or the buffer is empty
+     */
+    static Ptr build(const juce::AudioBuffer<float>& buffer,
+                     double sampleRate,
+                     uint32 version,
+                     const std::function<bool()>& shouldExit = {});
+
+    //==============================================================================
+    int getNumChannels() const { return numChannels; }
+    int64 getNumSamples() const { return numSamples; }
+    double getSampleRate() const { return sampleRate; }
+    uint32 getVersion() const { return version; }
+
+    int getNumLevels() const { return static_cast<int>(levelSizes.size()); }
+    int64 getSamplesPerPeak(int level) const;
+    int64 getNumPeaks(int level) const { return levelSizes[static_cast<size_t>(level)]; }
+
+    /** Peaks of one channel at one level, getNumPeaks(level) entries long. */
+    const Peak* getPeaks(int channel, int level) const;
+
+    /**
+     * Summarise samples [startSample, endSample) of one channel.
+     * Reads at most levelRatio + 2 entries; the result may extend up to one
+     * peak either side of the range, which is below a pixel when drawing.
+     */
+    Peak getRange(int channel, int64 startSample, int64 endSample) const;
+
+    /** Bytes used by the peak data. */
+    size_t getMemoryUsage() const { return getTotalPeaks() * sizeof(Peak); }
+
+    //==============================================================================
+    /**
+     * Save the pyramid. The file is written to a temporary and moved into place,
+     * so readers never see a partial file.
+     * @param file Destination
+     * @param key Identifies the audio the pyramid was built from; checked by mapFromFile
+     * @return true on success
+     */
+    bool writeToFile(const juce::File& file, uint64 key) const;
+
+    /**
+     * Memory-map a pyramid saved by writeToFile.
+     * @param file Source file
+     * @param expectedKey Key the file must have been written with
+     * @param version Caller's identifier for the audio content, stored with the result
+     * @return the pyramid, or nullptr if the file is missing, stale, or malformed
+     */
+    static Ptr mapFromFile(const juce::File& file, uint64 expectedKey, uint32 version);
+
+    static constexpr uint32 fileFormatVersion = 1;
+
+private:
+    //==============================================================================
+    PeakPyramid() = default;
+
+    int numChannels = 0;
+    int64 numSamples = 0;
+    double sampleRate = 44100.0;
+    uint32 version = 0;
+
+    std::vector<int64> levelSizes;    // peaks per channel on each level
+    std::vector<size_t> levelOffsets; // start of each level in the peak data, channels stored back to back
+
+    // Peak data lives either in storage (built) or in mappedFile (loaded)
+    const Peak* peakData = nullptr;
+    std::vector<Peak> storage;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+
+    Peak* getWritablePeaks(int channel, int level);
+    size_t getOffset(int channel, int level) const;
+    size_t getTotalPeaks() const;
+    void layOutLevels();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeakPyramid)
+};
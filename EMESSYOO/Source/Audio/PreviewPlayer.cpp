@@ -1,18 +1,17 @@
 #include "PreviewPlayer.h"
-#include "../Core/AudioFileHandler.h"
-
-#include <limits>
 
 //==============================================================================
 PreviewPlayer::PreviewPlayer()
 {
     // Register audio formats
     formatManager.registerBasicFormats();
+    readAheadThread.startThread();
 }
 
 PreviewPlayer::~PreviewPlayer()
 {
     stop();
+    readAheadThread.stopThread(1000);
 }
 
 void PreviewPlayer::setAudioDeviceManager(juce::AudioDeviceManager* manager)
@@ -55,17 +54,37 @@ bool PreviewPlayer::loadAndPlay(const juce::File& file)
     // Check if it's a PCM file (needs special handling)
     if (file.getFileExtension().toLowerCase() == ".pcm")
     {
-        // Load PCM data into buffer (avoid real-time disk I/O)
-        loadPCMIntoBuffer(file);
+        // Open the stream and buffer just enough to cover the first callbacks;
+        // the read-ahead thread keeps the ring buffer topped up from there.
+        // A cached head already covers the start, so the stream resumes after it.
         refreshDeviceSampleRate();
         
-        if (pcmBuffer.getNumSamples() == 0)
+        PreviewPrefetchCache::EntryPtr cachedHead;
+        if (prefetchCache != nullptr)
+            cachedHead = prefetchCache->find(file);
+        
+        const int64 streamStart = cachedHead != nullptr ? cachedHead->head.getNumSamples() : 0;
+        const int framesToPrime = cachedHead != nullptr ? 0 : getPCMPrimeFrameCount();
+        
+        auto stream = std::make_unique<MSU1PCMStream>();
+        if (!stream->open(file, framesToPrime, streamStart))
             return false;
         
+        readAheadThread.addTimeSliceClient(stream.get());
+        
         const juce::ScopedLock lock(callbackLock);
+        pcmStream = std::move(stream);
+        pcmCachedHead = std::move(cachedHead);
+        pcmCachedHeadIndex = 0;
         isPCMFile = true;
-        pcmPosition = 0;
-        pcmFractionalPosition = 0.0;
+        pcmScratchIndex = 0;
+        pcmScratchCount = 0;
+        pcmCurrentFrame[0] = pcmCurrentFrame[1] = 0.0f;
+        pcmNextFrame[0] = pcmNextFrame[1] = 0.0f;
+        
+        // The first two frames pulled prime the interpolator
+        pcmFractionalPosition = 2.0;
+        pcmFramesConsumed = -2;
         playing = true;
         
         return true;
@@ -113,28 +132,44 @@ bool PreviewPlayer::loadAndPlay(const juce::File& file)
 
 void PreviewPlayer::stop()
 {
-    const juce::ScopedLock lock(callbackLock);
+    std::unique_ptr<MSU1PCMStream> streamToRelease;
+    PreviewPrefetchCache::EntryPtr headToRelease;
     
-    playing = false;
-    
-    resamplingSource.reset();
-    readerSource.reset();
-    currentReader.reset();
+    {
+        const juce::ScopedLock lock(callbackLock);
+        
+        playing = false;
+        
+        resamplingSource.reset();
+        readerSource.reset();
+        currentReader.reset();
+        
+        // Detach the PCM stream; it is released outside the lock so the audio
+        // callback never waits on the read-ahead thread.
+        streamToRelease = std::move(pcmStream);
+        headToRelease = std::move(pcmCachedHead);
+        pcmCachedHeadIndex = 0;
+        pcmScratchIndex = 0;
+        pcmScratchCount = 0;
+        pcmFractionalPosition = 0.0;
+        pcmFramesConsumed = 0;
+        isPCMFile = false;
+    }
     
-    // Clean up PCM streaming
-    pcmInputStream.reset();
-    pcmBuffer.setSize(0, 0);
-    pcmPosition = 0;
-    pcmFractionalPosition = 0.0;
-    pcmLoopPoint = 0;
-    pcmTotalSamples = 0;
-    isPCMFile = false;
+    if (streamToRelease != nullptr)
+        readAheadThread.removeTimeSliceClient(streamToRelease.get());
 }
 
 double PreviewPlayer::getPosition() const
 {
     if (isPCMFile)
-        return pcmFractionalPosition / pcmNativeSampleRate;
+    {
+        if (pcmStream == nullptr)
+            return 0.0;
+        
+        const auto filePosition = pcmStream->getFilePositionForFramesConsumed(pcmFramesConsumed.load());
+        return static_cast<double>(filePosition) / pcmNativeSampleRate;
+    }
     
     if (readerSource == nullptr || currentReader == nullptr)
         return 0.0;
@@ -145,7 +180,7 @@ double PreviewPlayer::getPosition() const
 double PreviewPlayer::getTotalLength() const
 {
     if (isPCMFile)
-        return static_cast<double>(pcmBuffer.getNumSamples()) / pcmNativeSampleRate;
+        return pcmStream != nullptr ? static_cast<double>(pcmStream->getTotalSamples()) / pcmNativeSampleRate : 0.0;
     
     if (currentReader == nullptr)
         return 0.0;
@@ -161,6 +196,8 @@ void PreviewPlayer::audioDeviceAboutToStart(juce::AudioIODevice* device)
     if (deviceSampleRate <= 0.0)
         refreshDeviceSampleRate();
     
+    callbackMonitor.prepare(deviceSampleRate);
+    
     DBG("Preview device starting at " + juce::String(deviceSampleRate) + " Hz");
     
     // Update resampling ratio if we have a file loaded
@@ -179,6 +216,7 @@ void PreviewPlayer::audioDeviceStopped()
     if (resamplingSource != nullptr)
         resamplingSource->releaseResources();
     deviceSampleRate = 0.0;
+    callbackMonitor.deviceStopped();
 }
 
 void PreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
@@ -189,8 +227,10 @@ void PreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputCh
                                                      const juce::AudioIODeviceCallbackContext& context)
 {
     juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    AudioCallbackMonitor::ScopedCallback callbackTiming(callbackMonitor, numSamples);
     
     const juce::ScopedLock lock(callbackLock);
+    callbackTiming.lockAcquired();
     
     if (!playing)
     {
@@ -214,38 +254,48 @@ void PreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputCh
             }
         };
 
-        if (pcmBuffer.getNumSamples() == 0)
+        if (pcmStream == nullptr)
         {
             clearTail(0);
             playing = false;
             return;
         }
 
-        refreshDeviceSampleRate();
         const double playbackRate = deviceSampleRate > 0.0 ? deviceSampleRate : pcmNativeSampleRate;
         const double ratio = pcmNativeSampleRate / playbackRate;
-        const int availableChannels = juce::jmin(numOutputChannels, pcmBuffer.getNumChannels());
+        const int availableChannels = juce::jmin(numOutputChannels, 2);
+        int64 framesConsumed = pcmFramesConsumed.load();
 
         for (int i = 0; i < numSamples; ++i)
         {
-            if (pcmFractionalPosition >= pcmBuffer.getNumSamples())
+            while (pcmFractionalPosition >= 1.0)
             {
-                playing = false;
+                float incoming[2];
+                if (!pullPCMFrame(incoming))
+                    break;
+
+                pcmCurrentFrame[0] = pcmNextFrame[0];
+                pcmCurrentFrame[1] = pcmNextFrame[1];
+                pcmNextFrame[0] = incoming[0];
+                pcmNextFrame[1] = incoming[1];
+                pcmFractionalPosition -= 1.0;
+                ++framesConsumed;
+            }
+
+            if (pcmFractionalPosition >= 1.0)
+            {
+                // Read-ahead hasn't caught up (slow disk); stay silent and resume next block
                 clearTail(i);
                 break;
             }
 
-            const int sourceIndex = static_cast<int>(pcmFractionalPosition);
-            const int nextIndex = juce::jmin(sourceIndex + 1, pcmBuffer.getNumSamples() - 1);
-            const double fraction = pcmFractionalPosition - static_cast<double>(sourceIndex);
-
             for (int ch = 0; ch < availableChannels; ++ch)
             {
                 if (outputChannelData[ch] != nullptr)
                 {
-                    const float sample1 = pcmBuffer.getSample(ch, sourceIndex);
-                    const float sample2 = pcmBuffer.getSample(ch, nextIndex);
-                    outputChannelData[ch][i] = static_cast<float>(sample1 + (sample2 - sample1) * fraction);
+                    const float sample1 = pcmCurrentFrame[ch];
+                    const float sample2 = pcmNextFrame[ch];
+                    outputChannelData[ch][i] = static_cast<float>(sample1 + (sample2 - sample1) * pcmFractionalPosition);
                 }
             }
 
@@ -259,7 +309,7 @@ void PreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputCh
             pcmFractionalPosition += ratio;
         }
 
-        pcmPosition = static_cast<int64>(pcmFractionalPosition);
+        pcmFramesConsumed = framesConsumed;
         return;
     }
     else
@@ -286,66 +336,42 @@ void PreviewPlayer::audioDeviceIOCallbackWithContext(const float* const* inputCh
     }
 }
 
-void PreviewPlayer::loadPCMIntoBuffer(const juce::File& file)
+bool PreviewPlayer::pullPCMFrame(float* frame)
 {
-    pcmTotalSamples = 0;
-
-    // Read loop point from companion file
-    juce::File loopFile = file.withFileExtension(".pcm.loop");
-    pcmLoopPoint = 0;
-    
-    if (loopFile.existsAsFile())
-    {
-        juce::FileInputStream loopStream(loopFile);
-        if (loopStream.openedOk() && loopStream.getNumBytesRemaining() >= 4)
-        {
-            // Read 32-bit little-endian loop point (in samples)
-            pcmLoopPoint = loopStream.readInt();
-        }
-    }
-    
-    // Open PCM file
-    juce::FileInputStream pcmStream(file);
-    if (!pcmStream.openedOk())
-    {
-        pcmBuffer.setSize(0, 0);
-        return;
-    }
-    
-    // Calculate total samples (PCM is 16-bit stereo @ 44100Hz)
-    const int64 fileSize = pcmStream.getTotalLength();
-    const int64 totalSamples = fileSize / 4; // 2 bytes per sample * 2 channels
-    if (totalSamples <= 0 || totalSamples > std::numeric_limits<int>::max())
+    if (pcmCachedHead != nullptr && pcmCachedHeadIndex < pcmCachedHead->head.getNumSamples())
     {
-        pcmBuffer.setSize(0, 0);
-        return;
+        frame[0] = pcmCachedHead->head.getSample(0, pcmCachedHeadIndex);
+        frame[1] = pcmCachedHead->head.getSample(1, pcmCachedHeadIndex);
+        ++pcmCachedHeadIndex;
+        return true;
     }
-    
-    // Allocate buffer (stereo)
-    pcmBuffer.setSize(2, static_cast<int>(totalSamples));
-    
-    // Read and convert PCM data
-    juce::HeapBlock<char> rawData;
-    rawData.malloc(static_cast<size_t>(fileSize));
-    
-    if (pcmStream.read(rawData, static_cast<int>(fileSize)) != fileSize)
+
+    if (pcmScratchIndex >= pcmScratchCount)
     {
-        pcmBuffer.setSize(0, 0);
-        return;
+        pcmScratchIndex = 0;
+        pcmScratchCount = pcmStream->read(pcmScratch.getWritePointer(0),
+                                          pcmScratch.getWritePointer(1),
+                                          pcmScratchFrames);
+        if (pcmScratchCount == 0)
+            return false;
     }
-    
-    // Convert 16-bit signed PCM to float
-    float* leftChannel = pcmBuffer.getWritePointer(0);
-    float* rightChannel = pcmBuffer.getWritePointer(1);
-    
-    for (int i = 0; i < static_cast<int>(totalSamples); ++i)
+
+    frame[0] = pcmScratch.getSample(0, pcmScratchIndex);
+    frame[1] = pcmScratch.getSample(1, pcmScratchIndex);
+    ++pcmScratchIndex;
+    return true;
+}
+
+int PreviewPlayer::getPCMPrimeFrameCount() const
+{
+    int blockSize = 512;
+    if (audioDeviceManager != nullptr)
     {
-        int16_t leftSample = *reinterpret_cast<int16_t*>(rawData.getData() + i * 4);
-        int16_t rightSample = *reinterpret_cast<int16_t*>(rawData.getData() + i * 4 + 2);
-        
-        leftChannel[i] = leftSample / 32768.0f;
-        rightChannel[i] = rightSample / 32768.0f;
+        if (auto* device = audioDeviceManager->getCurrentAudioDevice())
+            blockSize = juce::jmax(blockSize, device->getCurrentBufferSizeSamples());
     }
-    
-    pcmTotalSamples = totalSamples;
+
+    const double ratio = deviceSampleRate > 0.0 ? pcmNativeSampleRate / deviceSampleRate : 1.0;
+    const int framesPerBlock = static_cast<int>(std::ceil(blockSize * ratio)) + 2;
+    return juce::jmax(pcmMinimumPrimeFrames, framesPerBlock * 4);
 }
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MSU1PCMStream.h"
+#include "PreviewPrefetchCache.h"
+#include "AudioCallbackMonitor.h"
 
 //==============================================================================
 /**
  * Lightweight audio player for previewing tracks without loading waveforms.
  * Designed for quick MSU-1 track audition in the file browser.
+ * MSU-1 .pcm files are streamed from disk through a read-ahead ring buffer
+ * and loop at the loop point stored in their header. When a prefetch cache
+ * holds the head of a track, playback starts from memory while the stream
+ * picks up right after it.
  */
 class PreviewPlayer : public juce::AudioIODeviceCallback
 {
@@ -44,6 +51,12 @@ public:
 
     void setAudioDeviceManager(juce::AudioDeviceManager* manager);
     
+    /** Callback timing statistics for the diagnostics panel */
+    AudioCallbackMonitor& getCallbackMonitor() { return callbackMonitor; }
+    
+    /** Use a prefetch cache to start warmed tracks without touching the disk (not owned) */
+    void setPrefetchCache(PreviewPrefetchCache* cache) { prefetchCache = cache; }
+    
 private:
     //==============================================================================
     juce::AudioFormatManager formatManager;
@@ -51,22 +64,34 @@ private:
     std::unique_ptr<juce::ResamplingAudioSource> resamplingSource;
     std::unique_ptr<juce::AudioFormatReader> currentReader;
     
-    // PCM-specific streaming with pre-buffering
-    std::unique_ptr<juce::FileInputStream> pcmInputStream;
-    juce::AudioBuffer<float> pcmBuffer;  // Pre-loaded PCM data
-    int64 pcmPosition = 0;
+    static constexpr double pcmNativeSampleRate = 44100.0;
+    static constexpr int pcmScratchFrames = 512;
+    static constexpr int pcmMinimumPrimeFrames = 4096;
+    
+    // PCM-specific streaming: a background read-ahead thread fills the stream's
+    // ring buffer, the audio callback only pops frames and interpolates.
+    juce::TimeSliceThread readAheadThread { "PCM Preview Read-Ahead" };
+    std::unique_ptr<MSU1PCMStream> pcmStream;
+    PreviewPrefetchCache* prefetchCache = nullptr;
+    PreviewPrefetchCache::EntryPtr pcmCachedHead;
+    int pcmCachedHeadIndex = 0;
+    juce::AudioBuffer<float> pcmScratch { 2, pcmScratchFrames };
+    int pcmScratchIndex = 0;
+    int pcmScratchCount = 0;
+    float pcmCurrentFrame[2] = { 0.0f, 0.0f };
+    float pcmNextFrame[2] = { 0.0f, 0.0f };
     double pcmFractionalPosition = 0.0;
-    int64 pcmLoopPoint = 0;
-    int64 pcmTotalSamples = 0;
+    std::atomic<int64> pcmFramesConsumed { 0 };
     bool isPCMFile = false;
-    static constexpr double pcmNativeSampleRate = 44100.0;
     
-    bool playing = false;
+    std::atomic<bool> playing { false };  // read by the UI every frame
     double deviceSampleRate = 0.0;
     juce::AudioDeviceManager* audioDeviceManager = nullptr;
     juce::CriticalSection callbackLock;
+    AudioCallbackMonitor callbackMonitor { "PreviewPlayer" };
     
-    void loadPCMIntoBuffer(const juce::File& file);
+    bool pullPCMFrame(float* frame);
+    int getPCMPrimeFrameCount() const;
     void refreshDeviceSampleRate();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreviewPlayer)
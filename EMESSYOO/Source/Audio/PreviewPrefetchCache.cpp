@@ -0,0 +1,163 @@
+#include "PreviewPrefetchCache.h"
+#include "MSU1PCMStream.h"
+
+//==============================================================================
+size_t PreviewPrefetchCache::Entry::getMemoryUsage() const
+{
+    return static_cast<size_t>(head.getNumChannels()) * static_cast<size_t>(head.getNumSamples()) * sizeof(float);
+}
+
+//==============================================================================
+PreviewPrefetchCache::PrefetchJob::PrefetchJob(PreviewPrefetchCache& ownerCache, const juce::File& fileToWarm)
+    : juce::ThreadPoolJob("Prefetch " + fileToWarm.getFileName()),
+      owner(ownerCache),
+      file(fileToWarm)
+{
+}
+
+juce::ThreadPoolJob::JobStatus PreviewPrefetchCache::PrefetchJob::runJob()
+{
+    if (shouldExit() || owner.find(file) != nullptr)
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    if (auto entry = PreviewPrefetchCache::loadHead(file))
+    {
+        if (!shouldExit())
+            owner.store(std::move(entry));
+    }
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+PreviewPrefetchCache::PreviewPrefetchCache(size_t memoryBudgetBytes)
+    : memoryBudget(memoryBudgetBytes)
+{
+}
+
+PreviewPrefetchCache::~PreviewPrefetchCache()
+{
+    pool.removeAllJobs(true, 2000);
+}
+
+void PreviewPrefetchCache::prefetch(const juce::Array<juce::File>& files)
+{
+    // Anything still queued belongs to an older selection; the running job is left to finish
+    pool.removeAllJobs(false, 0);
+
+    for (const auto& file : files)
+    {
+        if (!file.hasFileExtension("pcm") || !file.existsAsFile())
+            continue;
+
+        if (find(file) != nullptr)
+            continue;
+
+        pool.addJob(new PrefetchJob(*this, file), true);
+    }
+}
+
+PreviewPrefetchCache::EntryPtr PreviewPrefetchCache::find(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if ((*it)->file != file)
+            continue;
+
+        if (!isCurrent(**it, file))
+        {
+            memoryUsed -= (*it)->getMemoryUsage();
+            entries.erase(it);
+            return nullptr;
+        }
+
+        // Move to the most recently used end
+        auto entry = *it;
+        entries.erase(it);
+        entries.push_back(entry);
+        return entry;
+    }
+
+    return nullptr;
+}
+
+void PreviewPrefetchCache::clear()
+{
+    pool.removeAllJobs(true, 2000);
+
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    memoryUsed = 0;
+}
+
+size_t PreviewPrefetchCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+//==============================================================================
+void PreviewPrefetchCache::store(EntryPtr entry)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if ((*it)->file == entry->file)
+        {
+            memoryUsed -= (*it)->getMemoryUsage();
+            entries.erase(it);
+            break;
+        }
+    }
+
+    memoryUsed += entry->getMemoryUsage();
+    entries.push_back(std::move(entry));
+
+    // Evict least recently used heads, always keeping the one just added
+    while (memoryUsed > memoryBudget && entries.size() > 1)
+    {
+        memoryUsed -= entries.front()->getMemoryUsage();
+        entries.erase(entries.begin());
+    }
+}
+
+bool PreviewPrefetchCache::isCurrent(const Entry& entry, const juce::File& file)
+{
+    return entry.fileSize == file.getSize()
+        && entry.modificationTime == file.getLastModificationTime();
+}
+
+PreviewPrefetchCache::EntryPtr PreviewPrefetchCache::loadHead(const juce::File& file)
+{
+    juce::FileInputStream input(file);
+    if (!input.openedOk())
+        return nullptr;
+
+    auto entry = std::make_shared<Entry>();
+    entry->file = file;
+    entry->fileSize = file.getSize();
+    entry->modificationTime = file.getLastModificationTime();
+
+    juce::String error;
+    if (!MSU1PCMStream::readHeader(input, entry->totalSamples, entry->loopPoint, error))
+    {
+        DBG("PreviewPrefetchCache: " + file.getFileName() + " - " + error);
+        return nullptr;
+    }
+
+    const auto framesWanted = static_cast<int>(juce::jmin(entry->totalSamples,
+                                                          static_cast<int64>(headSeconds * 44100.0)));
+
+    juce::HeapBlock<char> raw(static_cast<size_t>(framesWanted) * MSU1PCMStream::bytesPerFrame);
+    const int bytesRead = input.read(raw.getData(), framesWanted * MSU1PCMStream::bytesPerFrame);
+    const int framesRead = juce::jmax(0, bytesRead) / MSU1PCMStream::bytesPerFrame;
+    if (framesRead <= 0)
+        return nullptr;
+
+    entry->head.setSize(2, framesRead);
+    MSU1PCMStream::decodeFrames(raw.getData(), entry->head.getWritePointer(0), entry->head.getWritePointer(1), framesRead);
+    return entry;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * Keeps the first few seconds of recently requested MSU-1 tracks decoded in
+ * memory so PreviewPlayer can start them instantly.
+ *
+ * Heads are decoded on a background pool; the cache evicts least recently
+ * used entries once the memory budget is exceeded. Entries are tied to the
+ * file's size and modification time, so replaced tracks are never served stale.
+ */
+class PreviewPrefetchCache
+{
+public:
+    //==============================================================================
+    struct Entry
+    {
+        juce::File file;
+        juce::Time modificationTime;
+        int64 fileSize = 0;
+        int64 totalSamples = 0;
+        int64 loopPoint = 0;
+        juce::AudioBuffer<float> head;  // 44.1 kHz stereo, frames [0, head.getNumSamples())
+
+        size_t getMemoryUsage() const;
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    //==============================================================================
+    explicit PreviewPrefetchCache(size_t memoryBudgetBytes = defaultMemoryBudget);
+    ~PreviewPrefetchCache();
+
+    /**
+     * Queue files to warm in priority order. Requests still waiting from an
+     * earlier call are dropped, so callers always pass the complete list.
+     * @param files PCM files, most important first
+     */
+    void prefetch(const juce::Array<juce::File>& files);
+
+    /**
+     * Get the cached head of a file if it is present and still current.
+     * @return the entry, or nullptr if the file has not been warmed
+     */
+    EntryPtr find(const juce::File& file);
+
+    /** Drop all cached entries and pending requests. */
+    void clear();
+
+    /** Current memory used by cached heads, in bytes. */
+    size_t getMemoryUsage() const;
+
+    //==============================================================================
+    static constexpr double headSeconds = 2.0;
+    static constexpr size_t defaultMemoryBudget = 8 * 1024 * 1024;
+
+private:
+    //==============================================================================
+    struct PrefetchJob : public juce::ThreadPoolJob
+    {
+        PrefetchJob(PreviewPrefetchCache& ownerCache, const juce::File& fileToWarm);
+        JobStatus runJob() override;
+
+        PreviewPrefetchCache& owner;
+        juce::File file;
+    };
+
+    const size_t memoryBudget;
+    juce::ThreadPool pool { 1 };
+    mutable juce::CriticalSection lock;
+    std::vector<EntryPtr> entries;  // least recently used first
+    size_t memoryUsed = 0;
+
+    void store(EntryPtr entry);
+    static bool isCurrent(const Entry& entry, const juce::File& file);
+    static EntryPtr loadHead(const juce::File& file);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreviewPrefetchCache)
+};
@@ -0,0 +1,184 @@
+#include "ScrubEngine.h"
+
+//==============================================================================
+ScrubEngine::ScrubEngine()
+{
+    updateGrainLength();
+}
+
+void ScrubEngine::beginScrub(std::shared_ptr<const juce::AudioBuffer<float>> buffer, double bufferSampleRate, int64 startSample)
+{
+    // Swapped out under the lock but freed after it, never on the audio thread
+    const juce::ScopedLock sl(lock);
+
+    std::swap(source, buffer);
+    sourceSampleRate = bufferSampleRate > 0.0 ? bufferSampleRate : 44100.0;
+    targetSample.store(static_cast<double>(startSample), std::memory_order_relaxed);
+    previousTarget = static_cast<double>(startSample);
+    smoothedSpeed = 0.0;
+    samplesUntilNextGrain = 0;
+
+    for (auto& grain : grains)
+        grain.active = false;
+
+    updateGrainLength();
+    scrubbing.store(true, std::memory_order_relaxed);
+}
+
+void ScrubEngine::endScrub()
+{
+    scrubbing.store(false, std::memory_order_relaxed);
+}
+
+void ScrubEngine::releaseIdleSource()
+{
+    std::shared_ptr<const juce::AudioBuffer<float>> oldSource;
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (scrubbing.load(std::memory_order_relaxed))
+            return;
+
+        for (const auto& grain : grains)
+            if (grain.active)
+                return;
+
+        std::swap(oldSource, source);
+    }
+}
+
+//==============================================================================
+void ScrubEngine::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                                   int numInputChannels,
+                                                   float* const* outputChannelData,
+                                                   int numOutputChannels,
+                                                   int numSamples,
+                                                   const juce::AudioIODeviceCallbackContext& context)
+{
+    juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    AudioCallbackMonitor::ScopedCallback callbackTiming(callbackMonitor, numSamples);
+
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+    {
+        if (outputChannelData[ch] != nullptr)
+            juce::FloatVectorOperations::clear(outputChannelData[ch], numSamples);
+    }
+
+    const juce::ScopedLock sl(lock);
+    callbackTiming.lockAcquired();
+
+    if (source == nullptr || source->getNumSamples() == 0 || numSamples <= 0)
+        return;
+
+    const bool active = scrubbing.load(std::memory_order_relaxed);
+    bool anyGrainActive = false;
+    for (const auto& grain : grains)
+        anyGrainActive = anyGrainActive || grain.active;
+
+    if (!active && !anyGrainActive)
+        return;
+
+    // Drag velocity in source samples per source sample (1.0 = normal speed)
+    const double target = targetSample.load(std::memory_order_relaxed);
+    const double sourcePerOutput = sourceSampleRate / deviceSampleRate;
+    const double instantSpeed = (target - previousTarget) / (numSamples * sourcePerOutput);
+    smoothedSpeed = velocitySmoothing * smoothedSpeed + (1.0 - velocitySmoothing) * juce::jlimit(-maxSpeed, maxSpeed, instantSpeed);
+
+    const int numChannels = source->getNumChannels();
+    const int hop = juce::jmax(1, grainLength / 2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (active && --samplesUntilNextGrain <= 0)
+        {
+            // Grains follow the cursor as it moves across the block
+            const double blockProgress = static_cast<double>(i) / numSamples;
+            const double centre = previousTarget + (target - previousTarget) * blockProgress;
+            if (std::abs(smoothedSpeed) > silenceSpeed)
+                spawnGrain(centre, smoothedSpeed);
+            samplesUntilNextGrain = hop;
+        }
+
+        for (auto& grain : grains)
+        {
+            if (!grain.active)
+                continue;
+
+            const double phase = static_cast<double>(grain.age) / grain.length;
+            const float window = static_cast<float>(0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * phase));
+
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+            {
+                if (outputChannelData[ch] != nullptr)
+                    outputChannelData[ch][i] += window * readSample(ch % numChannels, grain.position);
+            }
+
+            grain.position += grain.increment;
+            if (++grain.age >= grain.length)
+                grain.active = false;
+        }
+    }
+
+    previousTarget = target;
+}
+
+void ScrubEngine::audioDeviceAboutToStart(juce::AudioIODevice* device)
+{
+    const juce::ScopedLock sl(lock);
+    deviceSampleRate = (device != nullptr && device->getCurrentSampleRate() > 0.0)
+        ? device->getCurrentSampleRate()
+        : 44100.0;
+    callbackMonitor.prepare(deviceSampleRate);
+    updateGrainLength();
+}
+
+void ScrubEngine::audioDeviceStopped()
+{
+    const juce::ScopedLock sl(lock);
+    for (auto& grain : grains)
+        grain.active = false;
+    callbackMonitor.deviceStopped();
+}
+
+//==============================================================================
+void ScrubEngine::updateGrainLength()
+{
+    grainLength = juce::jmax(64, static_cast<int>(grainLengthMs * deviceSampleRate / 1000.0));
+}
+
+void ScrubEngine::spawnGrain(double centre, double speed)
+{
+    Grain* slot = nullptr;
+    for (auto& grain : grains)
+    {
+        if (!grain.active)
+        {
+            slot = &grain;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+        return;
+
+    // Centre the grain on the cursor so what you hear is what's under the mouse
+    const double increment = speed * sourceSampleRate / deviceSampleRate;
+    slot->position = centre - increment * grainLength * 0.5;
+    slot->increment = increment;
+    slot->age = 0;
+    slot->length = grainLength;
+    slot->active = true;
+}
+
+float ScrubEngine::readSample(int channel, double position) const
+{
+    const int totalSamples = source->getNumSamples();
+    if (position < 0.0 || position >= totalSamples - 1)
+        return 0.0f;
+
+    const int index = static_cast<int>(position);
+    const float fraction = static_cast<float>(position - index);
+    const float sample1 = source->getSample(channel, index);
+    const float sample2 = source->getSample(channel, index + 1);
+    return sample1 + fraction * (sample2 - sample1);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "AudioCallbackMonitor.h"
+
+//==============================================================================
+/**
+ * Granular scrub playback for dragging in the waveform.
+ *
+ * The UI publishes a target sample through an atomic; the audio thread
+ * derives the drag velocity from how far the target moved each block and
+ * plays overlapping Hann-windowed grains around it at that speed, reversed
+ * when dragging left. Holding still lets the last grains fade to silence.
+ */
+class ScrubEngine : public juce::AudioIODeviceCallback
+{
+public:
+    //==============================================================================
+    ScrubEngine();
+    ~ScrubEngine() override = default;
+
+    //==============================================================================
+    /**
+     * Start scrubbing a buffer. The engine keeps its own reference, so the project
+     * can replace its audio while grains are still playing.
+     * @param buffer Source audio, never modified while shared
+     * @param bufferSampleRate Sample rate of the source audio
+     * @param startSample Initial cursor position in buffer samples
+     */
+    void beginScrub(std::shared_ptr<const juce::AudioBuffer<float>> buffer, double bufferSampleRate, int64 startSample);
+
+    /** Move the cursor. Lock-free; call as often as the mouse moves. */
+    void setScrubTarget(int64 sample) noexcept { targetSample.store(static_cast<double>(sample), std::memory_order_relaxed); }
+
+    /** Stop scrubbing; grains already playing finish their fade. */
+    void endScrub();
+
+    /** Let go of the scrubbed audio once the last grain has finished. Call from the message thread. */
+    void releaseIdleSource();
+
+    bool isScrubbing() const noexcept { return scrubbing.load(std::memory_order_relaxed); }
+
+    AudioCallbackMonitor& getCallbackMonitor() { return callbackMonitor; }
+
+    //==============================================================================
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override;
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+private:
+    //==============================================================================
+    struct Grain
+    {
+        double position = 0.0;   // source samples
+        double increment = 0.0;  // source samples per output sample, negative plays backwards
+        int age = 0;
+        int length = 0;
+        bool active = false;
+    };
+
+    static constexpr int maxGrains = 4;
+    static constexpr double grainLengthMs = 40.0;
+    static constexpr double maxSpeed = 4.0;
+    static constexpr double velocitySmoothing = 0.6;
+    static constexpr double silenceSpeed = 0.05;
+
+    juce::CriticalSection lock;
+    std::shared_ptr<const juce::AudioBuffer<float>> source;
+    double sourceSampleRate = 44100.0;
+    double deviceSampleRate = 44100.0;
+
+    std::atomic<double> targetSample { 0.0 };
+    std::atomic<bool> scrubbing { false };
+
+    // Audio-thread state
+    std::array<Grain, maxGrains> grains;
+    double previousTarget = 0.0;
+    double smoothedSpeed = 0.0;
+    int samplesUntilNextGrain = 0;
+    int grainLength = 0;
+
+    AudioCallbackMonitor callbackMonitor { "ScrubEngine" };
+
+    void updateGrainLength();
+    void spawnGrain(double centre, double speed);
+    float readSample(int channel, double position) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScrubEngine)
+};
@@ -0,0 +1,35 @@
+#include "TrackAnalysisCache.h"
+
+//==============================================================================
+TrackAnalysisCache::Key TrackAnalysisCache::makeKey(const juce::File& file)
+{
+    Key key;
+    key.path = file.getFullPathName();
+    key.modificationTime = file.getLastModificationTime();
+    key.fileSize = file.getSize();
+    return key;
+}
+
+std::optional<NormalizationAnalyzer::AudioStats> TrackAnalysisCache::find(const Key& key) const
+{
+    const juce::ScopedLock sl(lock);
+    auto it = entries.find(key.path);
+    if (it == entries.end()
+        || it->second.modificationTime != key.modificationTime
+        || it->second.fileSize != key.fileSize)
+        return std::nullopt;
+
+    return it->second.stats;
+}
+
+void TrackAnalysisCache::store(const Key& key, const NormalizationAnalyzer::AudioStats& stats)
+{
+    const juce::ScopedLock sl(lock);
+    entries[key.path] = { key.modificationTime, key.fileSize, stats };
+}
+
+void TrackAnalysisCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+}
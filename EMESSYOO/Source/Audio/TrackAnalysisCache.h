@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <optional>
+#include "NormalizationAnalyzer.h"
+
+//==============================================================================
+/**
+ * Loudness statistics for MSU-1 tracks, remembered per file.
+ *
+ * Entries are tied to the file's size and modification time, so a track that
+ * has been re-exported is analysed again. Safe to use from any thread; the
+ * Audio Level Studio shares one instance between row previews and batch runs.
+ */
+class TrackAnalysisCache
+{
+public:
+    //==============================================================================
+    /** Identity of a file's contents, taken before reading it. */
+    struct Key
+    {
+        juce::String path;
+        juce::Time modificationTime;
+        int64 fileSize = 0;
+
+        bool operator==(const Key& other) const
+        {
+            return path == other.path && modificationTime == other.modificationTime && fileSize == other.fileSize;
+        }
+    };
+
+    static Key makeKey(const juce::File& file);
+
+    /** Stats stored under key, if the file hasn't changed since. */
+    std::optional<NormalizationAnalyzer::AudioStats> find(const Key& key) const;
+
+    void store(const Key& key, const NormalizationAnalyzer::AudioStats& stats);
+    void clear();
+
+private:
+    struct Entry
+    {
+        juce::Time modificationTime;
+        int64 fileSize = 0;
+        NormalizationAnalyzer::AudioStats stats;
+    };
+
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;  // by full path
+};
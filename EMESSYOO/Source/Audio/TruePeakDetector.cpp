@@ -0,0 +1,82 @@
+#include "TruePeakDetector.h"
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+TruePeakDetector::TruePeakDetector(int numChannels)
+    : channels(juce::jmax(1, numChannels))
+{
+    designInterpolator();
+
+    history.setSize(channels, tapsPerPhase - 1 + maxBlockSize);
+    interpolated.resize(maxBlockSize);
+
+    reset();
+}
+
+void TruePeakDetector::reset()
+{
+    history.clear();
+}
+
+void TruePeakDetector::designInterpolator()
+{
+    // Hann-windowed sinc, one set of taps per fractional position p / oversampling
+    const double centre = tapsPerPhase / 2 - 1;
+    const double halfWidth = tapsPerPhase / 2.0;
+
+    for (int phase = 1; phase < oversampling; ++phase)
+    {
+        const double fraction = static_cast<double>(phase) / oversampling;
+        double sum = 0.0;
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const double x = centre + fraction - tap;
+            const double sinc = juce::approximatelyEqual(x, 0.0) ? 1.0
+                                                                : std::sin(juce::MathConstants<double>::pi * x)
+                                                                      / (juce::MathConstants<double>::pi * x);
+            const double hann = 0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi * x / halfWidth);
+            const double value = sinc * hann;
+            phaseTaps[phase - 1][tap] = static_cast<float>(value);
+            sum += value;
+        }
+
+        // Unity gain at DC, so a full-scale constant doesn't read as an over
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+            phaseTaps[phase - 1][tap] = static_cast<float>(phaseTaps[phase - 1][tap] / sum);
+    }
+}
+
+//==============================================================================
+void TruePeakDetector::process(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float* peaks)
+{
+    constexpr int historySize = tapsPerPhase - 1;
+    constexpr int centre = tapsPerPhase / 2 - 1;
+    const int numChannels = juce::jmin(channels, buffer.getNumChannels());
+
+    jassert(numSamples <= maxBlockSize);
+    juce::FloatVectorOperations::clear(peaks, numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* input = history.getWritePointer(ch);
+        juce::FloatVectorOperations::copy(input + historySize, buffer.getReadPointer(ch, startSample), numSamples);
+
+        // The sample itself, then each fractional position after it
+        juce::FloatVectorOperations::abs(interpolated.data(), input + centre, numSamples);
+        juce::FloatVectorOperations::max(peaks, peaks, interpolated.data(), numSamples);
+
+        for (int phase = 0; phase < oversampling - 1; ++phase)
+        {
+            juce::FloatVectorOperations::clear(interpolated.data(), numSamples);
+            for (int tap = 0; tap < tapsPerPhase; ++tap)
+                juce::FloatVectorOperations::addWithMultiply(interpolated.data(), input + tap, phaseTaps[phase][tap], numSamples);
+
+            juce::FloatVectorOperations::abs(interpolated.data(), interpolated.data(), numSamples);
+            juce::FloatVectorOperations::max(peaks, peaks, interpolated.data(), numSamples);
+        }
+
+        std::memmove(input, input + numSamples, sizeof(float) * static_cast<size_t>(historySize));
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+ * Streaming inter-sample (true) peak measurement.
+ *
+ * Each sample's peak is the largest magnitude over the sample itself and the
+ * three fractional positions after it, interpolated by a 4x polyphase
+ * Hann-windowed sinc. Estimates trail the input by delaySamples, as the
+ * interpolator needs that many samples of lookahead.
+ */
+class TruePeakDetector
+{
+public:
+    //==============================================================================
+    explicit TruePeakDetector(int numChannels);
+
+    /**
+     * Measure numSamples of buffer, starting at startSample, writing the peak
+     * across channels of each (linear) into peaks. numSamples is at most maxBlockSize.
+     */
+    void process(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float* peaks);
+
+    void reset();
+
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int maxBlockSize = 512;
+    static constexpr int delaySamples = tapsPerPhase - tapsPerPhase / 2;   // samples the peak estimate trails the input
+
+private:
+    //==============================================================================
+    int channels;
+    float phaseTaps[oversampling - 1][tapsPerPhase];   // phase 0 is the sample itself
+
+    juce::AudioBuffer<float> history;          // per channel: tapsPerPhase - 1 samples of history, then the block
+    std::vector<float> interpolated;
+
+    void designInterpolator();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakDetector)
+};
@@ -0,0 +1,136 @@
+#include "TruePeakLimiter.h"
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+TruePeakLimiter::TruePeakLimiter(int numChannels, double sampleRate, const Settings& settings)
+    : channels(juce::jmax(1, numChannels)),
+      window(juce::jmax(1, juce::roundToInt(settings.lookaheadMs * 0.001 * sampleRate))),
+      latency(window - 1 + TruePeakDetector::delaySamples),
+      ceilingLinear(juce::Decibels::decibelsToGain(settings.ceilingDb)),
+      releaseCoefficient(static_cast<float>(std::exp(-1.0 / juce::jmax(1.0, settings.releaseMs * 0.001 * sampleRate)))),
+      detector(channels)
+{
+    delayLine.setSize(channels, latency + maxBlockSize);
+    peaks.resize(maxBlockSize);
+    gains.resize(maxBlockSize);
+    holdPositions.resize(static_cast<size_t>(window) + 1);
+    holdGains.resize(static_cast<size_t>(window) + 1);
+    averageHistory.resize(static_cast<size_t>(window));
+
+    reset();
+}
+
+void TruePeakLimiter::reset()
+{
+    detector.reset();
+    delayLine.clear();
+    holdHead = 0;
+    holdSize = 0;
+    position = 0;
+    releasedGain = 1.0f;
+    std::fill(averageHistory.begin(), averageHistory.end(), 1.0f);
+    averageIndex = 0;
+    averageSum = static_cast<double>(window);
+}
+
+//==============================================================================
+void TruePeakLimiter::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = juce::jmin(channels, buffer.getNumChannels());
+
+    while (numSamples > 0)
+    {
+        const int blockSize = juce::jmin(numSamples, maxBlockSize);
+
+        detector.process(buffer, startSample, blockSize, peaks.data());
+        computeGains(blockSize);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* delayed = delayLine.getWritePointer(ch);
+            auto* audio = buffer.getWritePointer(ch, startSample);
+
+            // Append the block to the delay line, emit its oldest samples at the new gain, keep the rest
+            juce::FloatVectorOperations::copy(delayed + latency, audio, blockSize);
+            juce::FloatVectorOperations::multiply(audio, delayed, gains.data(), blockSize);
+            std::memmove(delayed, delayed + blockSize, sizeof(float) * static_cast<size_t>(latency));
+        }
+
+        startSample += blockSize;
+        numSamples -= blockSize;
+    }
+}
+
+void TruePeakLimiter::computeGains(int numSamples)
+{
+    // Below the ceiling the required gain is 1; above it, whatever brings the peak down to it
+    juce::FloatVectorOperations::max(peaks.data(), peaks.data(), ceilingLinear, numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float required = ceilingLinear / peaks[static_cast<size_t>(i)];
+        const float held = holdMinimum(required);
+
+        // Down at once, back up slowly
+        releasedGain = held < releasedGain ? held : held + releaseCoefficient * (releasedGain - held);
+
+        averageSum += releasedGain - averageHistory[static_cast<size_t>(averageIndex)];
+        averageHistory[static_cast<size_t>(averageIndex)] = releasedGain;
+        averageIndex = (averageIndex + 1) % window;
+
+        gains[static_cast<size_t>(i)] = juce::jmin(1.0f, static_cast<float>(averageSum / window));
+    }
+}
+
+float TruePeakLimiter::holdMinimum(float requiredGain)
+{
+    const int capacity = static_cast<int>(holdGains.size());
+
+    // Anything not below the new value can never be the minimum again
+    while (holdSize > 0)
+    {
+        const int last = (holdHead + holdSize - 1) % capacity;
+        if (holdGains[static_cast<size_t>(last)] < requiredGain)
+            break;
+        --holdSize;
+    }
+
+    const int slot = (holdHead + holdSize) % capacity;
+    holdPositions[static_cast<size_t>(slot)] = position;
+    holdGains[static_cast<size_t>(slot)] = requiredGain;
+    ++holdSize;
+
+    // Drop what has slid out of the window
+    while (holdPositions[static_cast<size_t>(holdHead)] <= position - window)
+    {
+        holdHead = (holdHead + 1) % capacity;
+        --holdSize;
+    }
+
+    ++position;
+    return holdGains[static_cast<size_t>(holdHead)];
+}
+
+//==============================================================================
+void TruePeakLimiter::processBuffer(juce::AudioBuffer<float>& buffer, double sampleRate, const Settings& settings)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    TruePeakLimiter limiter(numChannels, sampleRate, settings);
+    const int latency = limiter.getLatencySamples();
+
+    // Run latency samples of silence through after the audio, then drop the first latency outputs
+    juce::AudioBuffer<float> extended(numChannels, numSamples + latency);
+    for (int ch = 0; ch < numChannels; ++ch)
+        extended.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    extended.clear(numSamples, latency);
+
+    limiter.process(extended, 0, extended.getNumSamples());
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        buffer.copyFrom(ch, 0, extended, ch, latency, numSamples);
+}
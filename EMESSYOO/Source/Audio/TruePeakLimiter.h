@@ -0,0 +1,83 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TruePeakDetector.h"
+#include <vector>
+
+//==============================================================================
+/**
+ * Lookahead brickwall limiter that holds inter-sample (true) peaks below a ceiling.
+ *
+ * Peaks are measured by a TruePeakDetector, so overs that only appear
+ * between samples are caught as well. The gain needed for
+ * each sample is held across the lookahead window, released exponentially
+ * and then smoothed with a moving average as long as the window, so it has
+ * reached its target by the time the peak leaves the delay line and never
+ * moves abruptly.
+ *
+ * Audio is processed in blocks with the filtering, peak search and gain
+ * application done by FloatVectorOperations; only the gain envelope runs per
+ * sample. An instance is independent of any other, so batch workers can each
+ * run their own.
+ */
+class TruePeakLimiter
+{
+public:
+    //==============================================================================
+    struct Settings
+    {
+        float ceilingDb = -1.0f;      // dBTP
+        float lookaheadMs = 1.5f;
+        float releaseMs = 60.0f;
+    };
+
+    TruePeakLimiter(int numChannels, double sampleRate, const Settings& settings);
+
+    /** Samples the output lags the input by. */
+    int getLatencySamples() const { return latency; }
+
+    /** Limit numSamples of buffer in place, starting at startSample; output is delayed by the latency. */
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    void reset();
+
+    /**
+     * Limit a whole buffer in place with the latency compensated, so every
+     * sample stays where it was (loop points remain valid).
+     */
+    static void processBuffer(juce::AudioBuffer<float>& buffer, double sampleRate, const Settings& settings);
+
+private:
+    //==============================================================================
+    static constexpr int maxBlockSize = TruePeakDetector::maxBlockSize;
+
+    int channels;
+    int window;                    // lookahead, in samples
+    int latency;
+    float ceilingLinear;
+    float releaseCoefficient;
+
+    TruePeakDetector detector;
+    juce::AudioBuffer<float> delayLine;        // per channel: latency samples of history, then the block
+    std::vector<float> peaks;
+    std::vector<float> gains;
+
+    // Sliding minimum of the required gain over the window, as a monotonic ring of (position, gain)
+    std::vector<int64> holdPositions;
+    std::vector<float> holdGains;
+    int holdHead = 0;
+    int holdSize = 0;
+    int64 position = 0;
+
+    float releasedGain = 1.0f;
+
+    // Moving average of the released gain over the window
+    std::vector<float> averageHistory;
+    int averageIndex = 0;
+    double averageSum = 0.0;
+
+    void computeGains(int numSamples);
+    float holdMinimum(float requiredGain);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakLimiter)
+};
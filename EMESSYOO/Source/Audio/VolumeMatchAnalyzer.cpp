@@ -146,7 +146,8 @@ bool VolumeMatchAnalyzer::analyzePCMFile(const juce::File& file,
         return false;
     }
 
-    stats = NormalizationAnalyzer::analyzeBuffer(buffer);
+    // Matching only compares RMS and sample peak
+    stats = NormalizationAnalyzer::analyzeLevels(buffer);
     return true;
 }
 
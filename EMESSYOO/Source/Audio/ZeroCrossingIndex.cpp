@@ -0,0 +1,201 @@
+#include "ZeroCrossingIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // Samples scanned between shouldExit polls
+    constexpr int exitCheckInterval = 1 << 16;
+
+    float sampleAt(const juce::AudioBuffer<float>& buffer, int channel, int64 position)
+    {
+        if (position < 0 || position >= buffer.getNumSamples())
+            return 0.0f;
+        return buffer.getSample(channel, static_cast<int>(position));
+    }
+
+    bool isBefore(const ZeroCrossingIndex::Crossing& crossing, int64 position)
+    {
+        return static_cast<int64>(crossing.position) < position;
+    }
+}
+
+//==============================================================================
+ZeroCrossingIndex::Ptr ZeroCrossingIndex::build(const juce::AudioBuffer<float>& buffer,
+                                                uint32 version,
+                                                const std::function<bool()>& shouldExit)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels <= 0 || numSamples <= 1)
+        return nullptr;
+
+    std::shared_ptr<ZeroCrossingIndex> index(new ZeroCrossingIndex());
+    index->version = version;
+    index->channelCrossings.resize(static_cast<size_t>(numChannels));
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (!findCrossings(buffer.getReadPointer(ch), numSamples, index->channelCrossings[static_cast<size_t>(ch)], shouldExit))
+            return nullptr;
+    }
+
+    // Joint crossings: walk channel 0 and advance a cursor through each other channel
+    const auto& reference = index->channelCrossings[0];
+    std::vector<size_t> cursors(static_cast<size_t>(numChannels), 0);
+    index->jointCrossings.reserve(reference.size() / 4);
+
+    for (const auto& crossing : reference)
+    {
+        const int64 position = crossing.position;
+        bool allChannelsCross = true;
+
+        for (int ch = 1; ch < numChannels && allChannelsCross; ++ch)
+        {
+            const auto& other = index->channelCrossings[static_cast<size_t>(ch)];
+            auto& cursor = cursors[static_cast<size_t>(ch)];
+            while (cursor < other.size() && static_cast<int64>(other[cursor].position) < position - jointTolerance)
+                ++cursor;
+
+            allChannelsCross = cursor < other.size()
+                && static_cast<int64>(other[cursor].position) <= position + jointTolerance;
+        }
+
+        if (allChannelsCross)
+            index->jointCrossings.push_back(crossing);
+    }
+
+    return index;
+}
+
+bool ZeroCrossingIndex::findCrossings(const float* samples, int numSamples, std::vector<Crossing>& crossings,
+                                      const std::function<bool()>& shouldExit)
+{
+    int side = 0;        // -1 below -hysteresis, +1 above, 0 not yet known
+    int lastOutside = 0; // last sample outside the dead zone
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (shouldExit && (i % exitCheckInterval) == 0 && shouldExit())
+            return false;
+
+        const float value = samples[i];
+        const int newSide = value > hysteresis ? 1 : (value < -hysteresis ? -1 : 0);
+        if (newSide == 0)
+            continue;
+
+        if (side != 0 && newSide != side)
+        {
+            // Edit at the sample nearest zero between the two sides
+            int best = i;
+            for (int j = lastOutside + 1; j < i; ++j)
+            {
+                if (std::abs(samples[j]) < std::abs(samples[best]))
+                    best = j;
+            }
+
+            crossings.push_back({ static_cast<uint32>(best) });
+        }
+
+        side = newSide;
+        lastOutside = i;
+    }
+
+    return true;
+}
+
+//==============================================================================
+int64 ZeroCrossingIndex::findSnapPosition(const juce::AudioBuffer<float>& buffer,
+                                          int64 target,
+                                          int64 searchStart,
+                                          int64 searchEnd,
+                                          Marker marker,
+                                          int64 otherMarker) const
+{
+    if (searchEnd < searchStart)
+        return -1;
+
+    const double window = static_cast<double>(juce::jmax<int64>(1, searchEnd - searchStart));
+    int64 bestPosition = -1;
+    float bestScore = std::numeric_limits<float>::max();
+
+    auto searchList = [&](const std::vector<Crossing>& crossings)
+    {
+        // Walk outwards from the target so the cap drops the furthest candidates
+        auto right = std::lower_bound(crossings.begin(), crossings.end(), target, isBefore);
+        auto left = right;
+        int inspected = 0;
+
+        auto inspect = [&](const Crossing& crossing)
+        {
+            const int64 position = crossing.position;
+            const float distancePenalty = distanceWeight
+                * static_cast<float>(std::abs(static_cast<double>(position - target)) / window);
+            const float score = scoreCandidate(buffer, position, marker, otherMarker) + distancePenalty;
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                bestPosition = position;
+            }
+            ++inspected;
+        };
+
+        bool rightOpen = true;
+        bool leftOpen = true;
+        while ((rightOpen || leftOpen) && inspected < maxCandidates)
+        {
+            rightOpen = right != crossings.end() && static_cast<int64>(right->position) <= searchEnd;
+            if (rightOpen)
+                inspect(*right++);
+
+            leftOpen = left != crossings.begin() && static_cast<int64>(std::prev(left)->position) >= searchStart;
+            if (leftOpen)
+                inspect(*--left);
+        }
+    };
+
+    searchList(jointCrossings);
+
+    if (bestPosition < 0)
+    {
+        for (const auto& crossings : channelCrossings)
+            searchList(crossings);
+    }
+
+    return bestPosition;
+}
+
+float ZeroCrossingIndex::scoreCandidate(const juce::AudioBuffer<float>& buffer, int64 position,
+                                        Marker marker, int64 otherMarker) const
+{
+    if (marker == Marker::LoopStart && otherMarker > position)
+        return getSpliceCost(buffer, position, otherMarker);
+
+    if (marker == Marker::LoopEnd && otherMarker >= 0 && otherMarker < position)
+        return getSpliceCost(buffer, otherMarker, position);
+
+    // No usable partner: prefer the quietest edit point
+    float cost = 0.0f;
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        cost += std::abs(sampleAt(buffer, ch, position));
+    return cost;
+}
+
+float ZeroCrossingIndex::getSpliceCost(const juce::AudioBuffer<float>& buffer, int64 loopStart, int64 loopEnd)
+{
+    float cost = 0.0f;
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const float startValue = sampleAt(buffer, ch, loopStart);
+        const float startSlope = startValue - sampleAt(buffer, ch, loopStart - 1);
+        const float endValue = sampleAt(buffer, ch, loopEnd);
+        const float endSlope = endValue - sampleAt(buffer, ch, loopEnd - 1);
+
+        cost += std::abs(startValue - endValue) + std::abs(startSlope - endSlope);
+    }
+
+    return cost;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * Sorted zero crossings of an audio buffer, per channel and for all channels
+ * together, for snapping loop and trim markers to clean edit points.
+ *
+ * Crossings use a small hysteresis so dither in near-silence does not flood
+ * the index. Lookups binary-search the sorted positions, so finding the
+ * candidates near a marker costs O(log n) plus the handful inspected, which
+ * keeps snapping live while dragging.
+ */
+class ZeroCrossingIndex
+{
+public:
+    //==============================================================================
+    struct Crossing
+    {
+        uint32 position = 0;  // first sample on the new side of zero
+    };
+
+    enum class Marker
+    {
+        LoopStart,  // scored as the jump from the loop end into this position
+        LoopEnd,    // scored as the jump from this position back to the loop start
+        Trim        // scored by how close to silence the first sample is
+    };
+
+    using Ptr = std::shared_ptr<const ZeroCrossingIndex>;
+
+    //==============================================================================
+    /**
+     * Build the index for a buffer.
+     * @param buffer Source audio
+     * @param version Caller's identifier for the audio content, stored with the result
+     * @param shouldExit Polled while scanning; returning true abandons the build
+     * @return the index, or nullptr if abandoned or the buffer is empty
+     */
+    static Ptr build(const juce::AudioBuffer<float>& buffer,
+                     uint32 version,
+                     const std::function<bool()>& shouldExit = {});
+
+    uint32 getVersion() const { return version; }
+    int getNumChannels() const { return static_cast<int>(channelCrossings.size()); }
+    const std::vector<Crossing>& getCrossings(int channel) const { return channelCrossings[static_cast<size_t>(channel)]; }
+
+    /** Positions where every channel crosses within jointTolerance samples. */
+    const std::vector<Crossing>& getJointCrossings() const { return jointCrossings; }
+
+    //==============================================================================
+    /**
+     * Find the best crossing to snap a marker to.
+     *
+     * Joint crossings in [searchStart, searchEnd] are tried first, then
+     * per-channel ones. Each candidate is scored by the discontinuity it
+     * would create against the other marker (value and slope mismatch summed
+     * over channels) plus a small penalty for distance from the target.
+     *
+     * @param buffer The audio the index was built from
+     * @param target Where the marker would land without snapping
+     * @param searchStart First sample to consider
+     * @param searchEnd Last sample to consider
+     * @param marker Which marker is being placed
+     * @param otherMarker Loop end when placing the start and vice versa; ignored for Trim
+     * @return the snapped position, or -1 if there is no crossing in range
+     */
+    int64 findSnapPosition(const juce::AudioBuffer<float>& buffer,
+                           int64 target,
+                           int64 searchStart,
+                           int64 searchEnd,
+                           Marker marker,
+                           int64 otherMarker) const;
+
+    /**
+     * Discontinuity of looping from loopEnd back to loopStart: how far the
+     * sample at loopStart and the slope into it differ from what would have
+     * followed loopEnd - 1. Zero is a seamless splice.
+     */
+    static float getSpliceCost(const juce::AudioBuffer<float>& buffer, int64 loopStart, int64 loopEnd);
+
+    //==============================================================================
+    static constexpr float hysteresis = 1.0e-4f;  // about -80 dBFS
+    static constexpr int64 jointTolerance = 4;
+    static constexpr int maxCandidates = 256;
+    static constexpr float distanceWeight = 0.05f;
+
+private:
+    ZeroCrossingIndex() = default;
+
+    uint32 version = 0;
+    std::vector<std::vector<Crossing>> channelCrossings;
+    std::vector<Crossing> jointCrossings;
+
+    static bool findCrossings(const float* samples, int numSamples, std::vector<Crossing>& crossings,
+                              const std::function<bool()>& shouldExit);
+    float scoreCandidate(const juce::AudioBuffer<float>& buffer, int64 position, Marker marker, int64 otherMarker) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ZeroCrossingIndex)
+};
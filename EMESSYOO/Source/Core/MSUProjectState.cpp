@@ -21,28 +21,45 @@ MSUProjectState::~MSUProjectState()
 //==============================================================================
 void MSUProjectState::setAudioBuffer(const juce::AudioBuffer<float>& newBuffer, double sampleRate)
 {
-    audioBuffer = newBuffer;
+    // A fresh buffer, so snapshots of the old audio stay valid
+    audioBuffer = std::make_shared<juce::AudioBuffer<float>>(newBuffer);
     projectSampleRate = sampleRate;
+    ++audioVersion;
+    modified = true;
+    sendChangeMessage();
+}
+
+juce::AudioBuffer<float>& MSUProjectState::editAudioBuffer()
+{
+    if (audioBuffer.use_count() > 1)
+        audioBuffer = std::make_shared<juce::AudioBuffer<float>>(*audioBuffer);
+
+    return *audioBuffer;
+}
+
+void MSUProjectState::notifyAudioContentChanged()
+{
+    ++audioVersion;
     modified = true;
     sendChangeMessage();
 }
 
 double MSUProjectState::getLengthInSeconds() const
 {
-    if (projectSampleRate <= 0.0 || audioBuffer.getNumSamples() <= 0)
+    if (projectSampleRate <= 0.0 || audioBuffer->getNumSamples() <= 0)
         return 0.0;
     
-    return audioBuffer.getNumSamples() / projectSampleRate;
+    return audioBuffer->getNumSamples() / projectSampleRate;
 }
 
 //==============================================================================
 void MSUProjectState::setLoopStart(int64 samplePosition)
 {
-    loopStartSample = juce::jlimit<int64>(0, audioBuffer.getNumSamples() - 1, samplePosition);
+    loopStartSample = juce::jlimit<int64>(0, audioBuffer->getNumSamples() - 1, samplePosition);
     
     // Ensure loop end is after loop start
     if (loopEndSample >= 0 && loopEndSample <= loopStartSample)
-        loopEndSample = juce::jmin<int64>(loopStartSample + 1, audioBuffer.getNumSamples());
+        loopEndSample = juce::jmin<int64>(loopStartSample + 1, audioBuffer->getNumSamples());
     
     modified = true;
     sendChangeMessage();
@@ -50,14 +67,14 @@ void MSUProjectState::setLoopStart(int64 samplePosition)
 
 void MSUProjectState::setTrimStart(int64 samplePosition)
 {
-    trimStartSample = juce::jlimit<int64>(0, audioBuffer.getNumSamples(), samplePosition);
+    trimStartSample = juce::jlimit<int64>(0, audioBuffer->getNumSamples(), samplePosition);
     modified = true;
     sendChangeMessage();
 }
 
 void MSUProjectState::setLoopEnd(int64 samplePosition)
 {
-    loopEndSample = juce::jlimit<int64>(0, audioBuffer.getNumSamples(), samplePosition);
+    loopEndSample = juce::jlimit<int64>(0, audioBuffer->getNumSamples(), samplePosition);
     
     // Ensure loop start is before loop end
     if (loopStartSample >= 0 && loopStartSample >= loopEndSample)
@@ -71,6 +88,7 @@ void MSUProjectState::setLoopEnd(int64 samplePosition)
 void MSUProjectState::setSourceFile(const juce::File& file)
 {
     sourceFile = file;
+    sourceFileAudioVersion = audioVersion;
     sendChangeMessage();
 }
 
@@ -83,8 +101,9 @@ void MSUProjectState::setModified(bool isModified)
 //==============================================================================
 void MSUProjectState::reset()
 {
-    audioBuffer.setSize(0, 0);
+    audioBuffer = std::make_shared<juce::AudioBuffer<float>>();
     projectSampleRate = 44100.0;
+    ++audioVersion;
     loopStartSample = -1;
     loopEndSample = -1;
     trimStartSample = 0;
@@ -95,6 +114,7 @@ void MSUProjectState::reset()
     modified = false;
     targetRMSDb = -12.0f;
     normalizationGainDb = 0.0f;
+    exportLimiterCeilingDb = std::numeric_limits<float>::quiet_NaN();
     
     sendChangeMessage();
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <cmath>
+#include <limits>
+#include <memory>
 
 //==============================================================================
 /**
@@ -17,13 +20,24 @@ public:
     //==============================================================================
     // Audio data management
     void setAudioBuffer(const juce::AudioBuffer<float>& newBuffer, double sampleRate);
-    const juce::AudioBuffer<float>& getAudioBuffer() const { return audioBuffer; }
-    juce::AudioBuffer<float>& getAudioBuffer() { return audioBuffer; }
+    const juce::AudioBuffer<float>& getAudioBuffer() const { return *audioBuffer; }
     double getSampleRate() const { return projectSampleRate; }
-    int getNumChannels() const { return audioBuffer.getNumChannels(); }
-    int getNumSamples() const { return audioBuffer.getNumSamples(); }
+    int getNumChannels() const { return audioBuffer->getNumChannels(); }
+    int getNumSamples() const { return audioBuffer->getNumSamples(); }
     double getLengthInSeconds() const;
     
+    // The current audio, shared rather than copied; it never changes, edits replace it instead.
+    // Hand this to anything that reads the audio off the message thread or after it may change
+    std::shared_ptr<const juce::AudioBuffer<float>> getAudioSnapshot() const { return audioBuffer; }
+    
+    // Bumped whenever the audio content changes, so anything derived from it can detect staleness
+    uint32 getAudioVersion() const { return audioVersion; }
+    
+    // For editing in place; copies the audio first if a snapshot still shares it.
+    // Call notifyAudioContentChanged() when done
+    juce::AudioBuffer<float>& editAudioBuffer();
+    void notifyAudioContentChanged();
+    
     //==============================================================================
     // Loop point management
     void setLoopStart(int64 samplePosition);
@@ -55,17 +69,21 @@ public:
     
     //==============================================================================
     // File information
+    // Call straight after setAudioBuffer() with the file the buffer was decoded from
     void setSourceFile(const juce::File& file);
     juce::File getSourceFile() const { return sourceFile; }
     juce::String getSourceFileName() const { return sourceFile.getFileName(); }
     
+    // True while the audio buffer is still exactly what was decoded from the source file
+    bool isAudioFromSourceFile() const { return sourceFile.existsAsFile() && sourceFileAudioVersion == audioVersion; }
+    
     void setTargetExportFile(const juce::File& file) { targetExportFile = file; }
     juce::File getTargetExportFile() const { return targetExportFile; }
     bool hasTargetExportFile() const { return targetExportFile != juce::File(); }
     
     //==============================================================================
     // Project state
-    bool hasAudio() const { return audioBuffer.getNumSamples() > 0; }
+    bool hasAudio() const { return audioBuffer->getNumSamples() > 0; }
     bool isModified() const { return modified; }
     void setModified(bool isModified);
     
@@ -75,6 +93,11 @@ public:
     float getTargetRMS() const { return targetRMSDb; }
     void setNormalizationGain(float gainDb) { normalizationGainDb = gainDb; }
     float getNormalizationGain() const { return normalizationGainDb; }
+
+    /** True-peak ceiling for the export limiter that follows the normalization gain; NaN for none. */
+    void setExportLimiterCeiling(float ceilingDb) { exportLimiterCeilingDb = ceilingDb; }
+    float getExportLimiterCeiling() const { return exportLimiterCeilingDb; }
+    bool hasExportLimiter() const { return std::isfinite(exportLimiterCeilingDb); }
     
     //==============================================================================
     // Reset project
@@ -82,8 +105,9 @@ public:
     
 private:
     //==============================================================================
-    juce::AudioBuffer<float> audioBuffer;
+    std::shared_ptr<juce::AudioBuffer<float>> audioBuffer = std::make_shared<juce::AudioBuffer<float>>();
     double projectSampleRate = 44100.0;
+    uint32 audioVersion = 0;
     
     int64 loopStartSample = -1;
     int64 loopEndSample = -1;
@@ -92,11 +116,13 @@ private:
     int padAmountMs = 200;      // Desired pad length in milliseconds
     
     juce::File sourceFile;
+    uint32 sourceFileAudioVersion = 0;
     juce::File targetExportFile;  // Track file to replace when exporting
     bool modified = false;
     
     float targetRMSDb = -12.0f;
     float normalizationGainDb = 0.0f;
+    float exportLimiterCeilingDb = std::numeric_limits<float>::quiet_NaN();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MSUProjectState)
 };
@@ -0,0 +1,106 @@
+#include "ROMDatabase.h"
+
+//==============================================================================
+int ROMDatabase::loadDirectory(const juce::File& directory)
+{
+    const int before = getNumEntries();
+
+    for (const auto& datFile : directory.findChildFiles(juce::File::findFiles, false, "*.dat;*.xml"))
+    {
+        if (!loadDatFile(datFile))
+            DBG("ROMDatabase: could not read " + datFile.getFullPathName());
+    }
+
+    return getNumEntries() - before;
+}
+
+bool ROMDatabase::loadDatFile(const juce::File& datFile)
+{
+    auto xml = juce::parseXML(datFile);
+    if (xml == nullptr || !xml->hasTagName("datafile"))
+        return false;
+
+    for (auto* game : xml->getChildWithTagNameIterator("game"))
+    {
+        const auto gameName = game->getStringAttribute("name");
+
+        for (auto* rom : game->getChildWithTagNameIterator("rom"))
+        {
+            auto entry = describeGameName(gameName);
+            entry.sha1 = rom->getStringAttribute("sha1").toLowerCase();
+
+            const auto crc32 = rom->getStringAttribute("crc").toLowerCase().paddedLeft('0', 8);
+            if (entry.sha1.isNotEmpty())
+                bySha1[entry.sha1] = entry;
+            byCrc32.emplace(crc32, std::move(entry));
+        }
+    }
+
+    return true;
+}
+
+std::optional<ROMDatabase::Entry> ROMDatabase::find(const SNESROMReader::ROMHashes& hashes) const
+{
+    const auto bySha = bySha1.find(hashes.sha1.toLowerCase());
+    if (bySha != bySha1.end())
+        return bySha->second;
+
+    // CRC32 alone is trusted only where the DAT had nothing stronger to offer
+    const auto range = byCrc32.equal_range(hashes.crc32.toLowerCase());
+    for (auto it = range.first; it != range.second; ++it)
+        if (it->second.sha1.isEmpty())
+            return it->second;
+
+    return std::nullopt;
+}
+
+//==============================================================================
+ROMDatabase::Entry ROMDatabase::describeGameName(const juce::String& name)
+{
+    Entry entry;
+    entry.name = name;
+
+    const int firstGroup = name.indexOf(" (");
+    entry.title = (firstGroup >= 0 ? name.substring(0, firstGroup) : name).trim();
+
+    // Parenthesised groups follow the title: region first, then languages, revision and the like
+    for (int start = name.indexOfChar('('); start >= 0; start = name.indexOfChar(start + 1, '('))
+    {
+        const int end = name.indexOfChar(start, ')');
+        if (end < 0)
+            break;
+
+        const auto group = name.substring(start + 1, end).trim();
+        if (entry.region.isEmpty())
+            entry.region = group;
+        else if (group.startsWith("Rev ") || (group.startsWithChar('v') && group.substring(1).containsOnly("0123456789.")))
+            entry.revision = group;
+    }
+
+    return entry;
+}
+
+juce::File ROMDatabase::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("MSU1PrepStudio")
+        .getChildFile("ROM Database");
+}
+
+std::shared_ptr<const ROMDatabase> ROMDatabase::getShared()
+{
+    static juce::CriticalSection lock;
+    static std::shared_ptr<const ROMDatabase> shared;
+
+    const juce::ScopedLock sl(lock);
+    if (shared == nullptr)
+    {
+        auto database = std::make_shared<ROMDatabase>();
+        const int loaded = database->loadDirectory(getDefaultDirectory());
+        juce::ignoreUnused(loaded);
+        DBG("ROMDatabase: " + juce::String(loaded) + " ROMs from " + getDefaultDirectory().getFullPathName());
+        shared = std::move(database);
+    }
+
+    return shared;
+}
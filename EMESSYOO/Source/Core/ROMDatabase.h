@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include "SNESROMReader.h"
+
+//==============================================================================
+/**
+ * Offline lookup of ROM dumps by hash, to tell which release and revision an
+ * MSU-1 pack's ROM is.
+ *
+ * Entries come from No-Intro style XML DAT files placed in the database
+ * folder; nothing is fetched over the network. Each game's name carries its
+ * title, region and revision, e.g. "Super Metroid (Japan, USA) (En,Ja)" or
+ * "Super Mario World (USA) (Rev 1)".
+ */
+class ROMDatabase
+{
+public:
+    //==============================================================================
+    struct Entry
+    {
+        juce::String name;                  // full name as the DAT lists it
+        juce::String title;
+        juce::String region;
+        juce::String revision;              // empty for the first release
+        juce::String sha1;                  // empty when the DAT only lists CRC32
+    };
+
+    /** Load every DAT (*.dat, *.xml) in directory; returns the number of ROMs added. */
+    int loadDirectory(const juce::File& directory);
+    bool loadDatFile(const juce::File& datFile);
+
+    /** Match on SHA-1, or on CRC32 for entries the DAT gives no SHA-1 for. */
+    std::optional<Entry> find(const SNESROMReader::ROMHashes& hashes) const;
+
+    int getNumEntries() const { return static_cast<int>(byCrc32.size()); }
+
+    /** Split a DAT game name into title, region and revision. */
+    static Entry describeGameName(const juce::String& name);
+
+    static juce::File getDefaultDirectory();
+
+    /** The database from the default folder, loaded on first use from whichever thread asks. */
+    static std::shared_ptr<const ROMDatabase> getShared();
+
+private:
+    //==============================================================================
+    std::map<juce::String, Entry> bySha1;
+    std::multimap<juce::String, Entry> byCrc32;
+};
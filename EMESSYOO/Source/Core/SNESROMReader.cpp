@@ -1,4 +1,10 @@
 #include "SNESROMReader.h"
+#include "StreamingHash.h"
+
+namespace
+{
+    constexpr int hashChunkSize = 256 * 1024;
+}
 
 //==============================================================================
 SNESROMReader::SNESROMReader()
@@ -24,113 +30,104 @@ bool SNESROMReader::loadROMFile(const juce::File& romFile)
     if (fileSize < 0x20000 || fileSize > 0x1000000) // Min 128KB, Max 16MB
         return false;
     
-    // Read ROM file into memory
     juce::FileInputStream stream(romFile);
     if (!stream.openedOk())
         return false;
     
-    juce::MemoryBlock romData;
+    // Offsets below are into the ROM image, after the SMC header if present
+    hasSMCHeader = detectSMCHeader(fileSize);
+    const int64 romSize = fileSize - (hasSMCHeader ? smcHeaderSize : 0);
     
-    try
-    {
-        stream.readIntoMemoryBlock(romData);
-    }
-    catch (...)
-    {
-        return false;
-    }
+    // Score each possible header location (LoROM, HiROM, ExLoROM, or ExHiROM); the first best wins
+    const HeaderOffset candidates[] = { HeaderOffset::LoROM, HeaderOffset::HiROM,
+                                        HeaderOffset::ExLoROM, HeaderOffset::ExHiROM };
+    HeaderBytes bestHeader {};
+    int bestScore = -1;
+    headerOffset = -1;
     
-    if (romData.getSize() < 0x20000 || romData.getData() == nullptr)
-        return false;
-    
-    // Detect and skip SMC header if present
-    hasSMCHeader = detectSMCHeader(romData);
-    if (hasSMCHeader && romData.getSize() > 512)
+    for (auto candidate : candidates)
     {
-        // Remove 512-byte header by creating new block
-        try
-        {
-            juce::MemoryBlock temp;
-            temp.append(static_cast<const uint8_t*>(romData.getData()) + 512, romData.getSize() - 512);
-            romData = temp;
-        }
-        catch (...)
+        HeaderBytes header {};
+        const int offset = static_cast<int>(candidate);
+        const int score = readHeader(stream, romSize, offset, header) ? calculateMapModeScore(header) : 0;
+        
+        if (score > bestScore)
         {
-            return false;
+            bestScore = score;
+            bestHeader = header;
+            headerOffset = offset;
         }
     }
     
-    // Validate data pointer after potential modification
-    if (romData.getData() == nullptr || romData.getSize() < 0x10000)
+    if (headerOffset < 0 || headerOffset >= romSize)
         return false;
     
-    // Find the ROM header offset (LoROM, HiROM, ExLoROM, or ExHiROM)
-    headerOffset = findHeaderOffset(romData);
+    // Extract title and region
+    gameTitle = extractTitle(bestHeader);
+    region = getRegionFromCountryCode(bestHeader[static_cast<size_t>(HeaderValue::Country)]);
     
-    if (headerOffset < 0 || headerOffset >= romData.getSize())
-        return false;
+    loaded = true;
+    return true;
+}
+
+std::optional<SNESROMReader::ROMHashes> SNESROMReader::hashROMFile(const juce::File& romFile,
+                                                                   const std::function<bool()>& shouldCancel)
+{
+    juce::FileInputStream stream(romFile);
+    if (!stream.openedOk())
+        return std::nullopt;
     
-    // Extract title and region
-    gameTitle = extractTitle(romData, headerOffset);
+    const int64 fileSize = stream.getTotalLength();
+    if (detectSMCHeader(fileSize) && !stream.setPosition(smcHeaderSize))
+        return std::nullopt;
+    
+    CRC32Hasher crc;
+    SHA1Hasher sha1;
+    juce::HeapBlock<uint8_t> chunk(hashChunkSize);
+    int64 hashed = 0;
     
-    // Get country code
-    if (headerOffset + static_cast<int>(HeaderValue::Country) < romData.getSize())
+    while (!stream.isExhausted())
     {
-        uint8_t countryCode = static_cast<const uint8_t*>(romData.getData())[headerOffset + static_cast<int>(HeaderValue::Country)];
-        region = getRegionFromCountryCode(countryCode);
+        if (shouldCancel != nullptr && shouldCancel())
+            return std::nullopt;
+        
+        const int bytesRead = stream.read(chunk.get(), hashChunkSize);
+        if (bytesRead < 0)
+            return std::nullopt;
+        if (bytesRead == 0)
+            break;
+        
+        crc.update(chunk.get(), static_cast<size_t>(bytesRead));
+        sha1.update(chunk.get(), static_cast<size_t>(bytesRead));
+        hashed += bytesRead;
     }
     
-    loaded = true;
-    return true;
+    ROMHashes hashes;
+    hashes.crc32 = crc.toHexString();
+    hashes.sha1 = sha1.toHexString();
+    hashes.romSize = hashed;
+    return hashes;
 }
 
 //==============================================================================
-bool SNESROMReader::detectSMCHeader(const juce::MemoryBlock& romData)
+bool SNESROMReader::detectSMCHeader(int64 fileSize)
 {
     // SMC header is 512 bytes, check if file size is N*1024 + 512
-    auto size = romData.getSize();
-    return (size % 1024) == 512;
+    return (fileSize % 1024) == 512;
 }
 
-int SNESROMReader::findHeaderOffset(const juce::MemoryBlock& romData)
+bool SNESROMReader::readHeader(juce::FileInputStream& stream, int64 romSize, int offset, HeaderBytes& header)
 {
-    // Calculate map mode scores for each possible header location
-    int scoreLoROM = calculateMapModeScore(romData, static_cast<int>(HeaderOffset::LoROM));
-    int scoreHiROM = calculateMapModeScore(romData, static_cast<int>(HeaderOffset::HiROM));
-    int scoreExLoROM = calculateMapModeScore(romData, static_cast<int>(HeaderOffset::ExLoROM));
-    int scoreExHiROM = calculateMapModeScore(romData, static_cast<int>(HeaderOffset::ExHiROM));
-    
-    // Find the best match
-    int bestScore = scoreLoROM;
-    int bestOffset = static_cast<int>(HeaderOffset::LoROM);
-    
-    if (scoreHiROM > bestScore)
-    {
-        bestScore = scoreHiROM;
-        bestOffset = static_cast<int>(HeaderOffset::HiROM);
-    }
-    
-    if (scoreExLoROM > bestScore)
-    {
-        bestScore = scoreExLoROM;
-        bestOffset = static_cast<int>(HeaderOffset::ExLoROM);
-    }
-    
-    if (scoreExHiROM > bestScore)
-    {
-        bestScore = scoreExHiROM;
-        bestOffset = static_cast<int>(HeaderOffset::ExHiROM);
-    }
+    if (offset < 0 || offset + headerSize > romSize)
+        return false;
     
-    return bestOffset;
+    const int64 position = offset + (hasSMCHeader ? smcHeaderSize : 0);
+    return stream.setPosition(position) && stream.read(header.data(), headerSize) == headerSize;
 }
 
-int SNESROMReader::calculateMapModeScore(const juce::MemoryBlock& romData, int offset)
+int SNESROMReader::calculateMapModeScore(const HeaderBytes& header)
 {
-    if (offset < 0 || offset + 80 > romData.getSize())
-        return 0;
-    
-    const uint8_t* data = static_cast<const uint8_t*>(romData.getData()) + offset;
+    const uint8_t* data = header.data();
     int score = 0;
     
     // Check map mode byte
@@ -182,13 +179,9 @@ int SNESROMReader::calculateMapModeScore(const juce::MemoryBlock& romData, int o
     return score;
 }
 
-juce::String SNESROMReader::extractTitle(const juce::MemoryBlock& romData, int offset)
+juce::String SNESROMReader::extractTitle(const HeaderBytes& header)
 {
-    if (offset < 0 || offset + static_cast<int>(HeaderValue::Title) + 21 > romData.getSize())
-        return "Unknown";
-    
-    const uint8_t* data = static_cast<const uint8_t*>(romData.getData()) + offset;
-    const uint8_t* titleData = data + static_cast<int>(HeaderValue::Title);
+    const uint8_t* titleData = header.data() + static_cast<int>(HeaderValue::Title);
     
     // Title is 21 bytes, but often padded with spaces or nulls
     char titleBuffer[22] = {0};
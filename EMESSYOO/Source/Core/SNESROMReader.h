@@ -1,11 +1,17 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+#include <functional>
+#include <optional>
 
 //==============================================================================
 /**
  * Reader for SNES ROM files (.sfc, .smc) to extract metadata.
  * Based on the SNES ROM header format specification.
+ *
+ * Only the candidate header locations are read, with positioned reads of a
+ * few dozen bytes each, so probing a ROM costs the same whatever its size.
  */
 class SNESROMReader
 {
@@ -15,7 +21,7 @@ public:
     ~SNESROMReader();
     
     //==============================================================================
-    /** Load and parse a SNES ROM file */
+    /** Probe a SNES ROM file's header */
     bool loadROMFile(const juce::File& romFile);
     
     /** Get the game title from the ROM header */
@@ -27,6 +33,24 @@ public:
     /** Check if ROM data was loaded successfully */
     bool isLoaded() const { return loaded; }
     
+    //==============================================================================
+    struct ROMHashes
+    {
+        juce::String crc32;                 // lowercase hex, as ROM DATs list them
+        juce::String sha1;
+        int64 romSize = 0;                  // bytes hashed, excluding any SMC header
+    };
+    
+    /**
+     * Hash the ROM image in one streaming pass, leaving out any SMC copier
+     * header so the hashes match No-Intro style databases.
+     * Reads the whole file, so call it off the message thread.
+     * @param shouldCancel Polled between chunks; hashing stops when it returns true
+     * @return The hashes, or nothing if the file couldn't be read or hashing was cancelled
+     */
+    static std::optional<ROMHashes> hashROMFile(const juce::File& romFile,
+                                                const std::function<bool()>& shouldCancel = nullptr);
+    
 private:
     //==============================================================================
     enum class HeaderOffset : int
@@ -51,6 +75,10 @@ private:
         Checksum = 0x2E
     };
     
+    static constexpr int headerSize = 0x50;       // from the header offset to the end of the bank
+    static constexpr int smcHeaderSize = 512;
+    using HeaderBytes = std::array<uint8_t, headerSize>;
+    
     //==============================================================================
     bool loaded = false;
     juce::String gameTitle;
@@ -59,10 +87,10 @@ private:
     bool hasSMCHeader = false;
     
     //==============================================================================
-    bool detectSMCHeader(const juce::MemoryBlock& romData);
-    int findHeaderOffset(const juce::MemoryBlock& romData);
-    int calculateMapModeScore(const juce::MemoryBlock& romData, int offset);
-    juce::String extractTitle(const juce::MemoryBlock& romData, int offset);
+    static bool detectSMCHeader(int64 fileSize);
+    bool readHeader(juce::FileInputStream& stream, int64 romSize, int offset, HeaderBytes& header);
+    int calculateMapModeScore(const HeaderBytes& header);
+    juce::String extractTitle(const HeaderBytes& header);
     juce::String getRegionFromCountryCode(uint8_t countryCode);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SNESROMReader)
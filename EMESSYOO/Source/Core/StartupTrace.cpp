@@ -0,0 +1,63 @@
+#include "StartupTrace.h"
+#include <chrono>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Initialised with the rest of the static data, before main() runs
+    const Clock::time_point processStart = Clock::now();
+
+    std::vector<StartupTrace::Milestone>& milestones()
+    {
+        static std::vector<StartupTrace::Milestone> list;
+        return list;
+    }
+}
+
+//==============================================================================
+void StartupTrace::mark(const juce::String& name)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& list = milestones();
+    for (const auto& milestone : list)
+    {
+        if (milestone.name == name)
+            return;
+    }
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - processStart).count();
+    list.push_back({ name, elapsedMs });
+    DBG("Startup: " + name + " at " + juce::String(elapsedMs, 1) + " ms");
+}
+
+std::vector<StartupTrace::Milestone> StartupTrace::getMilestones()
+{
+    return milestones();
+}
+
+double StartupTrace::getMilliseconds(const juce::String& name)
+{
+    for (const auto& milestone : milestones())
+    {
+        if (milestone.name == name)
+            return milestone.milliseconds;
+    }
+
+    return -1.0;
+}
+
+juce::var StartupTrace::toVar()
+{
+    juce::Array<juce::var> list;
+    for (const auto& milestone : milestones())
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("name", milestone.name);
+        object->setProperty("ms", milestone.milliseconds);
+        list.add(juce::var(object));
+    }
+
+    return list;
+}
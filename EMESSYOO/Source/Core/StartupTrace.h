@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+ * Timeline of cold-start milestones, measured from when the executable's
+ * static data was initialised.
+ *
+ * Milestones are marked on the message thread as the app comes up (window
+ * shown, first paint, audio device open, tabs built on first use) and show
+ * up in the audio diagnostics report so launch time can be compared across
+ * builds and machines.
+ */
+class StartupTrace
+{
+public:
+    //==============================================================================
+    struct Milestone
+    {
+        juce::String name;
+        double milliseconds = 0.0;  // since process start
+    };
+
+    /** Record a milestone; repeated names keep their first time. Message thread only. */
+    static void mark(const juce::String& name);
+
+    static std::vector<Milestone> getMilestones();
+
+    /** Milliseconds from process start to the named milestone, or -1 if not reached. */
+    static double getMilliseconds(const juce::String& name);
+
+    /** Milestones as a JSON array of { name, ms } objects. */
+    static juce::var toVar();
+
+private:
+    StartupTrace() = delete;
+};
@@ -0,0 +1,172 @@
+#include "StreamingHash.h"
+#include <cstring>
+
+namespace
+{
+    struct CRC32Tables
+    {
+        uint32 table[8][256];
+
+        CRC32Tables()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                uint32 crc = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+                table[0][i] = crc;
+            }
+
+            // table[k][i] is the CRC of byte i followed by k zero bytes
+            for (uint32 i = 0; i < 256; ++i)
+                for (int k = 1; k < 8; ++k)
+                    table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFFu];
+        }
+    };
+
+    const CRC32Tables& getCRC32Tables()
+    {
+        static const CRC32Tables tables;
+        return tables;
+    }
+
+    inline uint32 rotateLeft(uint32 value, int bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    inline uint32 readBigEndian(const uint8_t* data)
+    {
+        return (static_cast<uint32>(data[0]) << 24) | (static_cast<uint32>(data[1]) << 16)
+             | (static_cast<uint32>(data[2]) << 8) | static_cast<uint32>(data[3]);
+    }
+}
+
+//==============================================================================
+void CRC32Hasher::update(const void* data, size_t numBytes)
+{
+    const auto& t = getCRC32Tables().table;
+    auto* bytes = static_cast<const uint8_t*>(data);
+    uint32 crc = state;
+
+    while (numBytes >= 8)
+    {
+        const uint32 low = crc ^ (static_cast<uint32>(bytes[0]) | (static_cast<uint32>(bytes[1]) << 8)
+                                | (static_cast<uint32>(bytes[2]) << 16) | (static_cast<uint32>(bytes[3]) << 24));
+        crc = t[7][low & 0xFFu] ^ t[6][(low >> 8) & 0xFFu] ^ t[5][(low >> 16) & 0xFFu] ^ t[4][low >> 24]
+            ^ t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+        bytes += 8;
+        numBytes -= 8;
+    }
+
+    while (numBytes-- > 0)
+        crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFFu];
+
+    state = crc;
+}
+
+juce::String CRC32Hasher::toHexString() const
+{
+    return juce::String::toHexString(static_cast<int>(getValue())).paddedLeft('0', 8);
+}
+
+//==============================================================================
+SHA1Hasher::SHA1Hasher()
+    : h { 0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u }
+{
+}
+
+void SHA1Hasher::update(const void* data, size_t numBytes)
+{
+    jassert(!finished);
+    auto* bytes = static_cast<const uint8_t*>(data);
+    totalBytes += numBytes;
+
+    // Top up a partial block first, then hash whole blocks straight from the input
+    if (blockFill > 0)
+    {
+        const size_t take = juce::jmin(numBytes, block.size() - blockFill);
+        std::memcpy(block.data() + blockFill, bytes, take);
+        blockFill += take;
+        bytes += take;
+        numBytes -= take;
+
+        if (blockFill < block.size())
+            return;
+
+        processBlock(block.data());
+        blockFill = 0;
+    }
+
+    for (; numBytes >= block.size(); bytes += block.size(), numBytes -= block.size())
+        processBlock(bytes);
+
+    std::memcpy(block.data(), bytes, numBytes);
+    blockFill = numBytes;
+}
+
+std::array<uint8_t, 20> SHA1Hasher::finish()
+{
+    if (!finished)
+    {
+        const uint64 bitLength = totalBytes * 8;
+        const uint8_t one = 0x80;
+        const uint8_t zero = 0;
+
+        update(&one, 1);
+        while (blockFill != 56)
+            update(&zero, 1);
+
+        uint8_t lengthBytes[8];
+        for (int i = 0; i < 8; ++i)
+            lengthBytes[i] = static_cast<uint8_t>(bitLength >> (56 - 8 * i));
+        update(lengthBytes, sizeof(lengthBytes));
+
+        finished = true;
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (size_t i = 0; i < h.size(); ++i)
+        for (size_t b = 0; b < 4; ++b)
+            digest[i * 4 + b] = static_cast<uint8_t>(h[i] >> (24 - 8 * b));
+    return digest;
+}
+
+juce::String SHA1Hasher::toHexString()
+{
+    const auto digest = finish();
+    return juce::String::toHexString(digest.data(), static_cast<int>(digest.size()), 0);
+}
+
+void SHA1Hasher::processBlock(const uint8_t* data)
+{
+    uint32 w[80];
+    for (int i = 0; i < 16; ++i)
+        w[i] = readBigEndian(data + i * 4);
+    for (int i = 16; i < 80; ++i)
+        w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32 a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+
+    for (int i = 0; i < 80; ++i)
+    {
+        uint32 f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);           k = 0x5A827999u; }
+        else if (i < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1u; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDCu; }
+        else             { f = b ^ c ^ d;                    k = 0xCA62C1D6u; }
+
+        const uint32 temp = rotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
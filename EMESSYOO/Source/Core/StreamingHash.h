@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/**
+ * CRC-32 (IEEE 802.3, as used by zip and ROM DATs), fed incrementally.
+ *
+ * Uses slicing-by-8 tables, so the inner loop handles eight bytes per step
+ * with independent lookups rather than one byte at a time.
+ */
+class CRC32Hasher
+{
+public:
+    void update(const void* data, size_t numBytes);
+    uint32 getValue() const { return ~state; }
+
+    /** Eight lowercase hex digits. */
+    juce::String toHexString() const;
+
+private:
+    uint32 state = 0xFFFFFFFFu;
+};
+
+//==============================================================================
+/**
+ * SHA-1, fed incrementally. JUCE only provides MD5 and SHA-256, and ROM
+ * databases identify dumps by SHA-1.
+ */
+class SHA1Hasher
+{
+public:
+    SHA1Hasher();
+
+    void update(const void* data, size_t numBytes);
+
+    /** Pads and finishes the digest; no more data may be added afterwards. */
+    std::array<uint8_t, 20> finish();
+
+    /** Forty lowercase hex digits; finishes the digest. */
+    juce::String toHexString();
+
+private:
+    std::array<uint32, 5> h;
+    std::array<uint8_t, 64> block;
+    size_t blockFill = 0;
+    uint64 totalBytes = 0;
+    bool finished = false;
+
+    void processBlock(const uint8_t* data);
+};
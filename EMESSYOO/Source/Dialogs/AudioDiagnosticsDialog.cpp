@@ -0,0 +1,272 @@
+#include "AudioDiagnosticsDialog.h"
+#include "../Core/StartupTrace.h"
+
+namespace
+{
+    juce::String formatPercent(double load)
+    {
+        return juce::String(load * 100.0, 1) + "%";
+    }
+
+    const juce::Colour histogramColours[] = {
+        juce::Colour(0xff4caf50),
+        juce::Colour(0xff42a5f5),
+        juce::Colour(0xffffa726),
+        juce::Colour(0xffab47bc)
+    };
+}
+
+AudioDiagnosticsDialog::AudioDiagnosticsDialog(std::vector<AudioCallbackMonitor*> monitorsToShow,
+                                               juce::AudioDeviceManager& manager)
+    : monitors(std::move(monitorsToShow)),
+      deviceManager(manager)
+{
+    addAndMakeVisible(headingLabel);
+    headingLabel.setText("Audio Diagnostics", juce::dontSendNotification);
+    headingLabel.setFont(juce::FontOptions(20.0f, juce::Font::bold));
+    headingLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+
+    addAndMakeVisible(deviceLabel);
+    deviceLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    deviceLabel.setJustificationType(juce::Justification::centredLeft);
+
+    addAndMakeVisible(summaryText);
+    summaryText.setMultiLine(true);
+    summaryText.setReadOnly(true);
+    summaryText.setCaretVisible(false);
+    summaryText.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+
+    addAndMakeVisible(resetButton);
+    resetButton.onClick = [this]
+    {
+        for (auto* monitor : monitors)
+            monitor->reset();
+        refresh();
+    };
+
+    addAndMakeVisible(copyButton);
+    copyButton.onClick = [this]
+    {
+        juce::SystemClipboard::copyTextToClipboard(createReport());
+    };
+
+    addAndMakeVisible(saveButton);
+    saveButton.onClick = [this] { saveReport(); };
+
+    addAndMakeVisible(closeButton);
+    closeButton.onClick = [this] { closeParentDialog(); };
+
+    refresh();
+    startTimer(refreshIntervalMs);
+}
+
+AudioDiagnosticsDialog::~AudioDiagnosticsDialog()
+{
+    stopTimer();
+}
+
+void AudioDiagnosticsDialog::resized()
+{
+    auto bounds = getLocalBounds().reduced(16);
+    headingLabel.setBounds(bounds.removeFromTop(34));
+    deviceLabel.setBounds(bounds.removeFromTop(24));
+    bounds.removeFromTop(8);
+
+    auto buttonRow = bounds.removeFromBottom(36);
+    const int spacing = 12;
+    const int buttonWidth = juce::jmax(110, (buttonRow.getWidth() - 3 * spacing) / 4);
+    resetButton.setBounds(buttonRow.removeFromLeft(buttonWidth));
+    buttonRow.removeFromLeft(spacing);
+    copyButton.setBounds(buttonRow.removeFromLeft(buttonWidth));
+    buttonRow.removeFromLeft(spacing);
+    saveButton.setBounds(buttonRow.removeFromLeft(buttonWidth));
+    buttonRow.removeFromLeft(spacing);
+    closeButton.setBounds(buttonRow.removeFromLeft(buttonWidth));
+
+    bounds.removeFromBottom(12);
+    histogramArea = bounds.removeFromBottom(juce::jmax(120, bounds.getHeight() / 3));
+    bounds.removeFromBottom(8);
+    summaryText.setBounds(bounds);
+}
+
+void AudioDiagnosticsDialog::paint(juce::Graphics& g)
+{
+    g.fillAll(findColour(juce::ResizableWindow::backgroundColourId));
+
+    if (histogramArea.isEmpty())
+        return;
+
+    g.setColour(juce::Colours::black.withAlpha(0.35f));
+    g.fillRect(histogramArea);
+
+    auto plot = histogramArea.reduced(8).toFloat();
+    auto legend = plot.removeFromTop(18.0f);
+    auto axis = plot.removeFromBottom(16.0f);
+
+    // Budget line at 100% load
+    const float budgetX = plot.getX() + plot.getWidth()
+        * static_cast<float>(1.0 / (AudioCallbackMonitor::numHistogramBuckets * AudioCallbackMonitor::histogramBucketWidth));
+    g.setColour(juce::Colours::red.withAlpha(0.7f));
+    g.drawVerticalLine(juce::roundToInt(budgetX), plot.getY(), plot.getBottom());
+
+    g.setFont(12.0f);
+    g.setColour(juce::Colours::lightgrey);
+    g.drawText("0%", axis.removeFromLeft(40.0f), juce::Justification::centredLeft);
+    g.drawText("100% of buffer", juce::Rectangle<float>(budgetX - 50.0f, axis.getY(), 100.0f, axis.getHeight()),
+               juce::Justification::centred);
+    g.drawText(">= 195%", axis.removeFromRight(60.0f), juce::Justification::centredRight);
+
+    const int numMonitors = static_cast<int>(snapshots.size());
+    const float bucketWidth = plot.getWidth() / static_cast<float>(AudioCallbackMonitor::numHistogramBuckets);
+    const float barWidth = juce::jmax(1.0f, (bucketWidth - 2.0f) / juce::jmax(1, numMonitors));
+
+    for (int m = 0; m < numMonitors; ++m)
+    {
+        const auto& snapshot = snapshots[static_cast<size_t>(m)];
+        const auto colour = histogramColours[m % juce::numElementsInArray(histogramColours)];
+
+        g.setColour(colour);
+        g.drawText(snapshot.name, legend.removeFromLeft(190.0f), juce::Justification::centredLeft);
+
+        int64 peak = 0;
+        for (auto count : snapshot.histogram)
+            peak = juce::jmax(peak, count);
+        if (peak == 0)
+            continue;
+
+        for (size_t bucket = 0; bucket < snapshot.histogram.size(); ++bucket)
+        {
+            const auto count = snapshot.histogram[bucket];
+            if (count == 0)
+                continue;
+
+            // Log scale keeps rare slow callbacks visible next to the common case
+            const float height = plot.getHeight()
+                * static_cast<float>(std::log1p(static_cast<double>(count)) / std::log1p(static_cast<double>(peak)));
+            const float x = plot.getX() + bucketWidth * static_cast<float>(bucket) + 1.0f + barWidth * static_cast<float>(m);
+            g.fillRect(x, plot.getBottom() - height, barWidth, height);
+        }
+    }
+}
+
+juce::String AudioDiagnosticsDialog::createReport() const
+{
+    std::vector<const AudioCallbackMonitor*> constMonitors(monitors.begin(), monitors.end());
+    auto report = juce::JSON::parse(AudioCallbackMonitor::createJSONReport(constMonitors, &deviceManager));
+    if (auto* root = report.getDynamicObject())
+        root->setProperty("startup", StartupTrace::toVar());
+
+    return juce::JSON::toString(report);
+}
+
+void AudioDiagnosticsDialog::timerCallback()
+{
+    refresh();
+}
+
+void AudioDiagnosticsDialog::refresh()
+{
+    snapshots.clear();
+    for (auto* monitor : monitors)
+        snapshots.push_back(monitor->getSnapshot());
+
+    juce::String deviceText = "No audio device open";
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        const double rate = device->getCurrentSampleRate();
+        const int bufferSize = device->getCurrentBufferSizeSamples();
+        deviceText = device->getName() + " - " + juce::String(rate, 0) + " Hz, "
+            + juce::String(bufferSize) + " samples ("
+            + juce::String(rate > 0.0 ? bufferSize * 1000.0 / rate : 0.0, 2) + " ms budget)";
+
+        const int deviceXRuns = device->getXRunCount();
+        if (deviceXRuns >= 0)
+            deviceText << ", device xruns: " << deviceXRuns;
+        deviceText << ", CPU " << formatPercent(deviceManager.getCpuUsage());
+    }
+    deviceLabel.setText(deviceText, juce::dontSendNotification);
+
+    juce::String text;
+    text << juce::String("Player").paddedRight(' ', 26)
+         << juce::String("Calls").paddedLeft(' ', 10)
+         << juce::String("Avg").paddedLeft(' ', 9)
+         << juce::String("p50").paddedLeft(' ', 9)
+         << juce::String("p90").paddedLeft(' ', 9)
+         << juce::String("p99").paddedLeft(' ', 9)
+         << juce::String("Max").paddedLeft(' ', 9)
+         << juce::String("Overruns").paddedLeft(' ', 10)
+         << juce::String("Late").paddedLeft(' ', 8) << "\n";
+
+    for (const auto& snapshot : snapshots)
+    {
+        text << snapshot.name.paddedRight(' ', 26)
+             << juce::String(snapshot.callbacks).paddedLeft(' ', 10)
+             << formatPercent(snapshot.averageLoad).paddedLeft(' ', 9)
+             << formatPercent(snapshot.p50Load).paddedLeft(' ', 9)
+             << formatPercent(snapshot.p90Load).paddedLeft(' ', 9)
+             << formatPercent(snapshot.p99Load).paddedLeft(' ', 9)
+             << formatPercent(snapshot.maxLoad).paddedLeft(' ', 9)
+             << juce::String(snapshot.overruns).paddedLeft(' ', 10)
+             << juce::String(snapshot.lateCallbacks).paddedLeft(' ', 8) << "\n";
+    }
+
+    text << "\n";
+    for (const auto& snapshot : snapshots)
+    {
+        text << snapshot.name << ": callback avg " << juce::String(snapshot.averageCallbackMs, 3)
+             << " ms, max " << juce::String(snapshot.maxCallbackMs, 3)
+             << " ms; lock wait total " << juce::String(snapshot.totalLockWaitMs, 3)
+             << " ms, max " << juce::String(snapshot.maxLockWaitMs, 3) << " ms\n";
+    }
+
+    const auto milestones = StartupTrace::getMilestones();
+    if (!milestones.empty())
+    {
+        text << "\nStartup:";
+        for (const auto& milestone : milestones)
+            text << "  " << milestone.name << " " << juce::String(milestone.milliseconds, 0) << " ms;";
+        text << "\n";
+    }
+
+    text << "\nLoad is callback time as a share of the buffer budget (block size / sample rate).\n"
+         << "Late callbacks started more than 1.5 budgets after the previous one.";
+
+    summaryText.setText(text, juce::dontSendNotification);
+    repaint(histogramArea);
+}
+
+void AudioDiagnosticsDialog::saveReport()
+{
+    fileChooser = std::make_unique<juce::FileChooser>(
+        "Save audio diagnostics",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+            .getChildFile("msu1prep-audio-diagnostics.json"),
+        "*.json");
+
+    const auto report = createReport();
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode
+                                 | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [report](const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+        if (file.getFullPathName().isEmpty())
+            return;
+
+        if (!file.replaceWithText(report))
+        {
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::MessageBoxIconType::WarningIcon,
+                "Save Failed",
+                "Could not write diagnostics to:\n" + file.getFullPathName());
+        }
+    });
+}
+
+void AudioDiagnosticsDialog::closeParentDialog()
+{
+    if (auto* window = findParentComponentOfClass<juce::DialogWindow>())
+    {
+        window->exitModalState(0);
+        window->setVisible(false);
+    }
+}
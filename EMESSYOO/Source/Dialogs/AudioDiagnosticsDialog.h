@@ -0,0 +1,47 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../Audio/AudioCallbackMonitor.h"
+
+/**
+ * Live view of the audio callback monitors: per-player load percentiles,
+ * overruns, late callbacks and lock waits, with a load histogram and a JSON
+ * export for comparing buffer sizes or catching regressions.
+ */
+class AudioDiagnosticsDialog : public juce::Component,
+                               private juce::Timer
+{
+public:
+    AudioDiagnosticsDialog(std::vector<AudioCallbackMonitor*> monitorsToShow,
+                           juce::AudioDeviceManager& manager);
+    ~AudioDiagnosticsDialog() override;
+
+    void resized() override;
+    void paint(juce::Graphics& g) override;
+
+    /** JSON report for all monitors and the current device. */
+    juce::String createReport() const;
+
+private:
+    std::vector<AudioCallbackMonitor*> monitors;
+    std::vector<AudioCallbackMonitor::Snapshot> snapshots;
+    juce::AudioDeviceManager& deviceManager;
+
+    juce::Label headingLabel;
+    juce::Label deviceLabel;
+    juce::TextEditor summaryText;
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton copyButton { "Copy JSON" };
+    juce::TextButton saveButton { "Save JSON..." };
+    juce::TextButton closeButton { "Close" };
+    juce::Rectangle<int> histogramArea;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    void timerCallback() override;
+    void refresh();
+    void saveReport();
+    void closeParentDialog();
+
+    static constexpr int refreshIntervalMs = 250;
+};
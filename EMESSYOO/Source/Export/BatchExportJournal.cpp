@@ -0,0 +1,262 @@
+#include "BatchExportJournal.h"
+
+namespace
+{
+    constexpr const char* journalFileName = "batch_export_journal.jsonl";
+    constexpr const char* eventKey = "event";
+    constexpr const char* batchKey = "batch";
+    constexpr const char* timestampKey = "timestamp";
+    constexpr const char* settingsKey = "settings";
+    constexpr const char* planKey = "plan";
+    constexpr const char* fileKey = "file";
+    constexpr const char* gainKey = "gainDb";
+    constexpr const char* sizeKey = "size";
+    constexpr const char* modifiedKey = "modified";
+    constexpr const char* hashKey = "sha256";
+    constexpr const char* backupKey = "backup";
+    constexpr const char* errorKey = "error";
+
+    constexpr const char* beginEvent = "begin";
+    constexpr const char* resumeEvent = "resume";
+    constexpr const char* startedEvent = "started";
+    constexpr const char* doneEvent = "done";
+    constexpr const char* skippedEvent = "skipped";
+    constexpr const char* failedEvent = "failed";
+    constexpr const char* interruptedEvent = "interrupted";
+    constexpr const char* endEvent = "end";
+}
+
+//==============================================================================
+BatchExportJournal::BatchExportJournal(const juce::File& msuDirectory)
+    : journalFile(msuDirectory.getChildFile(journalFileName))
+{
+}
+
+std::map<juce::String, BatchExportJournal::CompletedTrack>
+BatchExportJournal::findResumableTracks(const juce::String& settingsSignature,
+                                        std::map<juce::String, StartedTrack>* unfinished) const
+{
+    std::map<juce::String, CompletedTrack> completed;
+    std::map<juce::String, StartedTrack> started;
+    juce::String lastBatch;
+    bool lastBatchMatches = false;
+
+    for (const auto& record : readRecords())
+    {
+        const auto event = record[eventKey].toString();
+        const auto batch = record[batchKey].toString();
+
+        if (event == beginEvent)
+        {
+            lastBatch = batch;
+            lastBatchMatches = record[settingsKey].toString() == settingsSignature;
+            completed.clear();
+            started.clear();
+        }
+        else if (batch != lastBatch)
+        {
+            continue;
+        }
+        else if (event == startedEvent)
+        {
+            StartedTrack track;
+            track.fileName = record[fileKey].toString();
+            track.originalSize = static_cast<int64>(record[sizeKey]);
+            track.originalModificationTime = juce::Time(static_cast<int64>(record[modifiedKey]));
+            track.backupPath = record[backupKey].toString();
+            completed.erase(track.fileName);
+            started[track.fileName] = track;
+        }
+        else if (event == doneEvent)
+        {
+            CompletedTrack track;
+            track.fileName = record[fileKey].toString();
+            track.gainDb = static_cast<float>(record[gainKey]);
+            track.outputSize = static_cast<int64>(record[sizeKey]);
+            track.outputModificationTime = juce::Time(static_cast<int64>(record[modifiedKey]));
+            track.outputHash = record[hashKey].toString();
+            track.backupPath = record[backupKey].toString();
+            started.erase(track.fileName);
+            completed[track.fileName] = track;
+        }
+        else if (event == skippedEvent)
+        {
+            // A failure leaves the started record standing: the original may already be in the backup
+            started.erase(record[fileKey].toString());
+        }
+        else if (event == endEvent)
+        {
+            completed.clear();
+            started.clear();
+            lastBatchMatches = false;
+        }
+    }
+
+    if (!lastBatchMatches)
+    {
+        completed.clear();
+        started.clear();
+    }
+
+    if (unfinished != nullptr)
+        *unfinished = std::move(started);
+
+    return completed;
+}
+
+bool BatchExportJournal::isStillCompleted(const CompletedTrack& track, const juce::File& file)
+{
+    // Size and timestamp rule most rewrites out cheaply; the hash catches one that kept both
+    return file.existsAsFile()
+        && file.getSize() == track.outputSize
+        && file.getLastModificationTime() == track.outputModificationTime
+        && (track.outputHash.isEmpty() || juce::SHA256(file).toHexString() == track.outputHash);
+}
+
+juce::File BatchExportJournal::findOriginalBackup(const StartedTrack& track)
+{
+    if (track.backupPath.isEmpty())
+        return {};
+
+    // Moving keeps the timestamp, so a backup matching the recorded original is that original;
+    // anything else there is an older backup the cut-off export never got to replace
+    const juce::File backup(track.backupPath);
+    if (backup.existsAsFile()
+        && backup.getSize() == track.originalSize
+        && backup.getLastModificationTime() == track.originalModificationTime)
+        return backup;
+
+    return {};
+}
+
+bool BatchExportJournal::beginBatch(const juce::String& settingsSignature, const juce::var& plan, bool resuming)
+{
+    if (resuming)
+    {
+        for (const auto& record : readRecords())
+            if (record[eventKey].toString() == beginEvent)
+                batchId = record[batchKey].toString();
+    }
+
+    if (!resuming || batchId.isEmpty())
+    {
+        resuming = false;
+        batchId = juce::Uuid().toDashedString();
+    }
+
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, resuming ? resumeEvent : beginEvent);
+    record->setProperty(settingsKey, settingsSignature);
+    record->setProperty(planKey, plan);
+    return append(record);
+}
+
+bool BatchExportJournal::recordTrackStarted(const juce::String& fileName, const juce::File& original, const juce::File& backupFile)
+{
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, startedEvent);
+    record->setProperty(fileKey, fileName);
+    record->setProperty(sizeKey, original.existsAsFile() ? original.getSize() : 0);
+    record->setProperty(modifiedKey, original.existsAsFile() ? original.getLastModificationTime().toMilliseconds() : 0);
+    record->setProperty(backupKey, backupFile != juce::File() ? backupFile.getFullPathName() : juce::String());
+    return append(record);
+}
+
+bool BatchExportJournal::recordTrackDone(const juce::File& outputFile, float gainDb, const juce::File& backupFile)
+{
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, doneEvent);
+    record->setProperty(fileKey, outputFile.getFileName());
+    record->setProperty(gainKey, gainDb);
+    record->setProperty(sizeKey, outputFile.getSize());
+    record->setProperty(modifiedKey, outputFile.getLastModificationTime().toMilliseconds());
+
+    // Hashing before the append is safe: the started record already covers a crash in between
+    record->setProperty(hashKey, juce::SHA256(outputFile).toHexString());
+    record->setProperty(backupKey, backupFile.existsAsFile() ? backupFile.getFullPathName() : juce::String());
+    return append(record);
+}
+
+bool BatchExportJournal::recordTrackSkipped(const juce::String& fileName)
+{
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, skippedEvent);
+    record->setProperty(fileKey, fileName);
+    return append(record);
+}
+
+bool BatchExportJournal::recordTrackFailed(const juce::String& fileName, const juce::String& error)
+{
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, failedEvent);
+    record->setProperty(fileKey, fileName);
+    record->setProperty(errorKey, error);
+    return append(record);
+}
+
+bool BatchExportJournal::endBatch(bool cancelled)
+{
+    // A cancelled batch stays open so the next export with the same settings resumes it
+    auto* record = new juce::DynamicObject();
+    record->setProperty(eventKey, cancelled ? interruptedEvent : endEvent);
+    return append(record);
+}
+
+//==============================================================================
+juce::Array<juce::var> BatchExportJournal::readRecords() const
+{
+    juce::Array<juce::var> records;
+    if (!journalFile.existsAsFile())
+        return records;
+
+    juce::StringArray lines;
+    journalFile.readLines(lines);
+
+    // A crash mid-write leaves a torn last line; it simply fails to parse
+    for (const auto& line : lines)
+    {
+        if (line.isEmpty())
+            continue;
+
+        auto parsed = juce::JSON::parse(line);
+        if (parsed.isObject())
+            records.add(parsed);
+    }
+
+    return records;
+}
+
+bool BatchExportJournal::append(juce::DynamicObject* record)
+{
+    juce::var recordVar(record);
+    record->setProperty(batchKey, batchId);
+    record->setProperty(timestampKey, juce::Time::getCurrentTime().toISO8601(true));
+
+    juce::FileOutputStream stream(journalFile);
+    if (stream.failedToOpen())
+    {
+        lastError = "Could not open export journal: " + journalFile.getFullPathName();
+        return false;
+    }
+
+    // Opened at the end of the file. Finish off a line torn by a crash so this record starts clean
+    juce::String text;
+    if (stream.getPosition() > 0)
+    {
+        juce::FileInputStream existing(journalFile);
+        if (existing.openedOk() && existing.setPosition(stream.getPosition() - 1) && existing.readByte() != '\n')
+            text << "\n";
+    }
+
+    text << juce::JSON::toString(recordVar, true) << "\n";
+    stream.writeText(text, false, false, nullptr);
+    stream.flush();
+    if (stream.getStatus().failed())
+    {
+        lastError = "Could not write export journal: " + stream.getStatus().getErrorMessage();
+        return false;
+    }
+
+    lastError.clear();
+    return true;
+}
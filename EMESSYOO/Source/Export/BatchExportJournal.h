@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+
+//==============================================================================
+/**
+ * Append-only record of batch exports, kept beside the PCM files.
+ *
+ * Every batch writes a begin record with its settings and plan, a started
+ * record before each track touches its file (the original's size and
+ * modification time, and where it will be backed up), a record as the track
+ * finishes (output size, modification time and SHA-256), and an end record. Each
+ * record is one JSON line, flushed to disk before the export goes on, so a
+ * crash loses at most the line being written.
+ *
+ * A batch with no end record was interrupted. Starting an export with the
+ * same settings resumes it: tracks it already finished, whose output is
+ * untouched since, are skipped rather than exported and backed up again, and
+ * a track cut off mid-export is redone from its backup without replacing it.
+ * The file also serves as an audit log of everything the batches wrote.
+ */
+class BatchExportJournal
+{
+public:
+    //==============================================================================
+    struct CompletedTrack
+    {
+        juce::String fileName;
+        float gainDb = 0.0f;
+        int64 outputSize = 0;
+        juce::Time outputModificationTime;
+        juce::String outputHash;                  // SHA-256 of the written PCM
+        juce::String backupPath;                  // empty when no backup was made
+    };
+
+    /** A track whose export started but never recorded finishing. */
+    struct StartedTrack
+    {
+        juce::String fileName;
+        int64 originalSize = 0;
+        juce::Time originalModificationTime;
+        juce::String backupPath;                  // empty when no backup was to be made
+    };
+
+    explicit BatchExportJournal(const juce::File& msuDirectory);
+
+    /**
+     * Tracks finished by an interrupted batch with these settings, by file name.
+     * Empty when the last batch ended or used different settings.
+     * @param unfinished If given, receives the tracks that batch was cut off exporting
+     */
+    std::map<juce::String, CompletedTrack> findResumableTracks(const juce::String& settingsSignature,
+                                                               std::map<juce::String, StartedTrack>* unfinished = nullptr) const;
+
+    /**
+     * True if findResumableTracks() would let file be skipped: it is still the output the batch wrote.
+     * Reads the whole file to check its hash when size and timestamp match.
+     */
+    static bool isStillCompleted(const CompletedTrack& track, const juce::File& file);
+
+    /**
+     * The backup holding an unfinished track's original, or an invalid File when the
+     * export was cut off before moving it there (the original is then still in place).
+     */
+    static juce::File findOriginalBackup(const StartedTrack& track);
+
+    /**
+     * Start a batch, or continue the interrupted one when resuming.
+     * @param plan Per-track details to record, e.g. planned gains
+     */
+    bool beginBatch(const juce::String& settingsSignature, const juce::var& plan, bool resuming);
+
+    /**
+     * Write-ahead record, appended before the export moves or rewrites anything.
+     * @param original   The file the track's audio is read from: the PCM itself, or its backup when redoing it
+     * @param backupFile Where the original is (or will be) backed up; invalid when backups are off
+     */
+    bool recordTrackStarted(const juce::String& fileName, const juce::File& original, const juce::File& backupFile);
+    bool recordTrackDone(const juce::File& outputFile, float gainDb, const juce::File& backupFile);
+    bool recordTrackSkipped(const juce::String& fileName);
+    bool recordTrackFailed(const juce::String& fileName, const juce::String& error);
+    bool endBatch(bool cancelled);
+
+    juce::File getFile() const { return journalFile; }
+    juce::String getLastError() const { return lastError; }
+
+private:
+    //==============================================================================
+    juce::File journalFile;
+    juce::String batchId;
+    juce::String lastError;
+
+    juce::Array<juce::var> readRecords() const;
+    bool append(juce::DynamicObject* record);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchExportJournal)
+};
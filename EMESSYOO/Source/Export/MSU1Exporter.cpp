@@ -142,6 +142,11 @@ void MSU1Exporter::setError(const juce::String& error)
     DBG("MSU1Exporter Error: " + error);
 }
 
+juce::File MSU1Exporter::getBackupFileFor(const juce::File& file)
+{
+    return file.getParentDirectory().getChildFile("Backup").getChildFile(file.getFileName());
+}
+
 bool MSU1Exporter::moveOriginalToBackupFolder(const juce::File& file)
 {
     if (!file.existsAsFile())
@@ -154,7 +159,8 @@ bool MSU1Exporter::moveOriginalToBackupFolder(const juce::File& file)
         return false;
     }
 
-    auto backupDir = parent.getChildFile("Backup");
+    auto destination = getBackupFileFor(file);
+    auto backupDir = destination.getParentDirectory();
     if (!backupDir.isDirectory())
     {
         if (!backupDir.createDirectory())
@@ -164,7 +170,6 @@ bool MSU1Exporter::moveOriginalToBackupFolder(const juce::File& file)
         }
     }
 
-    auto destination = backupDir.getChildFile(file.getFileName());
     if (destination.existsAsFile() && !destination.deleteFile())
     {
         setError("Could not replace existing backup: " + destination.getFullPathName());
@@ -53,6 +53,9 @@ public:
      * Get the last error message.
      */
     juce::String getLastError() const { return lastError; }
+
+    /** Where exportPCM(file, ..., true) moves the original file. */
+    static juce::File getBackupFileFor(const juce::File& file);
     
     //==============================================================================
     // MSU-1 format constants
@@ -1,5 +1,6 @@
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "Core/StartupTrace.h"
 
 //==============================================================================
 class MSU1PrepStudioApplication : public juce::JUCEApplication
@@ -16,6 +17,7 @@ public:
     void initialise(const juce::String& commandLine) override
     {
         juce::ignoreUnused(commandLine);
+        StartupTrace::mark("Application initialise");
 
         // Create main window
         mainWindow.reset(new MainWindow(getApplicationName()));
@@ -66,6 +68,7 @@ public:
 #endif
 
             setVisible(true);
+            StartupTrace::mark("Window visible");
         }
 
         void closeButtonPressed() override
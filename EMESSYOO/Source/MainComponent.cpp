@@ -1,6 +1,8 @@
 #include "MainComponent.h"
 #include "Audio/NormalizationAnalyzer.h"
+#include "Audio/TruePeakLimiter.h"
 #include "Core/BackupMetadataStore.h"
+#include "Core/StartupTrace.h"
 #include "Dialogs/BackupRestoreDialog.h"
 
 #include <cmath>
@@ -29,20 +31,17 @@ MainComponent::MainComponent()
         : toolbar(projectState),
             mainTabs(juce::TabbedButtonBar::TabsAtTop),
             waveformView(projectState),
+            spectrogramView(projectState, waveformView),
+            loopSuggestions(projectState),
             transportControls(projectState, audioPlayer),
-            loopEditorTab(waveformView, transportControls, msuFileBrowser, kBrowserHeight, kTransportHeight),
-            audioLevelStudio(projectState, beforeAfterPreviewPlayer)
+            loopEditorTab(waveformView, spectrogramView, loopSuggestions, transportControls, msuFileBrowser, kBrowserHeight, kTransportHeight)
 {
     // Set custom look and feel
     setLookAndFeel(&customLookAndFeel);
     settings = std::make_unique<juce::PropertiesFile>(createSettingsOptions());
     
-    // Initialize audio device with default settings (will match source when file is loaded)
-    audioDeviceManager.initialiseWithDefaultDevices(0, 2);
-    previewPlayer.setAudioDeviceManager(&audioDeviceManager);
-    audioDeviceManager.addAudioCallback(&audioPlayer);
-    audioDeviceManager.addAudioCallback(&previewPlayer);
-    audioDeviceManager.addAudioCallback(&beforeAfterPreviewPlayer);
+    // The audio device itself is opened after the first paint, see openAudioDevice()
+    previewPlayer.setPrefetchCache(&previewPrefetchCache);
     audioPlayer.setProjectState(&projectState);
     
     // Wire up toolbar callbacks
@@ -61,6 +60,30 @@ MainComponent::MainComponent()
         }
         audioPlayer.setPosition(targetSeconds);
     };
+
+    // Scrub audio while dragging the playhead or markers, unless playback is running
+    waveformView.onScrubStart = [this](int64 sample)
+    {
+        if (audioPlayer.isPlaying() || !projectState.hasAudio())
+            return;
+
+        scrubEngine.beginScrub(projectState.getAudioSnapshot(), projectState.getSampleRate(), sample);
+    };
+    waveformView.onScrubMove = [this](int64 sample)
+    {
+        if (scrubEngine.isScrubbing())
+            scrubEngine.setScrubTarget(sample);
+    };
+    waveformView.onScrubEnd = [this]
+    {
+        scrubEngine.endScrub();
+    };
+
+    // The spectrogram lane follows the waveform's zoom and scroll
+    waveformView.onVisibleRangeChanged = [this]
+    {
+        spectrogramView.repaint();
+    };
     
     // Add components
     addAndMakeVisible(toolbar);
@@ -68,10 +91,11 @@ MainComponent::MainComponent()
     addAndMakeVisible(mainTabs);
     mainTabs.setOutline(0);
     mainTabs.addTab("Loop Editor", juce::Colours::transparentBlack, &loopEditorTab, false);
-    mainTabs.addTab("Audio Level Studio", juce::Colours::transparentBlack, &audioLevelStudio, false);
+    mainTabs.addTab("Audio Level Studio", juce::Colours::transparentBlack, &audioLevelStudioTab, false);
     loopEditorTabIndex = 0;
     audioLevelStudioTabIndex = mainTabs.getNumTabs() - 1;
     lastMainTabIndex = mainTabs.getCurrentTabIndex();
+    mainTabs.getTabbedButtonBar().addChangeListener(this);
     
     // Configure status label
     statusLabel.setText("Ready", juce::dontSendNotification);
@@ -79,6 +103,7 @@ MainComponent::MainComponent()
     statusLabel.setJustificationType(juce::Justification::centredLeft);
     
     // Setup MSU file browser callback
+    msuFileBrowser.setAnalysisCache(trackAnalysisCache);
     msuFileBrowser.onReplaceTrack = [this](const MSUFileBrowser::TrackInfo& track) {
         handleReplaceTrack(track);
     };
@@ -91,55 +116,33 @@ MainComponent::MainComponent()
         handleStopPreview();
     };
 
+    msuFileBrowser.onPrefetchRequested = [this](const juce::Array<juce::File>& files)
+    {
+        previewPrefetchCache.prefetch(files);
+    };
+
     msuFileBrowser.onDirectoryChanged = [this](const juce::File& directory)
     {
         saveLastMSUDirectory(directory);
     };
 
+    // The studio reads the browser's tracks itself when it is built
     msuFileBrowser.onTracksLoaded = [this](const juce::File& msuFile,
                                             const juce::String& gameTitle,
                                             const std::vector<MSUFileBrowser::TrackInfo>& tracks)
     {
-        audioLevelStudio.setMSUContext(msuFile, gameTitle, tracks);
+        if (audioLevelStudio != nullptr)
+            audioLevelStudio->setMSUContext(msuFile, gameTitle, tracks);
     };
 
     msuFileBrowser.onTracksCleared = [this]()
     {
-        audioLevelStudio.clearMSUContext();
+        previewPrefetchCache.clear();
+        if (audioLevelStudio != nullptr)
+            audioLevelStudio->clearMSUContext();
     };
 
-    audioLevelStudio.setMSULoadCallback([this]
-    {
-        msuFileBrowser.launchLoadDialog();
-    });
-    audioLevelStudio.setBackupPreference(backupOriginalsEnabled);
-    audioLevelStudio.setTrackReplacementCallback([this](const MSUFileBrowser::TrackInfo& track)
-    {
-        handleReplaceTrack(track);
-    });
-
-    audioLevelStudio.setTrackListRefreshCallback([this]
-    {
-        refreshTrackListIfBackupsEnabled();
-    });
-
-    audioLevelStudio.setPlaybackStopper([this]
-    {
-        if (previewPlayer.isPlaying())
-            handleStopPreview();
-
-        if (audioPlayer.isPlaying())
-            audioPlayer.stop();
-    });
-
     loadPersistedDirectories();
-    if (msuFileBrowser.getCurrentMSUFile().existsAsFile() && !msuFileBrowser.getTracks().empty())
-    {
-        audioLevelStudio.setMSUContext(msuFileBrowser.getCurrentMSUFile(),
-                                       msuFileBrowser.getGameTitle(),
-                                       msuFileBrowser.getTracks());
-    }
-    audioLevelStudio.refreshFromProjectState();
     
     // Listen to project state changes
     projectState.addChangeListener(this);
@@ -147,16 +150,33 @@ MainComponent::MainComponent()
     // Enable keyboard input
     setWantsKeyboardFocus(true);
     
-    // Start timer for playback updates
-    startTimer(50);
+    // Playback-following updates, each run only while its component is on screen
+    frameScheduler.addClient(waveformView, [this](const PlaybackSnapshot& snapshot)
+    {
+        if (!projectState.hasAudio())
+            return;
+
+        waveformView.setAutoScrollEnabled(transportControls.isAutoScrollEnabled());
+        waveformView.setPlayPosition(snapshot.playerPosition);
+    });
+    frameScheduler.addClient(transportControls, [this](const PlaybackSnapshot& snapshot)
+    {
+        transportControls.updatePositionDisplay(snapshot.playerPosition);
+    });
+    frameScheduler.addClient(msuFileBrowser, [this](const PlaybackSnapshot& snapshot)
+    {
+        checkPreviewState(snapshot);
+    });
     
     // Set initial size large enough to keep every control visible
     setSize(getPreferredWindowWidth(), getPreferredWindowHeight());
+    StartupTrace::mark("MainComponent constructed");
 }
 
 MainComponent::~MainComponent()
 {
-    stopTimer();
+    mainTabs.getTabbedButtonBar().removeChangeListener(this);
+    audioDeviceManager.removeAudioCallback(&scrubEngine);
     audioDeviceManager.removeAudioCallback(&beforeAfterPreviewPlayer);
     audioDeviceManager.removeAudioCallback(&previewPlayer);
     audioDeviceManager.removeAudioCallback(&audioPlayer);
@@ -170,6 +190,86 @@ MainComponent::~MainComponent()
 void MainComponent::paint(juce::Graphics& g)
 {
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+
+    // The window is on screen: open the audio device now rather than holding up the first frame
+    if (!audioDeviceRequested)
+    {
+        audioDeviceRequested = true;
+        StartupTrace::mark("First paint");
+
+        juce::Component::SafePointer<MainComponent> safeThis(this);
+        juce::MessageManager::callAsync([safeThis]
+        {
+            if (safeThis != nullptr)
+                safeThis->openAudioDevice();
+        });
+    }
+}
+
+void MainComponent::openAudioDevice()
+{
+    // Default settings; the players resample to whatever rate the device runs at
+    audioDeviceManager.initialiseWithDefaultDevices(0, 2);
+    previewPlayer.setAudioDeviceManager(&audioDeviceManager);
+    audioDeviceManager.addAudioCallback(&audioPlayer);
+    audioDeviceManager.addAudioCallback(&previewPlayer);
+    audioDeviceManager.addAudioCallback(&beforeAfterPreviewPlayer);
+    audioDeviceManager.addAudioCallback(&scrubEngine);
+    StartupTrace::mark("Audio device open");
+}
+
+AudioLevelStudioComponent& MainComponent::createAudioLevelStudio()
+{
+    jassert(audioLevelStudio == nullptr);
+    audioLevelStudio = std::make_unique<AudioLevelStudioComponent>(projectState, beforeAfterPreviewPlayer);
+    auto& studio = *audioLevelStudio;
+
+    studio.setMSULoadCallback([this]
+    {
+        msuFileBrowser.launchLoadDialog();
+    });
+    studio.setBackupPreference(backupOriginalsEnabled);
+    studio.setAnalysisCache(trackAnalysisCache);
+    studio.setTrackReplacementCallback([this](const MSUFileBrowser::TrackInfo& track)
+    {
+        handleReplaceTrack(track);
+    });
+
+    studio.setTrackListRefreshCallback([this]
+    {
+        refreshTrackListIfBackupsEnabled();
+    });
+
+    studio.setPlaybackStopper([this]
+    {
+        if (previewPlayer.isPlaying())
+            handleStopPreview();
+
+        if (audioPlayer.isPlaying())
+            audioPlayer.stop();
+    });
+
+    if (msuFileBrowser.getCurrentMSUFile().existsAsFile() && !msuFileBrowser.getTracks().empty())
+    {
+        studio.setMSUContext(msuFileBrowser.getCurrentMSUFile(),
+                             msuFileBrowser.getGameTitle(),
+                             msuFileBrowser.getTracks());
+    }
+    studio.refreshFromProjectState();
+
+    frameScheduler.addClient(studio, [this](const PlaybackSnapshot& snapshot)
+    {
+        audioLevelStudio->updatePlaybackDisplay(snapshot);
+    });
+
+    StartupTrace::mark("Audio Level Studio built");
+    return studio;
+}
+
+AudioLevelStudioComponent& MainComponent::getAudioLevelStudio()
+{
+    audioLevelStudioTab.getOrCreateContent();
+    return *audioLevelStudio;
 }
 
 void MainComponent::resized()
@@ -201,19 +301,29 @@ void MainComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
     if (source == &projectState)
     {
-        audioLevelStudio.refreshFromProjectState();
+        if (audioLevelStudio != nullptr)
+            audioLevelStudio->refreshFromProjectState();
+        // Don't keep superseded audio alive for a scrub that has finished
+        scrubEngine.releaseIdleSource();
         // Update UI based on project state changes
         repaint();
+        
+        // Durations and the playhead mapping depend on the project, not just the snapshot
+        frameScheduler.requestFrame();
+    }
+    else if (source == &mainTabs.getTabbedButtonBar())
+    {
+        handleMainTabChanged();
     }
 }
 
-void MainComponent::timerCallback()
+void MainComponent::handleMainTabChanged()
 {
     const int currentTabIndex = mainTabs.getCurrentTabIndex();
     if (currentTabIndex != lastMainTabIndex)
     {
-        if (audioLevelStudioTabIndex >= 0 && lastMainTabIndex == audioLevelStudioTabIndex)
-            audioLevelStudio.stopPreviewPlayback();
+        if (audioLevelStudioTabIndex >= 0 && lastMainTabIndex == audioLevelStudioTabIndex && audioLevelStudio != nullptr)
+            audioLevelStudio->stopPreviewPlayback();
 
         if (loopEditorTabIndex >= 0 && lastMainTabIndex == loopEditorTabIndex)
         {
@@ -226,16 +336,6 @@ void MainComponent::timerCallback()
 
         lastMainTabIndex = currentTabIndex;
     }
-
-    // Update waveform with current playback position
-    if (projectState.hasAudio())
-    {
-        waveformView.setAutoScrollEnabled(transportControls.isAutoScrollEnabled());
-        waveformView.setPlayPosition(audioPlayer.getPosition());
-    }
-    
-    // Check preview playback state
-    checkPreviewState();
 }
 
 bool MainComponent::keyPressed(const juce::KeyPress& key)
@@ -254,6 +354,25 @@ bool MainComponent::keyPressed(const juce::KeyPress& key)
         return false;
     }
     
+    // R restarts the loop-seam audition from the top of the pre-roll
+    if ((key.getKeyCode() == 'R' || key.getKeyCode() == 'r') && !key.getModifiers().isAnyModifierKeyDown())
+    {
+        if (loopEditorTabIndex >= 0 && mainTabs.getCurrentTabIndex() == loopEditorTabIndex
+            && audioPlayer.isSeamAuditionEnabled())
+        {
+            audioPlayer.restartSeamAudition();
+            return true;
+        }
+        return false;
+    }
+    
+    // Ctrl/Cmd+Shift+D opens the audio callback diagnostics
+    if (key == juce::KeyPress('d', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0))
+    {
+        showAudioDiagnosticsDialog();
+        return true;
+    }
+    
     // Pass Z/X keys to waveform view for loop point hotkeys
     if (key.getKeyCode() == 'Z' || key.getKeyCode() == 'z' ||
         key.getKeyCode() == 'X' || key.getKeyCode() == 'x')
@@ -335,7 +454,8 @@ void MainComponent::openAudioFile()
                         else if (transportControls.isTrimNoPadEnabled())
                             transportControls.applyTrimNoPad();
 
-                        audioLevelStudio.refreshFromProjectState();
+                        if (audioLevelStudio != nullptr)
+                            audioLevelStudio->refreshFromProjectState();
                         
                         // Don't change device sample rate - let AudioPlayer handle resampling
                         DBG("Loaded audio at " + juce::String(originalSampleRate) + " Hz");
@@ -510,6 +630,13 @@ void MainComponent::beginManualExportFlow()
                     if (applyPresetGain && std::isfinite(exportGainDb) && std::abs(exportGainDb) > 0.01f)
                         NormalizationAnalyzer::applyGain(exportBuffer, exportGainDb);
 
+                    if (applyPresetGain && projectState.hasExportLimiter())
+                    {
+                        TruePeakLimiter::Settings limiterSettings;
+                        limiterSettings.ceilingDb = projectState.getExportLimiterCeiling();
+                        TruePeakLimiter::processBuffer(exportBuffer, AudioImporter::MSU1_SAMPLE_RATE, limiterSettings);
+                    }
+
                     MSU1Exporter exporter;
                     comp->updateStatus("Exporting to " + file.getFileName() + "...");
 
@@ -741,6 +868,13 @@ void MainComponent::beginManualExportFlow()
                 if (applyPresetGain && std::isfinite(exportGainDb) && std::abs(exportGainDb) > 0.01f)
                     NormalizationAnalyzer::applyGain(exportBuffer, exportGainDb);
 
+                if (applyPresetGain && projectState.hasExportLimiter())
+                {
+                    TruePeakLimiter::Settings limiterSettings;
+                    limiterSettings.ceilingDb = projectState.getExportLimiterCeiling();
+                    TruePeakLimiter::processBuffer(exportBuffer, AudioImporter::MSU1_SAMPLE_RATE, limiterSettings);
+                }
+
                 MSU1Exporter exporter;
                 updateStatus("Exporting to " + file.getFileName() + "...");
 
@@ -821,7 +955,7 @@ void MainComponent::promptExportProcessingOptions(std::function<void(ExportProce
         return;
     }
 
-    const juce::String presetLabel = audioLevelStudio.getActivePresetDisplayName();
+    const juce::String presetLabel = getAudioLevelStudio().getActivePresetDisplayName();
     const juce::String loopPresetText = "Export With Loop Data and Audio Level Preset " + presetLabel + " applied";
     const juce::String loopOnlyText = "Export With Loop Data applied only";
     const juce::String presetOnlyText = "Export with Audio Level Preset " + presetLabel + " only applied";
@@ -883,6 +1017,7 @@ void MainComponent::prepareExportForOption(ExportProcessingOption option,
     if (option == ExportProcessingOption::LoopOnly)
     {
         projectState.setNormalizationGain(0.0f);
+        projectState.setExportLimiterCeiling(std::numeric_limits<float>::quiet_NaN());
         updateStatus("Exporting with loop data only");
         if (onReady)
             onReady(option);
@@ -891,12 +1026,13 @@ void MainComponent::prepareExportForOption(ExportProcessingOption option,
 
     float gainDb = 0.0f;
     juce::String description;
-    if (!audioLevelStudio.calculateActivePresetGain(gainDb, description))
+    auto& studio = getAudioLevelStudio();
+    if (!studio.calculateActivePresetGain(gainDb, description))
     {
         juce::AlertWindow::showMessageBoxAsync(
             juce::MessageBoxIconType::WarningIcon,
             "Preset Error",
-            "Could not calculate gain for the \"" + audioLevelStudio.getActivePresetDisplayName() + "\" preset.");
+            "Could not calculate gain for the \"" + studio.getActivePresetDisplayName() + "\" preset.");
         updateStatus("Preset unavailable for export");
         if (onCancel)
             onCancel();
@@ -904,8 +1040,9 @@ void MainComponent::prepareExportForOption(ExportProcessingOption option,
     }
 
     projectState.setNormalizationGain(gainDb);
+    projectState.setExportLimiterCeiling(studio.getActiveLimiterCeilingDb());
     juce::String status;
-    status << "Applying " << audioLevelStudio.getActivePresetDisplayName()
+    status << "Applying " << studio.getActivePresetDisplayName()
            << " preset (" << juce::String(gainDb, 2) << " dB)";
     updateStatus(status);
     if (onReady)
@@ -938,15 +1075,32 @@ void MainComponent::updateStatus(const juce::String& message)
     statusLabel.setText(message, juce::dontSendNotification);
 }
 
-void MainComponent::checkPreviewState()
+void MainComponent::checkPreviewState(const PlaybackSnapshot& snapshot)
 {
     // Check if preview has stopped playing
-    if (msuFileBrowser.getPreviewingRow() >= 0 && !previewPlayer.isPlaying())
+    if (msuFileBrowser.getPreviewingRow() >= 0 && !snapshot.previewPlaying)
     {
         msuFileBrowser.clearPreviewingRow();
     }
 }
 
+PlaybackSnapshot MainComponent::capturePlaybackSnapshot() const
+{
+    PlaybackSnapshot snapshot;
+    snapshot.playerPosition = audioPlayer.getPosition();
+    snapshot.playerPlaying = audioPlayer.isPlaying();
+    snapshot.previewPlaying = previewPlayer.isPlaying();
+
+    const auto studio = beforeAfterPreviewPlayer.getProgress();
+    snapshot.studioPlaying = studio.playing;
+    snapshot.studioPlayingAfter = studio.target == BeforeAfterPreviewPlayer::Target::After;
+    snapshot.studioPosition = studio.currentSeconds;
+    snapshot.studioLength = studio.totalSeconds;
+
+    snapshot.batchProgress = audioLevelStudio != nullptr ? audioLevelStudio->getBatchProgress() : -1.0;
+    return snapshot;
+}
+
 void MainComponent::loadPersistedDirectories()
 {
     if (settings == nullptr)
@@ -1016,6 +1170,7 @@ void MainComponent::showSettingsDialog()
     settingsWindow->addCustomComponent(creditsLink.get());
 
     settingsWindow->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    settingsWindow->addButton("Audio Diagnostics", 2);
     settingsWindow->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
 
     settingsWindow->enterModalState(true,
@@ -1026,7 +1181,8 @@ void MainComponent::showSettingsDialog()
                 if (backupToggle != nullptr)
                 {
                     backupOriginalsEnabled = backupToggle->getToggleState();
-                    audioLevelStudio.setBackupPreference(backupOriginalsEnabled);
+                    if (audioLevelStudio != nullptr)
+                        audioLevelStudio->setBackupPreference(backupOriginalsEnabled);
                     if (settings != nullptr)
                     {
                         settings->setValue(backupOriginalsKey, backupOriginalsEnabled ? 1 : 0);
@@ -1037,6 +1193,10 @@ void MainComponent::showSettingsDialog()
                         : "Original PCM backups disabled");
                 }
             }
+            else if (result == 2)
+            {
+                showAudioDiagnosticsDialog();
+            }
 
             delete settingsWindow;
         }),
@@ -1044,6 +1204,27 @@ void MainComponent::showSettingsDialog()
 
 }
 
+void MainComponent::showAudioDiagnosticsDialog()
+{
+    std::vector<AudioCallbackMonitor*> monitors {
+        &audioPlayer.getCallbackMonitor(),
+        &previewPlayer.getCallbackMonitor(),
+        &beforeAfterPreviewPlayer.getCallbackMonitor(),
+        &scrubEngine.getCallbackMonitor()
+    };
+
+    auto dialog = std::make_unique<AudioDiagnosticsDialog>(std::move(monitors), audioDeviceManager);
+
+    juce::DialogWindow::LaunchOptions options;
+    options.content.setOwned(dialog.release());
+    options.dialogTitle = "Audio Diagnostics";
+    options.dialogBackgroundColour = getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId);
+    options.useNativeTitleBar = true;
+    options.escapeKeyTriggersCloseButton = true;
+    options.resizable = true;
+    options.content->setSize(860, 520);
+    options.launchAsync();
+}
 
 void MainComponent::showRestoreBackupsDialog()
 {
@@ -12,15 +12,20 @@
 #include "UI/MSUFileBrowser.h"
 #include "UI/CustomLookAndFeel.h"
 #include "UI/LoopEditorTab.h"
+#include "UI/LoopSuggestionsPanel.h"
 #include "UI/AudioLevelStudioComponent.h"
+#include "UI/FrameScheduler.h"
+#include "UI/LazyTabContent.h"
 #include "Audio/AudioPlayer.h"
 #include "Audio/PreviewPlayer.h"
 #include "Audio/BeforeAfterPreviewPlayer.h"
+#include "Audio/ScrubEngine.h"
 #include "Audio/VolumeMatchAnalyzer.h"
 #include "Export/MSU1Exporter.h"
 #include "Export/MSUManifestUpdater.h"
 #include "Export/ManifestHandler.h"
 #include "Dialogs/BackupRestoreDialog.h"
+#include "Dialogs/AudioDiagnosticsDialog.h"
 
 //==============================================================================
 /**
@@ -28,8 +33,7 @@
  * Coordinates all UI components and manages the application state.
  */
 class MainComponent : public juce::Component,
-                      public juce::ChangeListener,
-                      public juce::Timer
+                      public juce::ChangeListener
 {
 public:
     inline static constexpr int kToolbarHeight = 60;
@@ -50,7 +54,6 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
-    void timerCallback() override;
     bool keyPressed(const juce::KeyPress& key) override;
 
     int getMinimumWindowWidth() const;
@@ -63,8 +66,10 @@ private:
     // Core components
     MSUProjectState projectState;
     AudioPlayer audioPlayer;
+    PreviewPrefetchCache previewPrefetchCache;
     PreviewPlayer previewPlayer;
     BeforeAfterPreviewPlayer beforeAfterPreviewPlayer;
+    ScrubEngine scrubEngine;
     juce::AudioDeviceManager audioDeviceManager;
     
     // UI components
@@ -75,12 +80,25 @@ private:
     int loopEditorTabIndex = -1;
     int lastMainTabIndex = -1;
     WaveformView waveformView;
+    SpectrogramView spectrogramView;
+    LoopSuggestionsPanel loopSuggestions;
     TransportControls transportControls;
     MSUFileBrowser msuFileBrowser;
     LoopEditorTab loopEditorTab;
-    AudioLevelStudioComponent audioLevelStudio;
+    
+    // Loudness measured by the studio, shown in the browser's Loudness column
+    std::shared_ptr<TrackAnalysisCache> trackAnalysisCache = std::make_shared<TrackAnalysisCache>();
+    
+    // Built the first time its tab is opened or its presets are needed for export
+    std::unique_ptr<AudioLevelStudioComponent> audioLevelStudio;
+    LazyTabContent audioLevelStudioTab { [this]() -> juce::Component& { return createAudioLevelStudio(); } };
+    
+    // Playhead, time labels, preview state and batch progress all follow this,
+    // once per display frame; declared after everything its clients touch
+    FrameScheduler frameScheduler { *this, [this] { return capturePlaybackSnapshot(); } };
 
     juce::Label statusLabel;
+    bool audioDeviceRequested = false;
     
     // File chooser
     std::unique_ptr<juce::FileChooser> fileChooser;
@@ -98,12 +116,18 @@ private:
     void handleReplaceTrack(const MSUFileBrowser::TrackInfo& track);
     void handlePreviewTrack(const MSUFileBrowser::TrackInfo& track);
     void handleStopPreview();
-    void checkPreviewState();
+    void checkPreviewState(const PlaybackSnapshot& snapshot);
+    PlaybackSnapshot capturePlaybackSnapshot() const;
+    void handleMainTabChanged();
+    void openAudioDevice();
+    AudioLevelStudioComponent& createAudioLevelStudio();
+    AudioLevelStudioComponent& getAudioLevelStudio();
     void loadPersistedDirectories();
     void saveLastAudioDirectory(const juce::File& directory);
     void saveLastMSUDirectory(const juce::File& directory);
     void showSettingsDialog();
     void showRestoreBackupsDialog();
+    void showAudioDiagnosticsDialog();
     void beginManualExportFlow();
     bool shouldWarnAboutMissingLoopData() const;
     enum class ExportProcessingOption
@@ -5,13 +5,20 @@
 #include <limits>
 
 #include "../Audio/AudioImporter.h"
+#include "../Audio/TruePeakLimiter.h"
 #include "../Core/AudioFileHandler.h"
+#include "../Export/BatchExportJournal.h"
 #include "../Export/MSU1Exporter.h"
 
-WaveformOverlayView::WaveformOverlayView(juce::AudioThumbnail& beforeThumb,
-                                         juce::AudioThumbnail& afterThumb)
-    : beforeThumbnail(beforeThumb), afterThumbnail(afterThumb)
+WaveformOverlayView::WaveformOverlayView(juce::AudioThumbnail& beforeThumb)
+    : beforeThumbnail(beforeThumb)
 {
+    beforeThumbnail.addChangeListener(this);
+}
+
+WaveformOverlayView::~WaveformOverlayView()
+{
+    beforeThumbnail.removeChangeListener(this);
 }
 
 void WaveformOverlayView::paint(juce::Graphics& g)
@@ -19,8 +26,7 @@ void WaveformOverlayView::paint(juce::Graphics& g)
     g.fillAll(juce::Colours::black.withAlpha(0.35f));
     auto area = getLocalBounds();
 
-    const double totalLength = juce::jmax(beforeThumbnail.getTotalLength(),
-                                          afterThumbnail.getTotalLength());
+    const double totalLength = beforeThumbnail.getTotalLength();
 
     if (totalLength <= 0.0)
     {
@@ -32,16 +38,28 @@ void WaveformOverlayView::paint(juce::Graphics& g)
     g.setColour(juce::Colours::dimgrey);
     g.drawRect(area);
 
-    if (beforeThumbnail.getTotalLength() > 0.0)
-    {
-        g.setColour(beforeColour);
-        beforeThumbnail.drawChannels(g, area, 0.0, totalLength, 1.0f);
-    }
+    g.setColour(beforeColour);
+    beforeThumbnail.drawChannels(g, area, 0.0, totalLength, 1.0f);
 
-    if (afterThumbnail.getTotalLength() > 0.0)
+    if (afterVisible)
     {
+        // Same peaks, scaled; the thumbnail clamps each lane to its own bounds
         g.setColour(afterColour);
-        afterThumbnail.drawChannels(g, area, 0.0, totalLength, 1.0f);
+        beforeThumbnail.drawChannels(g, area, 0.0, totalLength, afterGain);
+
+        if (!clipRunsValid)
+            updateClipRuns(area, totalLength);
+
+        constexpr int clipMarkerHeight = 4;
+        for (const auto& run : clipRuns)
+        {
+            const juce::Rectangle<int> column(run.getStart(), area.getY(), run.getLength(), area.getHeight());
+            g.setColour(clipColour.withAlpha(0.18f));
+            g.fillRect(column);
+            g.setColour(clipColour);
+            g.fillRect(column.withHeight(clipMarkerHeight));
+            g.fillRect(column.withTrimmedTop(column.getHeight() - clipMarkerHeight));
+        }
     }
 
     if (std::isfinite(playbackCursorRatio) && totalLength > 0.0)
@@ -53,6 +71,11 @@ void WaveformOverlayView::paint(juce::Graphics& g)
     }
 }
 
+void WaveformOverlayView::resized()
+{
+    clipRunsValid = false;
+}
+
 void WaveformOverlayView::setColours(juce::Colour before, juce::Colour after)
 {
     beforeColour = before;
@@ -60,6 +83,66 @@ void WaveformOverlayView::setColours(juce::Colour before, juce::Colour after)
     repaint();
 }
 
+void WaveformOverlayView::setAfterGain(bool showAfter, float gainDb)
+{
+    const float newGain = std::isfinite(gainDb) ? juce::Decibels::decibelsToGain(gainDb) : 1.0f;
+    if (showAfter == afterVisible && juce::approximatelyEqual(newGain, afterGain))
+        return;
+
+    afterVisible = showAfter;
+    afterGain = newGain;
+    clipRunsValid = false;
+    repaint();
+}
+
+void WaveformOverlayView::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    clipRunsValid = false;
+    repaint();
+}
+
+void WaveformOverlayView::updateClipRuns(const juce::Rectangle<int>& area, double totalLength)
+{
+    clipRuns.clear();
+    clipRunsValid = true;
+
+    const int width = area.getWidth();
+    const int numChannels = beforeThumbnail.getNumChannels();
+    if (width <= 0 || numChannels <= 0 || afterGain <= 1.0f)
+        return;
+
+    // A column clips when its loudest source peak, scaled, would pass full scale
+    const float clipThreshold = 1.0f / afterGain;
+    const double secondsPerPixel = totalLength / width;
+    int runStart = -1;
+
+    for (int x = 0; x <= width; ++x)
+    {
+        bool clipped = false;
+        if (x < width)
+        {
+            const double startTime = x * secondsPerPixel;
+            for (int ch = 0; ch < numChannels && !clipped; ++ch)
+            {
+                float minValue = 0.0f;
+                float maxValue = 0.0f;
+                beforeThumbnail.getApproximateMinMax(startTime, startTime + secondsPerPixel, ch, minValue, maxValue);
+                clipped = juce::jmax(std::abs(minValue), std::abs(maxValue)) > clipThreshold;
+            }
+        }
+
+        if (clipped && runStart < 0)
+        {
+            runStart = x;
+        }
+        else if (!clipped && runStart >= 0)
+        {
+            clipRuns.emplace_back(area.getX() + runStart, area.getX() + x);
+            runStart = -1;
+        }
+    }
+}
+
 void WaveformOverlayView::setPlaybackCursorRatio(double ratio)
 {
     const double newRatio = std::isfinite(ratio)
@@ -94,6 +177,14 @@ namespace
         previewCol = 5,
         actionCol = 6
     };
+
+    // Preset gains smaller than this are treated as already matching
+    constexpr float minimumPreviewGainDb = 0.05f;
+
+    // A dry run decodes this many tracks at once; each holds a whole track in memory
+    constexpr int maxBatchAnalysisThreads = 4;
+    constexpr int batchPollIntervalMs = 20;
+    constexpr float packLimitingBudgetDb = 3.0f;      // most limiting the pack solve may ask of one track
 }
 
 class BatchPreviewButton : public juce::Component
@@ -297,16 +388,148 @@ private:
     static constexpr int maxDetailLines = 6;
 };
 
+//==============================================================================
+AudioLevelStudioComponent::PresetPreviewJob::PresetPreviewJob(AudioLevelStudioComponent& component,
+                                                              SharedAudio audio,
+                                                              std::optional<NormalizationAnalyzer::AudioStats> knownStats,
+                                                              const PresetSettings& settings,
+                                                              const TrimPadKey& key,
+                                                              uint32 requestId)
+    : juce::ThreadPoolJob("Preset preview"),
+      owner(&component),
+      sourceAudio(std::move(audio)),
+      cachedStats(knownStats),
+      presetSettings(settings),
+      bufferKey(key),
+      request(requestId)
+{
+}
+
+juce::ThreadPoolJob::JobStatus AudioLevelStudioComponent::PresetPreviewJob::runJob()
+{
+    auto result = std::make_shared<PresetPreviewResult>();
+    result->requestId = request;
+    result->bufferKey = bufferKey;
+    result->stats = cachedStats.has_value() ? *cachedStats : NormalizationAnalyzer::analyzeLevels(*sourceAudio);
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    float gainDb = 0.0f;
+    result->gainValid = calculatePresetGainForSettings(presetSettings, result->stats, gainDb, result->description);
+    if (result->gainValid && std::isfinite(gainDb) && std::abs(gainDb) >= minimumPreviewGainDb)
+        result->gainDb = gainDb;
+
+    // After plays this same buffer with the gain applied by the player
+    rebuildTrimPadBuffer(*sourceAudio, result->buffer, bufferKey.trimStart,
+                         bufferKey.paddingSamples, bufferKey.loopEndSample);
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto component = owner;
+    juce::MessageManager::callAsync([component, result]
+    {
+        if (component != nullptr)
+            component->presetPreviewReady(result);
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+AudioLevelStudioComponent::RowPreviewJob::RowPreviewJob(AudioLevelStudioComponent& component,
+                                                        int rowNumber,
+                                                        const juce::File& pcmFile,
+                                                        const juce::String& trackName,
+                                                        std::shared_ptr<TrackAnalysisCache> cache,
+                                                        const PresetSettings& settings,
+                                                        const TrimPadKey& key,
+                                                        uint32 requestId)
+    : juce::ThreadPoolJob("Track preview"),
+      owner(&component),
+      row(rowNumber),
+      file(pcmFile),
+      name(trackName),
+      analysisCache(std::move(cache)),
+      presetSettings(settings),
+      bufferKey(key),
+      request(requestId)
+{
+}
+
+juce::ThreadPoolJob::JobStatus AudioLevelStudioComponent::RowPreviewJob::runJob()
+{
+    auto result = std::make_shared<RowPreviewResult>();
+    result->requestId = request;
+    result->row = row;
+
+    auto post = [this, result]
+    {
+        auto component = owner;
+        juce::MessageManager::callAsync([component, result]
+        {
+            if (component != nullptr)
+                component->rowPreviewReady(result);
+        });
+        return juce::ThreadPoolJob::jobHasFinished;
+    };
+
+    if (!file.existsAsFile())
+    {
+        result->error = "Missing file for " + name + ".";
+        return post();
+    }
+
+    // Keyed before reading so a file rewritten mid-decode is analysed again next time
+    const auto cacheKey = TrackAnalysisCache::makeKey(file);
+    juce::AudioBuffer<float> source;
+    int64 loopPoint = -1;
+    AudioFileHandler handler;
+    if (!handler.loadAudioFile(file, source, result->sampleRate, &loopPoint))
+    {
+        result->error = "Unable to load " + name + ": " + handler.getLastError();
+        return post();
+    }
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto stats = analysisCache->find(cacheKey);
+    if (!stats.has_value())
+    {
+        // Presets only need levels; a batch plan measures the rest when it gets here
+        stats = NormalizationAnalyzer::analyzeLevels(source);
+        analysisCache->store(cacheKey, *stats);
+    }
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    float gainDb = 0.0f;
+    juce::String description;
+    if (!calculatePresetGainForSettings(presetSettings, *stats, gainDb, description))
+    {
+        result->error = "Preset unavailable for " + name + ".";
+        return post();
+    }
+    if (std::isfinite(gainDb) && std::abs(gainDb) >= minimumPreviewGainDb)
+        result->gainDb = gainDb;
+
+    rebuildTrimPadBuffer(source, result->buffer, bufferKey.trimStart,
+                         bufferKey.paddingSamples, bufferKey.loopEndSample);
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    return post();
+}
+
+//==============================================================================
 AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
                                                                                                          BeforeAfterPreviewPlayer& previewPlayer)
         : projectState(state),
             beforeAfterPlayer(previewPlayer),
             thumbnailCache(8),
-      beforeThumbnail(512, formatManager, thumbnailCache),
-      afterThumbnail(512, formatManager, thumbnailCache)
+      beforeThumbnail(512, formatManager, thumbnailCache)
 {
     formatManager.registerBasicFormats();
-    waveformOverlay = std::make_unique<WaveformOverlayView>(beforeThumbnail, afterThumbnail);
+    waveformOverlay = std::make_unique<WaveformOverlayView>(beforeThumbnail);
     waveformOverlay->setInterceptsMouseClicks(false, false);
 
     addAndMakeVisible(contentViewport);
@@ -336,7 +559,7 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
     waveformPlaceholder.setText("Waveform overlay will appear once audio loads.", juce::dontSendNotification);
     waveformPlaceholder.setJustificationType(juce::Justification::centred);
     waveformLegendLabel.setJustificationType(juce::Justification::centredRight);
-    waveformLegendLabel.setText("Before = Green, After = Aqua", juce::dontSendNotification);
+    waveformLegendLabel.setText("Before = Green, After = Aqua, Clipping = Red", juce::dontSendNotification);
     waveformLegendLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
 
     contentHolder.addAndMakeVisible(headerLabel);
@@ -434,6 +657,16 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
     peakCeilingValueLabel.setJustificationType(juce::Justification::centredRight);
     peakCeilingValueLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
 
+    limiterToggle.setTooltip("Keep the full RMS gain and let a lookahead true-peak limiter hold the peak ceiling on export");
+    limiterToggle.onClick = [this]
+    {
+        limiterEnabled = limiterToggle.getToggleState();
+        updateBatchPresetNoteText();
+
+        if (!updatingAdvancedControls)
+            generatePresetPreview();
+    };
+
     advancedHelpLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
     advancedHelpLabel.setJustificationType(juce::Justification::centredLeft);
     advancedHelpLabel.setText("Manual RMS or peak targets override presets during export.",
@@ -445,6 +678,7 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
     advancedGroup.addAndMakeVisible(peakCeilingToggle);
     advancedGroup.addAndMakeVisible(peakCeilingSlider);
     advancedGroup.addAndMakeVisible(peakCeilingValueLabel);
+    advancedGroup.addAndMakeVisible(limiterToggle);
     advancedGroup.addAndMakeVisible(advancedHelpLabel);
 
     contentHolder.addAndMakeVisible(batchGroup);
@@ -453,6 +687,8 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
     batchGroup.addAndMakeVisible(batchTrackTable);
     batchGroup.addAndMakeVisible(batchPresetNote);
     batchGroup.addAndMakeVisible(batchPreviewNote);
+    batchGroup.addAndMakeVisible(batchDryRunButton);
+    batchGroup.addAndMakeVisible(packMatchToggle);
     batchGroup.addAndMakeVisible(batchExportButton);
     batchGroup.addAndMakeVisible(batchProgressBar);
     batchGroup.addAndMakeVisible(batchCancelButton);
@@ -497,6 +733,20 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
         cancelBatchOperation();
     };
 
+    batchDryRunButton.setTooltip("Analyse every track and list the gain the preset would apply, without writing anything");
+    batchDryRunButton.onClick = [this]
+    {
+        runBatchOperation(false);
+    };
+
+    packMatchToggle.setTooltip("Solve one gain per track so the whole pack matches in loudness within the peak ceiling; "
+                               "the gains come from a Batch Dry Run");
+    packMatchToggle.onClick = [this]
+    {
+        packMatchEnabled = packMatchToggle.getToggleState();
+        updateBatchPresetNoteText();
+    };
+
     batchExportButton.setButtonText("Batch export w/ Preset/Manual Settings applied.");
     batchExportButton.onClick = [this]
     {
@@ -514,16 +764,15 @@ AudioLevelStudioComponent::AudioLevelStudioComponent(MSUProjectState& state,
     };
 
     refreshFromProjectState();
-    syncBeforeAfterBuffers();
     syncAdvancedControls();
     updateBatchSelectionSummary();
     updateBatchButtons();
-    startTimerHz(10);
 }
 
 AudioLevelStudioComponent::~AudioLevelStudioComponent()
 {
-    stopTimer();
+    cancelPresetPreview();
+    cancelRowPreview();
     stopPreviewPlayback();
     if (batchWorker && batchWorker->joinable())
         batchWorker->join();
@@ -610,6 +859,7 @@ void AudioLevelStudioComponent::resized()
 
     advancedBounds.removeFromTop(8);
     auto helpRow = advancedBounds.removeFromTop(24);
+    limiterToggle.setBounds(helpRow.removeFromRight(280));
     advancedHelpLabel.setBounds(helpRow);
 
     bounds.removeFromTop(12);
@@ -626,10 +876,12 @@ void AudioLevelStudioComponent::resized()
     loadMSUButton.setBounds(loadRow.reduced(4));
 
     auto exportRow = batchBounds.removeFromTop(36);
+    batchDryRunButton.setBounds(exportRow.removeFromLeft(160).reduced(4));
     batchExportButton.setBounds(exportRow.reduced(4));
 
     batchBounds.removeFromTop(4);
     auto previewNoteRow = batchBounds.removeFromTop(24);
+    packMatchToggle.setBounds(previewNoteRow.removeFromLeft(260));
     batchPreviewNote.setBounds(previewNoteRow.reduced(4));
 
     batchBounds.removeFromTop(4);
@@ -659,6 +911,7 @@ void AudioLevelStudioComponent::refreshFromProjectState()
 {
     if (!projectState.hasAudio())
     {
+        cancelPresetPreview();
         stopActiveTrackPreview();
         clearPreview();
         clearWaveformData();
@@ -698,8 +951,15 @@ void AudioLevelStudioComponent::refreshFromProjectState()
         loopInfoLabel.setText("Loop points: --", juce::dontSendNotification);
 
     updateWaveformThumbnails(true);
+
+    // The preview job delivers fresh stats and player buffers when it finishes
     generatePresetPreview();
+    updateStatsLabels();
+    syncAdvancedControls();
+}
 
+void AudioLevelStudioComponent::updateStatsLabels()
+{
     if (hasStats)
     {
         rmsLabel.setText("RMS: " + formatDbValue(latestStats.rmsDb), juce::dontSendNotification);
@@ -714,9 +974,6 @@ void AudioLevelStudioComponent::refreshFromProjectState()
         peakLabel.setText("Peak: --", juce::dontSendNotification);
         headroomLabel.setText("Headroom: --", juce::dontSendNotification);
     }
-
-    syncBeforeAfterBuffers();
-    syncAdvancedControls();
 }
 
 void AudioLevelStudioComponent::paint(juce::Graphics& g)
@@ -783,7 +1040,8 @@ juce::String AudioLevelStudioComponent::formatHeadroom(float peakDb) const
 void AudioLevelStudioComponent::updateWaveformThumbnails(bool forceReferenceReset)
 {
     const bool hasProjectAudio = projectState.hasAudio();
-    const bool hasReferenceAudio = referenceValid && referenceBuffer.getNumSamples() > 0 && referenceSampleRate > 0.0;
+    const bool hasReferenceAudio = referenceValid && referenceAudio != nullptr
+                                && referenceAudio->getNumSamples() > 0 && referenceSampleRate > 0.0;
 
     if (!hasProjectAudio && !hasReferenceAudio)
     {
@@ -802,8 +1060,9 @@ void AudioLevelStudioComponent::updateWaveformThumbnails(bool forceReferenceRese
             return;
         }
 
-        if (forceReferenceReset || !referenceValid)
-            refreshReferenceBuffer(*projectBuffer, projectSampleRate, projectState.getSourceFile());
+        // The snapshot only needs replacing when the audio itself has changed
+        if (!referenceValid || (forceReferenceReset && referenceAudioVersion != projectState.getAudioVersion()))
+            refreshReferenceBuffer(projectSampleRate, projectState.getSourceFile());
     }
     else if (!hasReferenceAudio)
     {
@@ -811,35 +1070,17 @@ void AudioLevelStudioComponent::updateWaveformThumbnails(bool forceReferenceRese
         return;
     }
 
+    // Only the before waveform is built from samples; the after trace is that one scaled
     juce::AudioBuffer<float> beforeDisplayBuffer;
-    juce::AudioBuffer<float> afterDisplayBuffer;
     const int64 trimStart = projectState.getTrimStart();
     const int64 paddingSamples = projectState.getPaddingSamples();
     const int64 loopEnd = projectState.hasLoopPoints() ? projectState.getLoopEnd() : -1;
 
-    if (referenceValid && referenceBuffer.getNumSamples() > 0)
-        rebuildTrimPadBuffer(referenceBuffer, beforeDisplayBuffer, trimStart, paddingSamples, loopEnd);
+    if (referenceValid && referenceAudio != nullptr && referenceAudio->getNumSamples() > 0)
+        rebuildTrimPadBuffer(*referenceAudio, beforeDisplayBuffer, trimStart, paddingSamples, loopEnd);
     else
         beforeDisplayBuffer.setSize(0, 0);
 
-    const juce::AudioBuffer<float>* afterSource = nullptr;
-    double afterSampleRate = 0.0;
-    if (previewValid && previewBuffer.getNumSamples() > 0)
-    {
-        afterSource = &previewBuffer;
-        afterSampleRate = previewSampleRate;
-    }
-    else if (projectBuffer != nullptr)
-    {
-        afterSource = projectBuffer;
-        afterSampleRate = projectSampleRate;
-    }
-
-    if (afterSource != nullptr)
-        rebuildTrimPadBuffer(*afterSource, afterDisplayBuffer, trimStart, paddingSamples, loopEnd);
-    else
-        afterDisplayBuffer.setSize(0, 0);
-
     if (beforeDisplayBuffer.getNumSamples() > 0 && referenceSampleRate > 0.0)
     {
         beforeThumbnail.reset(beforeDisplayBuffer.getNumChannels(), referenceSampleRate);
@@ -851,52 +1092,40 @@ void AudioLevelStudioComponent::updateWaveformThumbnails(bool forceReferenceRese
         beforeThumbnail.reset(0, fallbackRate > 0.0 ? fallbackRate : 44100.0);
     }
 
-    const double resolvedAfterRate = afterSampleRate > 0.0
-        ? afterSampleRate
-        : (projectSampleRate > 0.0 ? projectSampleRate : referenceSampleRate);
-
-    if (afterDisplayBuffer.getNumSamples() > 0 && resolvedAfterRate > 0.0)
-    {
-        afterThumbnail.reset(afterDisplayBuffer.getNumChannels(), resolvedAfterRate);
-        afterThumbnail.addBlock(0, afterDisplayBuffer, 0, afterDisplayBuffer.getNumSamples());
-    }
-    else
-    {
-        const double fallbackRate = resolvedAfterRate > 0.0 ? resolvedAfterRate : 44100.0;
-        afterThumbnail.reset(0, fallbackRate);
-    }
-
-    const bool hasWaveform = beforeThumbnail.getTotalLength() > 0.0 || afterThumbnail.getTotalLength() > 0.0;
+    const bool hasWaveform = beforeThumbnail.getTotalLength() > 0.0;
     waveformPlaceholder.setVisible(!hasWaveform);
     waveformLegendLabel.setVisible(hasWaveform);
+    updateAfterOverlay();
+}
+
+void AudioLevelStudioComponent::updateAfterOverlay()
+{
+    // The after buffer is the project audio, times the preview gain when a preview is active
     if (waveformOverlay != nullptr)
-        waveformOverlay->repaint();
+        waveformOverlay->setAfterGain(previewValid || projectState.hasAudio(),
+                                      previewValid ? pendingPreviewGainDb : 0.0f);
 }
 
-void AudioLevelStudioComponent::refreshReferenceBuffer(const juce::AudioBuffer<float>& buffer,
-                                                       double sampleRate,
-                                                       const juce::File& sourceFile)
+void AudioLevelStudioComponent::refreshReferenceBuffer(double sampleRate, const juce::File& sourceFile)
 {
-    referenceBuffer.makeCopyOf(buffer);
+    // Shares the project's immutable snapshot; edits replace it rather than change it
+    referenceAudio = projectState.getAudioSnapshot();
+    referenceAudioVersion = projectState.getAudioVersion();
     referenceSampleRate = sampleRate;
     referenceValid = true;
     if (sourceFile.existsAsFile())
         referenceSourceFile = sourceFile;
     else
         referenceSourceFile = projectState.getSourceFile();
-
-    beforeThumbnail.reset(buffer.getNumChannels(), sampleRate);
-    beforeThumbnail.addBlock(0, referenceBuffer, 0, referenceBuffer.getNumSamples());
 }
 
 void AudioLevelStudioComponent::clearWaveformData()
 {
     clearPreview();
     beforeThumbnail.reset(0, 44100.0);
-    afterThumbnail.reset(0, 44100.0);
-    referenceBuffer.setSize(0, 0);
+    referenceAudio.reset();
     beforeProcessedBuffer.setSize(0, 0);
-    afterProcessedBuffer.setSize(0, 0);
+    processedBufferValid = false;
     referenceValid = false;
     waveformPlaceholder.setVisible(true);
     waveformLegendLabel.setVisible(false);
@@ -909,21 +1138,21 @@ void AudioLevelStudioComponent::clearWaveformData()
 
 void AudioLevelStudioComponent::clearPreview()
 {
-    previewBuffer.setSize(0, 0);
     previewValid = false;
     pendingPreviewGainDb = 0.0f;
     pendingPresetDescription.clear();
     previewSampleRate = 0.0;
     projectState.setNormalizationGain(0.0f);
     updateWaveformLegend();
+    updateAfterOverlay();
     syncBeforeAfterBuffers();
 }
 
 void AudioLevelStudioComponent::updateWaveformLegend()
 {
     waveformLegendLabel.setText(
-        previewValid ? "Before = Green, Preview = Aqua"
-                     : "Before = Green, After = Aqua",
+        previewValid ? "Before = Green, Preview = Aqua, Clipping = Red"
+                     : "Before = Green, After = Aqua, Clipping = Red",
         juce::dontSendNotification);
 }
 
@@ -942,10 +1171,11 @@ bool AudioLevelStudioComponent::calculateActivePresetGain(float& gainDb, juce::S
     if (!projectState.hasAudio())
         return false;
 
-    if (!hasStats)
+    if (!hasStats || statsAudioVersion != projectState.getAudioVersion())
     {
-        latestStats = NormalizationAnalyzer::analyzeBuffer(projectState.getAudioBuffer());
+        latestStats = NormalizationAnalyzer::analyzeLevels(projectState.getAudioBuffer());
         hasStats = true;
+        statsAudioVersion = projectState.getAudioVersion();
     }
 
     if (!calculatePresetGain(gainDb, description))
@@ -1013,11 +1243,16 @@ bool AudioLevelStudioComponent::calculatePresetGainForSettings(const PresetSetti
 
     if (std::isfinite(rmsGain) && std::isfinite(peakGain))
     {
-        const bool cappedByPeak = rmsGain > peakGain;
+        // With the limiter the RMS target stands and the limiter holds the ceiling on export
+        const bool overCeiling = rmsGain > peakGain;
+        const bool cappedByPeak = overCeiling && !settings.limiterEnabled;
         gainDb = cappedByPeak ? peakGain : rmsGain;
-        description = cappedByPeak
-            ? rmsDescription + " (capped by " + peakDescription + ")"
-            : rmsDescription + " & " + peakDescription;
+        if (cappedByPeak)
+            description = rmsDescription + " (capped by " + peakDescription + ")";
+        else if (overCeiling)
+            description = rmsDescription + " (peaks limited to " + juce::String(getLimiterCeilingDb(settings), 1) + " dBTP)";
+        else
+            description = rmsDescription + " & " + peakDescription;
         return std::isfinite(gainDb);
     }
 
@@ -1025,6 +1260,8 @@ bool AudioLevelStudioComponent::calculatePresetGainForSettings(const PresetSetti
     {
         gainDb = rmsGain;
         description = rmsDescription;
+        if (settings.limiterEnabled)
+            description << " (limited to " << juce::String(getLimiterCeilingDb(settings), 1) << " dBTP)";
         return true;
     }
 
@@ -1035,61 +1272,109 @@ bool AudioLevelStudioComponent::calculatePresetGainForSettings(const PresetSetti
 
 void AudioLevelStudioComponent::generatePresetPreview()
 {
-    clearPreview();
-
-    if (!projectState.hasAudio())
+    if (!projectState.hasAudio() || referenceAudio == nullptr)
+    {
+        cancelPresetPreview();
+        clearPreview();
         return;
+    }
 
-    latestStats = NormalizationAnalyzer::analyzeBuffer(projectState.getAudioBuffer());
-    hasStats = true;
+    if (statsAudioVersion != referenceAudioVersion)
+        hasStats = false;
 
-    float gainDb = 0.0f;
-    juce::String description;
-    if (!calculatePresetGain(gainDb, description))
+    // Latest request wins: whatever is queued or running is for settings that are already stale
+    cancelPresetPreview();
+
+    const auto bufferKey = makeTrimPadKey(referenceAudioVersion);
+
+    // Only the preset changed: the player buffer stands, so just retune the After gain
+    if (hasStats && processedBufferValid && processedBufferKey == bufferKey)
     {
-        statsHintLabel.setText("Unable to calculate preset gain.", juce::dontSendNotification);
-        applyPreviewBuffer(projectState.getAudioBuffer(), projectState.getSampleRate(), description, 0.0f);
+        float gainDb = 0.0f;
+        juce::String description;
+        const bool gainValid = calculatePresetGainForSettings(getCurrentPresetSettings(), latestStats, gainDb, description);
+        if (!gainValid || !std::isfinite(gainDb) || std::abs(gainDb) < minimumPreviewGainDb)
+            gainDb = 0.0f;
+
+        applyPresetGain(gainValid, gainDb, description);
         return;
     }
 
-    if (!std::isfinite(gainDb) || std::abs(gainDb) < 0.05f)
-    {
-        statsHintLabel.setText("Preset already matches the current level.", juce::dontSendNotification);
-        applyPreviewBuffer(projectState.getAudioBuffer(), projectState.getSampleRate(), description, 0.0f);
+    std::optional<NormalizationAnalyzer::AudioStats> knownStats;
+    if (hasStats)
+        knownStats = latestStats;
+
+    previewPool.addJob(new PresetPreviewJob(*this,
+                                            referenceAudio,
+                                            knownStats,
+                                            getCurrentPresetSettings(),
+                                            bufferKey,
+                                            previewRequestId),
+                       true);
+}
+
+AudioLevelStudioComponent::TrimPadKey AudioLevelStudioComponent::makeTrimPadKey(uint32 audioVersion) const
+{
+    TrimPadKey key;
+    key.audioVersion = audioVersion;
+    key.trimStart = projectState.getTrimStart();
+    key.paddingSamples = projectState.getPaddingSamples();
+    key.loopEndSample = projectState.hasLoopPoints() ? projectState.getLoopEnd() : -1;
+    return key;
+}
+
+void AudioLevelStudioComponent::cancelPresetPreview()
+{
+    ++previewRequestId;
+    previewPool.removeAllJobs(true, 0);
+}
+
+void AudioLevelStudioComponent::presetPreviewReady(std::shared_ptr<PresetPreviewResult> result)
+{
+    if (result->requestId != previewRequestId || result->bufferKey.audioVersion != referenceAudioVersion
+        || !projectState.hasAudio())
         return;
-    }
 
-    previewBuffer.makeCopyOf(projectState.getAudioBuffer());
-    NormalizationAnalyzer::applyGain(previewBuffer, gainDb);
-    applyPreviewBuffer(previewBuffer, projectState.getSampleRate(), description, gainDb);
+    latestStats = result->stats;
+    hasStats = true;
+    statsAudioVersion = result->bufferKey.audioVersion;
+    updateStatsLabels();
+
+    applyPresetGain(result->gainValid, result->gainDb, result->description);
+
+    syncBeforeAfterBuffers([this, result]
+    {
+        beforeProcessedBuffer = std::move(result->buffer);
+        processedBufferKey = result->bufferKey;
+        processedBufferValid = true;
+    });
 }
 
-void AudioLevelStudioComponent::applyPreviewBuffer(const juce::AudioBuffer<float>& buffer,
-                                                   double sampleRate,
-                                                   const juce::String& description,
-                                                   float gainDb,
-                                                   bool updateProjectState)
+void AudioLevelStudioComponent::applyPresetGain(bool gainValid, float gainDb, const juce::String& description)
 {
-    previewBuffer.makeCopyOf(buffer);
     pendingPreviewGainDb = gainDb;
     pendingPresetDescription = description;
     previewValid = true;
-    previewSampleRate = sampleRate;
-    if (updateProjectState)
-        projectState.setNormalizationGain(gainDb);
+    previewSampleRate = referenceSampleRate;
+    projectState.setNormalizationGain(gainDb);
     updateWaveformLegend();
-    updateWaveformThumbnails(false);
+    updateAfterOverlay();
     waveformPlaceholder.setVisible(false);
     waveformLegendLabel.setVisible(true);
-    if (waveformOverlay != nullptr)
-        waveformOverlay->repaint();
 
     juce::String message;
+    if (!gainValid)
+        message = "Unable to calculate preset gain.";
+    else if (gainDb == 0.0f)
+        message = "Preset already matches the current level.";
+    else
         message << "Previewing " << juce::String(pendingPreviewGainDb, 2) << " dB toward "
-            << pendingPresetDescription << ". This gain will be applied automatically when exporting.";
+                << pendingPresetDescription << ". This gain will be applied automatically when exporting.";
     statsHintLabel.setText(message, juce::dontSendNotification);
 
-    syncBeforeAfterBuffers();
+    // A row preview owns the player until it stops, and restores this gain then
+    if (!batchPreviewActive)
+        beforeAfterPlayer.setAfterGain(pendingPreviewGainDb);
 }
 
 AudioLevelStudioComponent::PresetSettings AudioLevelStudioComponent::getCurrentPresetSettings() const
@@ -1099,6 +1384,8 @@ AudioLevelStudioComponent::PresetSettings AudioLevelStudioComponent::getCurrentP
     settings.manualTargetEnabled = manualTargetEnabled;
     settings.manualTargetRmsDb = manualTargetRmsDb;
     settings.manualPeakEnabled = manualPeakEnabled;
+    settings.limiterEnabled = limiterEnabled;
+    settings.packMatchEnabled = packMatchEnabled;
     settings.manualPeakDbfs = manualPeakDbfs;
     return settings;
 }
@@ -1129,15 +1416,13 @@ void AudioLevelStudioComponent::applyGainNonDestructively(float gainDb)
     if (!std::isfinite(gainDb) || juce::approximatelyEqual(gainDb, 0.0f))
         return;
 
-    auto& buffer = projectState.getAudioBuffer();
+    auto& buffer = projectState.editAudioBuffer();
     NormalizationAnalyzer::applyGain(buffer, gainDb);
-    projectState.setModified(true);
-    latestStats = NormalizationAnalyzer::analyzeBuffer(buffer);
+    projectState.notifyAudioContentChanged();
+    latestStats = NormalizationAnalyzer::analyzeLevels(buffer);
     hasStats = true;
-    rmsLabel.setText("RMS: " + formatDbValue(latestStats.rmsDb), juce::dontSendNotification);
-    lufsLabel.setText("LUFS (est): " + formatLufsEstimate(latestStats.rmsDb), juce::dontSendNotification);
-    peakLabel.setText("Peak: " + formatDbValue(latestStats.peakDb), juce::dontSendNotification);
-    headroomLabel.setText("Headroom: " + formatHeadroom(latestStats.peakDb), juce::dontSendNotification);
+    statsAudioVersion = projectState.getAudioVersion();
+    updateStatsLabels();
     updateWaveformThumbnails(false);
     syncBeforeAfterBuffers();
 }
@@ -1179,22 +1464,20 @@ void AudioLevelStudioComponent::rebuildTrimPadBuffer(const juce::AudioBuffer<flo
 void AudioLevelStudioComponent::rebuildProcessedBuffers()
 {
     beforeProcessedBuffer.setSize(0, 0);
-    afterProcessedBuffer.setSize(0, 0);
+    processedBufferValid = false;
 
-    const int64 trimStart = projectState.getTrimStart();
-    const int64 paddingSamples = projectState.getPaddingSamples();
-    const int64 loopEnd = projectState.hasLoopPoints() ? projectState.getLoopEnd() : -1;
-
-    if (referenceValid && referenceBuffer.getNumSamples() > 0)
-        rebuildTrimPadBuffer(referenceBuffer, beforeProcessedBuffer, trimStart, paddingSamples, loopEnd);
-
-    if (previewValid && previewBuffer.getNumSamples() > 0)
+    if (referenceValid && referenceAudio != nullptr && referenceAudio->getNumSamples() > 0)
     {
-        rebuildTrimPadBuffer(previewBuffer, afterProcessedBuffer, trimStart, paddingSamples, loopEnd);
+        processedBufferKey = makeTrimPadKey(referenceAudioVersion);
+        rebuildTrimPadBuffer(*referenceAudio, beforeProcessedBuffer, processedBufferKey.trimStart,
+                             processedBufferKey.paddingSamples, processedBufferKey.loopEndSample);
+        processedBufferValid = true;
     }
     else if (projectState.hasAudio())
     {
-        rebuildTrimPadBuffer(projectState.getAudioBuffer(), afterProcessedBuffer, trimStart, paddingSamples, loopEnd);
+        const auto key = makeTrimPadKey(projectState.getAudioVersion());
+        rebuildTrimPadBuffer(projectState.getAudioBuffer(), beforeProcessedBuffer,
+                             key.trimStart, key.paddingSamples, key.loopEndSample);
     }
 }
 
@@ -1213,6 +1496,8 @@ void AudioLevelStudioComponent::syncAdvancedControls()
     peakCeilingValueLabel.setEnabled(manualPeakEnabled);
     peakCeilingSlider.setValue(manualPeakDbfs, juce::dontSendNotification);
     updatePeakTargetValueLabel();
+    limiterToggle.setToggleState(limiterEnabled, juce::dontSendNotification);
+    packMatchToggle.setToggleState(packMatchEnabled, juce::dontSendNotification);
     updateBatchPresetNoteText();
 }
 
@@ -1273,7 +1558,12 @@ void AudioLevelStudioComponent::updateBatchPresetNoteText()
         if (hasManualOverridesEnabled())
         text << " plus your " << describeManualOverrides(false);
 
-    text << " to every track.";
+    text << " to every track";
+    if (limiterEnabled)
+        text << ", limiting peaks at the ceiling";
+    if (packMatchEnabled)
+        text << ", with gains matched across the pack by Batch Dry Run";
+    text << ".";
     batchPresetNote.setText(text, juce::dontSendNotification);
 }
 
@@ -1295,7 +1585,7 @@ void AudioLevelStudioComponent::showBatchProgressDialog(bool exportMode, int tot
 
     juce::DialogWindow::LaunchOptions options;
     options.content.setOwned(view.release());
-    options.dialogTitle = exportMode ? "Exporting Tracks" : "Previewing Tracks";
+    options.dialogTitle = exportMode ? "Exporting Tracks" : "Batch Dry Run";
     options.useNativeTitleBar = true;
     options.resizable = false;
     options.escapeKeyTriggersCloseButton = false;
@@ -1320,7 +1610,7 @@ void AudioLevelStudioComponent::updateBatchProgressDialog(int processed, int tot
     processed = juce::jlimit(0, clampedTotal, processed);
 
     juce::String summary;
-        summary << (batchProgressExportMode ? "Exporting " : "Previewing ")
+        summary << (batchProgressExportMode ? "Exporting " : "Analysing ")
             << processed << " / " << clampedTotal << " track" << (clampedTotal == 1 ? "" : "s") << "...";
     view->setSummary(summary);
 
@@ -1637,6 +1927,7 @@ void AudioLevelStudioComponent::updateBatchButtons()
     const bool busy = batchInProgress.load();
 
     loadMSUButton.setEnabled(requestExternalMSULoad != nullptr && !busy);
+    batchDryRunButton.setEnabled(hasTracks && !busy);
     batchExportButton.setEnabled(hasTracks && !busy);
     batchTrackTable.setEnabled(!busy);
     batchCancelButton.setVisible(busy);
@@ -1700,86 +1991,61 @@ bool AudioLevelStudioComponent::previewBatchTrack(int rowNumber)
 
     stopActiveTrackPreview();
 
-    juce::AudioBuffer<float> sourceBuffer;
-    juce::AudioBuffer<float> processedBuffer;
-    double sampleRate = 0.0;
-
-    if (!loadTrackPreviewData(*entry, sourceBuffer, processedBuffer, sampleRate))
-        return false;
-
-    configureBatchPreviewPlayback(sourceBuffer, processedBuffer, sampleRate);
-
     if (requestPlaybackStop)
         requestPlaybackStop();
 
-    beforeAfterPlayer.play(BeforeAfterPreviewPlayer::Target::After, true);
+    // Claim the player now so the row shows as previewing while the track decodes
+    beforeAfterPlayer.stop();
+    beforeAfterPlayer.setSourceBuffers(nullptr, nullptr, batchPreviewSampleRate);
+    batchPreviewActive = true;
     updatePreviewPlaybackButtons();
 
-    juce::String status;
-        status << "Previewing " << entry->suggestedName
-            << " - " << getSelectedPresetLabel();
-    batchStatusLabel.setText(status, juce::dontSendNotification);
+    rowPreviewPool.addJob(new RowPreviewJob(*this,
+                                            rowNumber,
+                                            entry->pcmFile,
+                                            entry->suggestedName,
+                                            analysisCache,
+                                            getCurrentPresetSettings(),
+                                            makeTrimPadKey(0),
+                                            rowPreviewRequestId),
+                          true);
+
+    batchStatusLabel.setText("Loading " + entry->suggestedName + "...", juce::dontSendNotification);
     return true;
 }
 
-bool AudioLevelStudioComponent::loadTrackPreviewData(const BatchTrackEntry& entry,
-                                                     juce::AudioBuffer<float>& sourceBuffer,
-                                                     juce::AudioBuffer<float>& processedBuffer,
-                                                     double& sampleRate)
+void AudioLevelStudioComponent::cancelRowPreview()
 {
-    if (!entry.pcmFile.existsAsFile())
-    {
-        batchStatusLabel.setText("Missing file for " + entry.suggestedName + ".", juce::dontSendNotification);
-        return false;
-    }
-
-    AudioFileHandler handler;
-    double loadedSampleRate = 0.0;
-    int64 loopPoint = -1;
-    if (!handler.loadAudioFile(entry.pcmFile, sourceBuffer, loadedSampleRate, &loopPoint))
-    {
-        batchStatusLabel.setText("Unable to load " + entry.suggestedName + ": " + handler.getLastError(),
-                                 juce::dontSendNotification);
-        return false;
-    }
-
-    auto stats = NormalizationAnalyzer::analyzeBuffer(sourceBuffer);
-    float gainDb = 0.0f;
-    juce::String description;
-    if (!calculatePresetGain(gainDb, description, stats))
-    {
-        batchStatusLabel.setText("Preset unavailable for " + entry.suggestedName + ".", juce::dontSendNotification);
-        return false;
-    }
-
-    processedBuffer.makeCopyOf(sourceBuffer);
-    if (std::abs(gainDb) > 0.05f)
-        NormalizationAnalyzer::applyGain(processedBuffer, gainDb);
-
-    juce::ignoreUnused(description);
-    sampleRate = loadedSampleRate;
-    return true;
+    ++rowPreviewRequestId;
+    rowPreviewPool.removeAllJobs(true, 0);
 }
 
-void AudioLevelStudioComponent::configureBatchPreviewPlayback(const juce::AudioBuffer<float>& sourceBuffer,
-                                                              const juce::AudioBuffer<float>& processedBuffer,
-                                                              double sampleRate)
+void AudioLevelStudioComponent::rowPreviewReady(std::shared_ptr<RowPreviewResult> result)
 {
-    const int64 trimStart = projectState.getTrimStart();
-    const int64 paddingSamples = projectState.getPaddingSamples();
-    const int64 loopEndSample = projectState.hasLoopPoints() ? projectState.getLoopEnd() : -1;
+    if (result->requestId != rowPreviewRequestId || result->row != activeBatchPreviewRow)
+        return;
 
-    rebuildTrimPadBuffer(sourceBuffer, batchPreviewBeforeBuffer, trimStart, paddingSamples, loopEndSample);
-    rebuildTrimPadBuffer(processedBuffer, batchPreviewAfterBuffer, trimStart, paddingSamples, loopEndSample);
+    if (result->error.isNotEmpty())
+    {
+        stopActiveTrackPreview();
+        batchStatusLabel.setText(result->error, juce::dontSendNotification);
+        return;
+    }
 
-    batchPreviewSampleRate = sampleRate > 0.0 ? sampleRate : projectState.getSampleRate();
-    batchPreviewActive = true;
+    // Detach before the buffer is replaced; Before and After share it, After at the track's gain
+    beforeAfterPlayer.setSourceBuffers(nullptr, nullptr, batchPreviewSampleRate);
+    batchPreviewBuffer = std::move(result->buffer);
+    batchPreviewSampleRate = result->sampleRate > 0.0 ? result->sampleRate : projectState.getSampleRate();
 
-    const auto* beforePtr = batchPreviewBeforeBuffer.getNumSamples() > 0 ? &batchPreviewBeforeBuffer : nullptr;
-    const auto* afterPtr = batchPreviewAfterBuffer.getNumSamples() > 0 ? &batchPreviewAfterBuffer : nullptr;
-    const double sourceRate = batchPreviewSampleRate > 0.0 ? batchPreviewSampleRate : previewSampleRate;
-    beforeAfterPlayer.setSourceBuffers(beforePtr, afterPtr, sourceRate);
+    const auto* bufferPtr = batchPreviewBuffer.getNumSamples() > 0 ? &batchPreviewBuffer : nullptr;
+    beforeAfterPlayer.setSourceBuffers(bufferPtr, bufferPtr, batchPreviewSampleRate);
+    beforeAfterPlayer.setAfterGain(result->gainDb);
+    beforeAfterPlayer.play(BeforeAfterPreviewPlayer::Target::After, true);
     updatePreviewPlaybackButtons();
+
+    if (const auto* entry = getBatchEntry(result->row))
+        batchStatusLabel.setText("Previewing " + entry->suggestedName + " - " + getSelectedPresetLabel(),
+                                 juce::dontSendNotification);
 }
 
 void AudioLevelStudioComponent::stopActiveTrackPreview()
@@ -1787,12 +2053,12 @@ void AudioLevelStudioComponent::stopActiveTrackPreview()
     if (activeBatchPreviewRow < 0 && !batchPreviewActive)
         return;
 
+    cancelRowPreview();
     beforeAfterPlayer.stop();
     activeBatchPreviewRow = -1;
     batchPreviewActive = false;
-    batchPreviewBeforeBuffer.setSize(0, 0);
-    batchPreviewAfterBuffer.setSize(0, 0);
     syncBeforeAfterBuffers();
+    batchPreviewBuffer.setSize(0, 0);
     updateBatchSelectionSummary();
     refreshBatchTableComponents();
 }
@@ -1861,9 +2127,6 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
     if (batchInProgress.load())
         return;
 
-    if (!exportMode)
-        return;
-
     if (activeBatchPreviewRow >= 0)
         stopActiveTrackPreview();
 
@@ -1873,6 +2136,28 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
         return;
     }
 
+    const auto presetSettings = getCurrentPresetSettings();
+
+    // A dry run only reads the tracks, so there is nothing to confirm
+    if (!exportMode)
+    {
+        beginBatchOperation(false, std::vector<BatchTrackEntry>(batchTracks.begin(), batchTracks.end()),
+                            presetSettings, nullptr);
+        return;
+    }
+
+    // The last dry run's gains still apply if the preset hasn't changed since
+    std::shared_ptr<const BatchPlan> plan;
+    if (batchPlan != nullptr && batchPlan->presetSettings == presetSettings)
+        plan = batchPlan;
+
+    // Pack gains depend on every track, so they can only come from a dry run
+    if (presetSettings.packMatchEnabled && plan == nullptr)
+    {
+        batchStatusLabel.setText("Run Batch Dry Run first to match loudness across the pack.", juce::dontSendNotification);
+        return;
+    }
+
     auto entries = std::make_shared<std::vector<BatchTrackEntry>>(batchTracks.begin(), batchTracks.end());
     const size_t trackCount = entries->size();
     const bool confirmOverwriteBackups = exportMode && backupsEnabled && hasExistingBackups(*entries);
@@ -1888,7 +2173,26 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
     if (manualOverrides)
         message << "\nManual overrides: " << describeManualOverrides(true) << ".";
 
-    const auto presetSettings = getCurrentPresetSettings();
+    if (presetSettings.limiterEnabled)
+        message << "\nPeaks above " << juce::String(getLimiterCeilingDb(presetSettings), 1)
+                << " dBTP are limited rather than lowering each track's gain.";
+
+    if (presetSettings.packMatchEnabled)
+        message << "\nGains come from the dry run's pack match: " << juce::String(plan->packTargetDb, 1)
+                << " dB RMS, within " << juce::String(plan->packSpreadDb, 1) << " dB.";
+
+    std::map<juce::String, BatchExportJournal::StartedTrack> unfinished;
+    const auto resumable = BatchExportJournal(entries->front().pcmFile.getParentDirectory())
+                               .findResumableTracks(describePresetSettings(presetSettings), &unfinished);
+    if (!resumable.empty() || !unfinished.empty())
+        message << "\nAn interrupted export with these settings will resume.";
+    if (!resumable.empty())
+        message << " " << static_cast<int>(resumable.size()) << " track" << (resumable.size() == 1 ? " it" : "s it")
+                << " already finished will be skipped.";
+    if (!unfinished.empty())
+        message << " " << static_cast<int>(unfinished.size()) << " track" << (unfinished.size() == 1 ? " it was" : "s it was")
+                << " exporting will be redone from the original.";
+
     auto safeThis = juce::Component::SafePointer<AudioLevelStudioComponent>(this);
     auto options = juce::MessageBoxOptions()
         .withIconType(juce::MessageBoxIconType::WarningIcon)
@@ -1900,6 +2204,7 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
     juce::AlertWindow::showAsync(options, [safeThis,
                                            entries,
                                            presetSettings,
+                                           plan,
                                            exportMode,
                                            confirmOverwriteBackups](int result) mutable
     {
@@ -1908,10 +2213,10 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
 
         if (auto* comp = safeThis.getComponent())
         {
-            auto startBatch = [safeThis, entries, presetSettings, exportMode]() mutable
+            auto startBatch = [safeThis, entries, presetSettings, plan, exportMode]() mutable
             {
                 if (auto* compInner = safeThis.getComponent())
-                    compInner->beginBatchOperation(exportMode, std::move(*entries), presetSettings);
+                    compInner->beginBatchOperation(exportMode, std::move(*entries), presetSettings, plan);
             };
 
             if (confirmOverwriteBackups)
@@ -1940,19 +2245,21 @@ void AudioLevelStudioComponent::runBatchOperation(bool exportMode)
 
 void AudioLevelStudioComponent::beginBatchOperation(bool exportMode,
                                                     std::vector<BatchTrackEntry> entries,
-                                                    PresetSettings presetSettings)
+                                                    PresetSettings presetSettings,
+                                                    std::shared_ptr<const BatchPlan> plan)
 {
     if (entries.empty())
         return;
 
     showBatchProgressDialog(exportMode, static_cast<int>(entries.size()));
 
-    startBatchWorker(exportMode, std::move(entries), presetSettings);
+    startBatchWorker(exportMode, std::move(entries), presetSettings, std::move(plan));
 }
 
 void AudioLevelStudioComponent::startBatchWorker(bool exportMode,
                                                  std::vector<BatchTrackEntry> entries,
-                                                 PresetSettings presetSettings)
+                                                 PresetSettings presetSettings,
+                                                 std::shared_ptr<const BatchPlan> plan)
 {
     if (entries.empty())
         return;
@@ -1975,8 +2282,124 @@ void AudioLevelStudioComponent::startBatchWorker(bool exportMode,
     auto safeComponent = juce::Component::SafePointer<AudioLevelStudioComponent>(this);
     const bool backups = backupsEnabled;
 
+    auto postCompletion = [safeComponent, exportMode](int processed, int failures, juce::StringArray logLines,
+                                                      bool cancelled, std::shared_ptr<const BatchPlan> newPlan)
+    {
+        juce::MessageManager::callAsync(
+            [safeComponent, exportMode, processed, failures, logs = std::move(logLines), cancelled, newPlan]() mutable
+            {
+                if (auto* comp = safeComponent.getComponent())
+                    comp->handleBatchCompletion(exportMode, processed, failures, std::move(logs), cancelled, newPlan);
+            });
+    };
+
+    if (!exportMode)
+    {
+        // Dry run: tracks are only read, so they are analysed side by side and
+        // the results kept as the plan for the export that follows
+        batchWorker = std::make_unique<std::thread>(
+            [safeComponent, entries = std::move(entries), presetSettings, cache = analysisCache, postCompletion]() mutable
+            {
+                const int total = static_cast<int>(entries.size());
+                std::vector<BatchPlanTrack> results(entries.size());
+                std::vector<char> finished(entries.size(), 0);
+                std::atomic<int> completed { 0 };
+
+                juce::ThreadPool analysisPool(juce::jlimit(1, maxBatchAnalysisThreads, juce::SystemStats::getNumCpus()));
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    analysisPool.addJob([&, i]
+                    {
+                        const auto& entry = entries[i];
+                        results[i] = planBatchTrack(entry, presetSettings, *cache);
+                        finished[i] = 1;
+
+                        const auto& track = results[i];
+                        juce::String line;
+                        if (track.error.isNotEmpty())
+                            line = track.error;
+                        else if (presetSettings.packMatchEnabled)
+                            line = entry.suggestedName + ": " + juce::String(track.stats.rmsDb, 1) + " dB RMS, "
+                                 + juce::String(track.stats.truePeakDb, 1) + " dBTP, range "
+                                 + juce::String(track.stats.loudnessRangeDb, 1) + " dB";
+                        else
+                            line = entry.suggestedName + ": " + juce::String(track.gainDb, 2) + " dB toward " + track.description;
+                        const int done = ++completed;
+                        juce::MessageManager::callAsync([safeComponent, done, total, line]
+                        {
+                            if (auto* comp = safeComponent.getComponent())
+                                comp->updateBatchProgressDialog(done, total, line);
+                        });
+                    });
+                }
+
+                bool cancelled = false;
+                while (analysisPool.getNumJobs() > 0)
+                {
+                    auto* component = safeComponent.getComponent();
+                    if (component == nullptr)
+                    {
+                        analysisPool.removeAllJobs(true, -1);
+                        return;
+                    }
+
+                    if (!cancelled && component->batchCancelRequested.load())
+                    {
+                        // Tracks already being decoded finish; the queued ones are dropped
+                        cancelled = true;
+                        analysisPool.removeAllJobs(false, -1);
+                    }
+
+                    component->batchProgressPending.store(static_cast<double>(completed.load()) / total);
+                    juce::Thread::sleep(batchPollIntervalMs);
+                }
+
+                juce::StringArray logLines;
+                int processed = 0;
+                int failures = 0;
+                auto newPlan = std::make_shared<BatchPlan>();
+                newPlan->presetSettings = presetSettings;
+
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    if (finished[i] == 0)
+                        continue;
+
+                    const auto& track = results[i];
+                    if (track.error.isNotEmpty())
+                    {
+                        logLines.add(track.error);
+                        ++failures;
+                        continue;
+                    }
+
+                    newPlan->tracks[entries[i].pcmFile.getFullPathName()] = track;
+                    ++processed;
+                }
+
+                // Only a complete pack can be matched
+                if (presetSettings.packMatchEnabled && !cancelled)
+                    logLines.add(solvePackPlan(*newPlan, entries));
+
+                for (const auto& entry : entries)
+                {
+                    const auto found = newPlan->tracks.find(entry.pcmFile.getFullPathName());
+                    if (found != newPlan->tracks.end())
+                        logLines.add(entry.suggestedName + ": " + juce::String(found->second.gainDb, 2)
+                                     + " dB toward " + found->second.description);
+                }
+
+                if (cancelled)
+                    logLines.add("Batch cancelled with " + juce::String(total - completed.load()) + " track(s) remaining.");
+
+                postCompletion(processed, failures, std::move(logLines), cancelled, cancelled ? nullptr : newPlan);
+            });
+        return;
+    }
+
     batchWorker = std::make_unique<std::thread>(
-        [safeComponent, exportMode, entries = std::move(entries), presetSettings, backups]() mutable
+        [safeComponent, entries = std::move(entries), presetSettings, backups,
+         plan = std::move(plan), cache = analysisCache, postCompletion]() mutable
         {
             AudioFileHandler handler;
             MSU1Exporter exporter;
@@ -1986,6 +2409,33 @@ void AudioLevelStudioComponent::startBatchWorker(bool exportMode,
             const int total = static_cast<int>(entries.size());
             bool cancelled = false;
 
+            // Pick up an interrupted export with the same settings where it stopped
+            BatchExportJournal journal(entries.front().pcmFile.getParentDirectory());
+            const auto settingsSignature = describePresetSettings(presetSettings);
+            std::map<juce::String, BatchExportJournal::StartedTrack> unfinished;
+            const auto resumable = journal.findResumableTracks(settingsSignature, &unfinished);
+
+            juce::Array<juce::var> planRecord;
+            for (const auto& entry : entries)
+            {
+                auto* item = new juce::DynamicObject();
+                item->setProperty("file", entry.pcmFile.getFileName());
+                if (plan != nullptr)
+                {
+                    const auto found = plan->tracks.find(entry.pcmFile.getFullPathName());
+                    if (found != plan->tracks.end())
+                    {
+                        item->setProperty("plannedGainDb", found->second.gainDb);
+                        if (found->second.limitingDb > 0.0f)
+                            item->setProperty("plannedLimitingDb", found->second.limitingDb);
+                    }
+                }
+                planRecord.add(juce::var(item));
+            }
+
+            if (!journal.beginBatch(settingsSignature, planRecord, !resumable.empty() || !unfinished.empty()))
+                logLines.add(journal.getLastError());
+
             for (int i = 0; i < total; ++i)
             {
                 auto* component = safeComponent.getComponent();
@@ -2003,89 +2453,279 @@ void AudioLevelStudioComponent::startBatchWorker(bool exportMode,
 
                 const auto& entry = entries[static_cast<size_t>(i)];
                 juce::String iterationLog;
+
+                const auto completed = resumable.find(entry.pcmFile.getFileName());
+                if (completed != resumable.end() && BatchExportJournal::isStillCompleted(completed->second, entry.pcmFile))
+                {
+                    // Exported and backed up before the interruption; doing it again would back up the export
+                    journal.recordTrackSkipped(entry.pcmFile.getFileName());
+                    iterationLog = "Done earlier " + entry.suggestedName + ": " + juce::String(completed->second.gainDb, 2) + " dB";
+                    logLines.add(iterationLog);
+                    ++processed;
+
+                    component->batchProgressPending.store(static_cast<double>(i + 1) / total);
+                    component->postBatchProgressUpdate(i + 1, total, iterationLog);
+                    continue;
+                }
+
+                // Cut off mid-export with the original already moved aside: the PCM may be
+                // partial or already processed, so redo it from the backup and leave that in place
+                juce::File originalBackup;
+                const auto interrupted = unfinished.find(entry.pcmFile.getFileName());
+                if (interrupted != unfinished.end())
+                    originalBackup = BatchExportJournal::findOriginalBackup(interrupted->second);
+
+                const bool restoring = originalBackup != juce::File();
+                auto source = entry;
+                if (restoring)
+                    source.pcmFile = originalBackup;
+
+                // Execute the dry run's gain when the file is still the one it analysed
+                BatchPlanTrack track;
+                bool planned = false;
+                if (plan != nullptr)
+                {
+                    auto sourceKey = TrackAnalysisCache::makeKey(source.pcmFile);
+                    sourceKey.path = entry.pcmFile.getFullPathName();
+
+                    const auto found = plan->tracks.find(entry.pcmFile.getFullPathName());
+                    if (found != plan->tracks.end() && found->second.fileKey == sourceKey)
+                    {
+                        track = found->second;
+                        planned = true;
+                    }
+                }
+
                 juce::AudioBuffer<float> buffer;
                 double sampleRate = 0.0;
                 int64 loopPoint = -1;
+                bool succeeded = false;
 
-                if (!entry.pcmFile.existsAsFile())
+                if (!source.pcmFile.existsAsFile())
                 {
                     iterationLog = "Missing file for " + entry.suggestedName;
-                    logLines.add(iterationLog);
-                    ++failures;
                 }
-                else if (!handler.loadAudioFile(entry.pcmFile, buffer, sampleRate, &loopPoint))
+                else if (!handler.loadAudioFile(source.pcmFile, buffer, sampleRate, &loopPoint))
                 {
                     iterationLog = "Failed " + entry.suggestedName + ": " + handler.getLastError();
-                    logLines.add(iterationLog);
-                    ++failures;
                 }
                 else
                 {
-                    auto stats = NormalizationAnalyzer::analyzeBuffer(buffer);
-                    float gainDb = 0.0f;
-                    juce::String description;
-                    if (!calculatePresetGainForSettings(presetSettings, stats, gainDb, description))
+                    // Changed or new since the dry run: analyse the audio just decoded. A pack
+                    // match can't be redone for one track, so that has to wait for a new dry run
+                    if (!planned && presetSettings.packMatchEnabled)
+                        track.error = "Skipped " + entry.suggestedName + ": changed since the dry run; run it again to match the pack";
+                    else if (!planned)
+                        track = planBatchTrack(source, presetSettings, *cache, &buffer, sampleRate);
+
+                    if (!track.gainValid)
                     {
-                        iterationLog = "Skipped " + entry.suggestedName + ": preset unavailable";
-                        logLines.add(iterationLog);
-                        ++failures;
+                        iterationLog = track.error;
                     }
-                    else if (exportMode)
+                    else
                     {
-                        juce::AudioBuffer<float> processedBuffer(buffer);
-                        if (std::abs(gainDb) > 0.01f)
-                            NormalizationAnalyzer::applyGain(processedBuffer, gainDb);
-
-                        if (!exporter.exportPCM(entry.pcmFile,
-                                                processedBuffer,
-                                                loopPoint >= 0 ? loopPoint : -1,
-                                                backups))
+                        if (std::abs(track.gainDb) > 0.01f)
+                            NormalizationAnalyzer::applyGain(buffer, track.gainDb);
+
+                        if (presetSettings.limiterEnabled)
+                        {
+                            TruePeakLimiter::Settings limiterSettings;
+                            limiterSettings.ceilingDb = getLimiterCeilingDb(presetSettings);
+                            TruePeakLimiter::processBuffer(buffer, sampleRate, limiterSettings);
+                        }
+
+                        const bool backedUp = restoring || (backups && entry.pcmFile.existsAsFile());
+                        const auto backupFile = backedUp ? MSU1Exporter::getBackupFileFor(entry.pcmFile) : juce::File();
+
+                        // Recorded before anything moves, so a crash from here on can be resumed safely
+                        if (!journal.recordTrackStarted(entry.pcmFile.getFileName(), source.pcmFile, backupFile))
+                        {
+                            iterationLog = "Failed " + entry.suggestedName + ": " + journal.getLastError();
+                        }
+                        else if (!exporter.exportPCM(entry.pcmFile,
+                                                     buffer,
+                                                     loopPoint >= 0 ? loopPoint : -1,
+                                                     backups && !restoring))
                         {
                             iterationLog = "Failed to write " + entry.suggestedName + ": " + exporter.getLastError();
-                            logLines.add(iterationLog);
-                            ++failures;
                         }
                         else
                         {
-                            iterationLog = "OK " + entry.suggestedName + ": " + juce::String(gainDb, 2) +
-                                           " dB (" + description + ")";
-                            logLines.add(iterationLog);
-                            ++processed;
+                            journal.recordTrackDone(entry.pcmFile, track.gainDb, backupFile);
+                            iterationLog = "OK " + entry.suggestedName + ": " + juce::String(track.gainDb, 2) +
+                                           " dB (" + track.description + ")";
+                            succeeded = true;
                         }
                     }
-                    else
-                    {
-                        iterationLog = entry.suggestedName + ": " + juce::String(gainDb, 2) +
-                                       " dB toward " + description;
-                        logLines.add(iterationLog);
-                        ++processed;
-                    }
                 }
 
-                component->batchProgressPending.store(total > 0 ? static_cast<double>(i + 1) / total : 1.0);
-                if (component != nullptr)
-                    component->postBatchProgressUpdate(i + 1, total, iterationLog);
-            }
+                logLines.add(iterationLog);
+                if (succeeded)
+                {
+                    ++processed;
+                }
+                else
+                {
+                    journal.recordTrackFailed(entry.pcmFile.getFileName(), iterationLog);
+                    ++failures;
+                }
 
-            if (auto* component = safeComponent.getComponent())
-            {
-                juce::MessageManager::callAsync(
-                    [safeComponent, exportMode, processed, failures, logs = std::move(logLines), cancelled]() mutable
-                    {
-                        if (auto* comp = safeComponent.getComponent())
-                            comp->handleBatchCompletion(exportMode, processed, failures, std::move(logs), cancelled);
-                    });
+                component->batchProgressPending.store(static_cast<double>(i + 1) / total);
+                component->postBatchProgressUpdate(i + 1, total, iterationLog);
             }
+
+            journal.endBatch(cancelled);
+
+            if (safeComponent.getComponent() != nullptr)
+                postCompletion(processed, failures, std::move(logLines), cancelled, nullptr);
         });
 }
 
+juce::String AudioLevelStudioComponent::describePresetSettings(const PresetSettings& settings)
+{
+    juce::String text;
+    text << "preset=" << settings.presetId;
+    if (settings.manualTargetEnabled)
+        text << ";targetRms=" << juce::String(settings.manualTargetRmsDb, 2);
+    if (settings.manualPeakEnabled)
+        text << ";peak=" << juce::String(settings.manualPeakDbfs, 2);
+    if (settings.limiterEnabled)
+        text << ";limiter=" << juce::String(getLimiterCeilingDb(settings), 2);
+    if (settings.packMatchEnabled)
+        text << ";pack";
+    return text;
+}
+
+float AudioLevelStudioComponent::getLimiterCeilingDb(const PresetSettings& settings)
+{
+    return settings.manualPeakEnabled ? settings.manualPeakDbfs : -1.0f;
+}
+
+float AudioLevelStudioComponent::getActiveLimiterCeilingDb() const
+{
+    const auto settings = getCurrentPresetSettings();
+    return settings.limiterEnabled ? getLimiterCeilingDb(settings) : std::numeric_limits<float>::quiet_NaN();
+}
+
+AudioLevelStudioComponent::BatchPlanTrack AudioLevelStudioComponent::planBatchTrack(const BatchTrackEntry& entry,
+                                                                                    const PresetSettings& settings,
+                                                                                    TrackAnalysisCache& cache,
+                                                                                    const juce::AudioBuffer<float>* decodedAudio,
+                                                                                    double decodedSampleRate)
+{
+    jassert(decodedAudio == nullptr || decodedSampleRate > 0.0);
+    BatchPlanTrack track;
+
+    if (!entry.pcmFile.existsAsFile())
+    {
+        track.error = "Missing file for " + entry.suggestedName;
+        return track;
+    }
+
+    // Keyed before reading so a file rewritten meanwhile doesn't match the plan
+    track.fileKey = TrackAnalysisCache::makeKey(entry.pcmFile);
+
+    // Stats from an earlier batch run hold until the file changes; a row preview's lack the true peak and range
+    auto stats = cache.find(track.fileKey);
+    if (stats.has_value() && !stats->loudnessMeasured)
+        stats.reset();
+
+    if (!stats.has_value() && decodedAudio != nullptr)
+    {
+        stats = NormalizationAnalyzer::analyzeBuffer(*decodedAudio, decodedSampleRate);
+        cache.store(track.fileKey, *stats);
+    }
+    else if (!stats.has_value())
+    {
+        AudioFileHandler handler;
+        juce::AudioBuffer<float> buffer;
+        double sampleRate = 0.0;
+        int64 loopPoint = -1;
+        if (!handler.loadAudioFile(entry.pcmFile, buffer, sampleRate, &loopPoint))
+        {
+            track.error = "Failed " + entry.suggestedName + ": " + handler.getLastError();
+            return track;
+        }
+
+        stats = NormalizationAnalyzer::analyzeBuffer(buffer, sampleRate);
+        cache.store(track.fileKey, *stats);
+    }
+
+    track.stats = *stats;
+    if (!calculatePresetGainForSettings(settings, *stats, track.gainDb, track.description))
+    {
+        track.error = "Skipped " + entry.suggestedName + ": preset unavailable";
+        return track;
+    }
+
+    track.gainValid = true;
+    return track;
+}
+
+juce::String AudioLevelStudioComponent::solvePackPlan(BatchPlan& plan, const std::vector<BatchTrackEntry>& entries)
+{
+    std::vector<PackLoudnessSolver::Track> inputs;
+    std::vector<BatchPlanTrack*> tracks;
+    juce::StringArray names;
+
+    for (const auto& entry : entries)
+    {
+        const auto found = plan.tracks.find(entry.pcmFile.getFullPathName());
+        if (found == plan.tracks.end())
+            continue;
+
+        const auto& stats = found->second.stats;
+        inputs.push_back({ stats.rmsDb, stats.truePeakDb, stats.loudnessRangeDb });
+        tracks.push_back(&found->second);
+        names.add(entry.suggestedName);
+    }
+
+    // The preset's RMS target is where the pack would like to be; peak-only presets go as loud as they can
+    PackLoudnessSolver::Settings solverSettings;
+    const float preferredRms = getSelectedPresetTargetRms(plan.presetSettings);
+    if (std::isfinite(preferredRms))
+        solverSettings.preferredLoudnessDb = preferredRms;
+    solverSettings.ceilingDb = getLimiterCeilingDb(plan.presetSettings);
+    solverSettings.limitingBudgetDb = plan.presetSettings.limiterEnabled ? packLimitingBudgetDb : 0.0f;
+
+    const auto solution = PackLoudnessSolver::solve(inputs, solverSettings);
+    if (solution.constrainingTrack < 0)
+        return "No track is loud enough to match; gains left at the preset's.";
+
+    plan.packTargetDb = solution.targetLoudnessDb;
+    plan.packSpreadDb = solution.spreadDb;
+
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto& track = *tracks[i];
+        const auto& result = solution.tracks[i];
+        if (!result.included)
+        {
+            track.gainDb = 0.0f;
+            track.description = "silence, left as is";
+            continue;
+        }
+
+        track.gainDb = result.gainDb;
+        track.limitingDb = result.limitingDb;
+        track.description = juce::String(result.loudnessDb, 1) + " dB RMS (pack"
+                          + (result.constrained ? ", held by its peak)" : ")");
+        if (result.limitingDb > 0.05f)
+            track.description << ", " << juce::String(result.limitingDb, 1) << " dB limited";
+    }
+
+    return "Pack matched at " + juce::String(solution.targetLoudnessDb, 1) + " dB RMS, spread "
+         + juce::String(solution.spreadDb, 1) + " dB; "
+         + names[solution.constrainingTrack] + " has the least headroom.";
+}
+
 void AudioLevelStudioComponent::handleBatchCompletion(bool exportMode,
                                                       int processed,
                                                       int failures,
                                                       juce::StringArray logLines,
-                                                      bool cancelled)
+                                                      bool cancelled,
+                                                      std::shared_ptr<const BatchPlan> plan)
 {
-    juce::ignoreUnused(logLines);
     if (batchWorker && batchWorker->joinable())
     {
         batchWorker->join();
@@ -2102,10 +2742,10 @@ void AudioLevelStudioComponent::handleBatchCompletion(bool exportMode,
 
     juce::String summary;
     if (logLines.isEmpty())
-        summary = exportMode ? "No tracks exported." : "No tracks previewed.";
+        summary = exportMode ? "No tracks exported." : "No tracks analysed.";
     else
     {
-        summary << (exportMode ? "Exported " : "Previewed ")
+        summary << (exportMode ? "Exported " : "Analysed ")
                 << processed << " track" << (processed == 1 ? "" : "s");
         if (failures > 0)
             summary << " - " << failures << " failed";
@@ -2116,6 +2756,21 @@ void AudioLevelStudioComponent::handleBatchCompletion(bool exportMode,
     if (cancelled && logLines.isEmpty())
         summary = "Batch cancelled by user.";
 
+    // An export rewrites the files, so its plan is spent; a finished dry run becomes the next one
+    if (exportMode)
+        batchPlan.reset();
+    else if (plan != nullptr)
+    {
+        // Pack gains only exist once every track is in, after the per-track progress lines
+        if (plan->presetSettings.packMatchEnabled)
+            if (auto* view = batchProgressView.getComponent())
+                for (const auto& line : logLines)
+                    view->appendDetailLine(line);
+
+        batchPlan = std::move(plan);
+        summary << ". Batch Export will reuse these gains.";
+    }
+
     if (exportMode && backupsEnabled && processed > 0 && !cancelled && requestTrackListRefresh)
         requestTrackListRefresh();
 
@@ -2185,7 +2840,7 @@ void AudioLevelStudioComponent::updatePreviewPlaybackButtons()
     playAfterButton.setButtonText(active == BeforeAfterPreviewPlayer::Target::After ? "Stop" : "Play After");
 }
 
-void AudioLevelStudioComponent::syncBeforeAfterBuffers()
+void AudioLevelStudioComponent::syncBeforeAfterBuffers(std::function<void()> replaceBuffers)
 {
     const bool previewLocked = batchPreviewActive;
     const bool wasPlaying = beforeAfterPlayer.isPlaying() && !previewLocked;
@@ -2194,7 +2849,14 @@ void AudioLevelStudioComponent::syncBeforeAfterBuffers()
     if (wasPlaying)
         beforeAfterPlayer.stop();
 
-    rebuildProcessedBuffers();
+    // Detach the player before its buffers are reallocated under it
+    if (!previewLocked)
+        beforeAfterPlayer.setSourceBuffers(nullptr, nullptr, previewSampleRate);
+
+    if (replaceBuffers != nullptr)
+        replaceBuffers();
+    else
+        rebuildProcessedBuffers();
 
     if (previewLocked)
     {
@@ -2202,12 +2864,10 @@ void AudioLevelStudioComponent::syncBeforeAfterBuffers()
         return;
     }
 
-    const juce::AudioBuffer<float>* beforeBufferPtr = beforeProcessedBuffer.getNumSamples() > 0
+    // One buffer serves both targets; the player applies the preview gain to After
+    const juce::AudioBuffer<float>* bufferPtr = beforeProcessedBuffer.getNumSamples() > 0
         ? &beforeProcessedBuffer
         : nullptr;
-    const juce::AudioBuffer<float>* afterBufferPtr = afterProcessedBuffer.getNumSamples() > 0
-        ? &afterProcessedBuffer
-        : nullptr;
 
     double afterRate = 0.0;
     if (previewValid && previewSampleRate > 0.0)
@@ -2218,7 +2878,8 @@ void AudioLevelStudioComponent::syncBeforeAfterBuffers()
     const double beforeRate = referenceValid ? referenceSampleRate : afterRate;
     const double sourceRate = afterRate > 0.0 ? afterRate : beforeRate;
 
-    beforeAfterPlayer.setSourceBuffers(beforeBufferPtr, afterBufferPtr, sourceRate);
+    beforeAfterPlayer.setSourceBuffers(bufferPtr, bufferPtr, sourceRate);
+    beforeAfterPlayer.setAfterGain(previewValid ? pendingPreviewGainDb : 0.0f);
 
     if (wasPlaying)
     {
@@ -2245,21 +2906,18 @@ void AudioLevelStudioComponent::stopPreviewPlayback()
         waveformOverlay->setPlaybackCursorRatio(std::numeric_limits<double>::quiet_NaN());
 }
 
-void AudioLevelStudioComponent::timerCallback()
+void AudioLevelStudioComponent::updatePlaybackDisplay(const PlaybackSnapshot& snapshot)
 {
     updatePreviewPlaybackButtons();
 
-    double currentSeconds = 0.0;
-    double totalSeconds = 0.0;
-    const bool hasProgress = beforeAfterPlayer.getPlaybackProgress(currentSeconds, totalSeconds)
-        && totalSeconds > 0.0;
-    const bool shouldShowWaveformCursor = !batchPreviewActive && beforeAfterPlayer.isPlaying();
+    const bool hasProgress = snapshot.studioPlaying && snapshot.studioLength > 0.0;
+    const bool shouldShowWaveformCursor = !batchPreviewActive && snapshot.studioPlaying;
 
     if (waveformOverlay != nullptr)
     {
         if (shouldShowWaveformCursor && hasProgress)
         {
-            const double ratio = juce::jlimit(0.0, 1.0, currentSeconds / totalSeconds);
+            const double ratio = juce::jlimit(0.0, 1.0, snapshot.studioPosition / snapshot.studioLength);
             waveformOverlay->setPlaybackCursorRatio(ratio);
         }
         else
@@ -2268,13 +2926,9 @@ void AudioLevelStudioComponent::timerCallback()
         }
     }
 
-    if (batchInProgress.load())
+    if (snapshot.batchProgress >= 0.0 && std::abs(snapshot.batchProgress - batchProgressValue) > 0.001)
     {
-        const double pending = batchProgressPending.load();
-        if (std::abs(pending - batchProgressValue) > 0.001)
-        {
-            batchProgressValue = pending;
-            batchProgressBar.repaint();
-        }
+        batchProgressValue = snapshot.batchProgress;
+        batchProgressBar.repaint();
     }
 }
@@ -4,40 +4,65 @@
 #include <atomic>
 #include <functional>
 #include <limits>
+#include <map>
 #include <memory>
 #include <optional>
 #include <thread>
+#include <vector>
 #include "../Core/MSUProjectState.h"
 #include "../Audio/NormalizationAnalyzer.h"
 #include "../Audio/BeforeAfterPreviewPlayer.h"
+#include "../Audio/PackLoudnessSolver.h"
+#include "../Audio/TrackAnalysisCache.h"
 #include "MSUFileBrowser.h"
+#include "FrameScheduler.h"
 
 class BatchPreviewButton;
 class BatchReplaceButton;
 class BatchProgressView;
 
-class WaveformOverlayView : public juce::Component
+/**
+ * Before/after waveform overlay. The "after" trace is the before thumbnail
+ * drawn with the preview gain as its vertical zoom, since the preview only
+ * differs from the source by that constant; columns whose scaled peak would
+ * pass full scale are marked as clipping. Changing the gain is a repaint.
+ */
+class WaveformOverlayView : public juce::Component,
+                            private juce::ChangeListener
 {
 public:
-    WaveformOverlayView(juce::AudioThumbnail& beforeThumb,
-                        juce::AudioThumbnail& afterThumb);
+    explicit WaveformOverlayView(juce::AudioThumbnail& beforeThumb);
+    ~WaveformOverlayView() override;
+
     void paint(juce::Graphics& g) override;
+    void resized() override;
     void setColours(juce::Colour before, juce::Colour after);
     void setPlaybackCursorRatio(double ratio);
 
+    /** Show the after trace at gainDb relative to the before thumbnail, or hide it. */
+    void setAfterGain(bool showAfter, float gainDb);
+
 private:
     juce::AudioThumbnail& beforeThumbnail;
-    juce::AudioThumbnail& afterThumbnail;
     juce::Colour beforeColour { juce::Colours::green.withAlpha(0.7f) };
     juce::Colour afterColour { juce::Colours::aqua.withAlpha(0.7f) };
+    juce::Colour clipColour { juce::Colours::red };
     double playbackCursorRatio = std::numeric_limits<double>::quiet_NaN();
+    bool afterVisible = false;
+    float afterGain = 1.0f;
+
+    // Runs of pixel columns that clip at afterGain, rebuilt lazily from the thumbnail's peaks
+    std::vector<juce::Range<int>> clipRuns;
+    bool clipRunsValid = false;
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void updateClipRuns(const juce::Rectangle<int>& area, double totalLength);
 };
 
 /**
  * Audio Level Studio tab. Hosts loudness presets, stats, and waveform overlays.
  */
 class AudioLevelStudioComponent : public juce::Component,
-                                  private juce::Timer,
                                   private juce::TableListBoxModel
 {
 public:
@@ -51,6 +76,12 @@ public:
     void refreshFromProjectState();
     void generatePresetPreview();
     void stopPreviewPlayback();
+    
+    /** Refresh preview buttons, the playback cursor and batch progress; driven by the frame scheduler */
+    void updatePlaybackDisplay(const PlaybackSnapshot& snapshot);
+    
+    /** Progress of the running batch, 0..1, or -1 when none is running. Thread-safe. */
+    double getBatchProgress() const { return batchInProgress.load() ? batchProgressPending.load() : -1.0; }
     void setPlaybackStopper(std::function<void()> stopper) { requestPlaybackStop = std::move(stopper); }
     void setMSUContext(const juce::File& msuFile,
                        const juce::String& gameTitle,
@@ -59,12 +90,17 @@ public:
     juce::String getActivePresetDisplayName() const;
     bool hasManualOverridesActive() const;
     bool calculateActivePresetGain(float& gainDb, juce::String& description);
+
+    /** True-peak ceiling the export limiter should hold, or NaN when the limiter is off. */
+    float getActiveLimiterCeilingDb() const;
     void setMSULoadCallback(std::function<void()> loader)
     {
         requestExternalMSULoad = std::move(loader);
         updateBatchButtons();
     }
     void setBackupPreference(bool enabled) { backupsEnabled = enabled; }
+    /** Share loudness stats with other views, e.g. the MSU browser's Loudness column. */
+    void setAnalysisCache(std::shared_ptr<TrackAnalysisCache> cache) { analysisCache = std::move(cache); }
     void setTrackReplacementCallback(std::function<void(const MSUFileBrowser::TrackInfo&)> replacer)
     {
         requestTrackReplacement = std::move(replacer);
@@ -84,6 +120,103 @@ private:
         float manualTargetRmsDb = -18.0f;
         bool manualPeakEnabled = false;
         float manualPeakDbfs = -1.0f;
+        bool limiterEnabled = false;          // limit transients at the ceiling instead of capping the gain
+        bool packMatchEnabled = false;        // solve gains across the whole pack rather than per track
+
+        bool operator==(const PresetSettings& other) const
+        {
+            return presetId == other.presetId
+                && manualTargetEnabled == other.manualTargetEnabled
+                && manualTargetRmsDb == other.manualTargetRmsDb
+                && manualPeakEnabled == other.manualPeakEnabled
+                && manualPeakDbfs == other.manualPeakDbfs
+                && limiterEnabled == other.limiterEnabled
+                && packMatchEnabled == other.packMatchEnabled;
+        }
+    };
+
+    using SharedAudio = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+    // The trim, padding and loop end a player buffer was cut with, and from which audio
+    struct TrimPadKey
+    {
+        uint32 audioVersion = 0;
+        int64 trimStart = 0;
+        int64 paddingSamples = 0;
+        int64 loopEndSample = -1;
+
+        bool operator==(const TrimPadKey& other) const
+        {
+            return audioVersion == other.audioVersion
+                && trimStart == other.trimStart
+                && paddingSamples == other.paddingSamples
+                && loopEndSample == other.loopEndSample;
+        }
+    };
+
+    // Everything one preset preview request produces; the UI only swaps it in
+    struct PresetPreviewResult
+    {
+        uint32 requestId = 0;
+        TrimPadKey bufferKey;
+        NormalizationAnalyzer::AudioStats stats;
+        bool gainValid = false;
+        float gainDb = 0.0f;                      // After gain, 0 when the preset already matches
+        juce::String description;
+        juce::AudioBuffer<float> buffer;          // trimmed and padded as on export
+    };
+
+    // Analyses the reference audio (unless its stats are already known) and cuts the
+    // player buffer for one preset; superseded requests are cancelled
+    struct PresetPreviewJob : public juce::ThreadPoolJob
+    {
+        PresetPreviewJob(AudioLevelStudioComponent& component,
+                         SharedAudio audio,
+                         std::optional<NormalizationAnalyzer::AudioStats> knownStats,
+                         const PresetSettings& settings,
+                         const TrimPadKey& key,
+                         uint32 requestId);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<AudioLevelStudioComponent> owner;
+        SharedAudio sourceAudio;
+        std::optional<NormalizationAnalyzer::AudioStats> cachedStats;
+        PresetSettings presetSettings;
+        TrimPadKey bufferKey;
+        uint32 request;
+    };
+
+    struct RowPreviewResult
+    {
+        uint32 requestId = 0;
+        int row = -1;
+        juce::AudioBuffer<float> buffer;          // trimmed and padded like the project
+        double sampleRate = 0.0;
+        float gainDb = 0.0f;
+        juce::String error;                       // set when the track couldn't be previewed
+    };
+
+    // Decodes one batch row's PCM and works out its preset gain, reusing cached stats
+    struct RowPreviewJob : public juce::ThreadPoolJob
+    {
+        RowPreviewJob(AudioLevelStudioComponent& component,
+                      int rowNumber,
+                      const juce::File& pcmFile,
+                      const juce::String& trackName,
+                      std::shared_ptr<TrackAnalysisCache> cache,
+                      const PresetSettings& settings,
+                      const TrimPadKey& key,
+                      uint32 requestId);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<AudioLevelStudioComponent> owner;
+        int row;
+        juce::File file;
+        juce::String name;
+        std::shared_ptr<TrackAnalysisCache> analysisCache;
+        PresetSettings presetSettings;
+        TrimPadKey bufferKey;
+        uint32 request;
     };
 
     struct BatchTrackEntry
@@ -95,6 +228,29 @@ private:
         bool backupExists = false;
     };
 
+    // What a dry run worked out for one track
+    struct BatchPlanTrack
+    {
+        TrackAnalysisCache::Key fileKey;          // the file as it was analysed
+        bool gainValid = false;
+        float gainDb = 0.0f;
+        float limitingDb = 0.0f;                  // peak reduction the pack solve left to the limiter
+        NormalizationAnalyzer::AudioStats stats;
+        juce::String description;
+        juce::String error;                       // set when the track couldn't be analysed
+    };
+
+    // Result of the last dry run, executed by the next export with the same preset.
+    // Tracks whose file has changed since are analysed again, unless the gains
+    // were solved across the pack, which needs a fresh dry run instead.
+    struct BatchPlan
+    {
+        PresetSettings presetSettings;
+        std::map<juce::String, BatchPlanTrack> tracks;  // by full path
+        float packTargetDb = std::numeric_limits<float>::quiet_NaN();
+        float packSpreadDb = 0.0f;
+    };
+
     juce::String formatLengthString(double seconds) const;
     juce::String formatLoopRange(int64 loopStart, int64 loopEnd, double sampleRate) const;
     juce::String formatDbValue(float value) const;
@@ -112,26 +268,27 @@ private:
     PresetSettings getCurrentPresetSettings() const;
     void applyGainNonDestructively(float gainDb);
     void updateWaveformThumbnails(bool forceReferenceReset = false);
-    void refreshReferenceBuffer(const juce::AudioBuffer<float>& buffer,
-                                double sampleRate,
-                                const juce::File& sourceFile = {});
+    void refreshReferenceBuffer(double sampleRate, const juce::File& sourceFile = {});
     void clearWaveformData();
     void clearPreview();
     void updateWaveformLegend();
-    void applyPreviewBuffer(const juce::AudioBuffer<float>& buffer,
-                            double sampleRate,
-                            const juce::String& description,
-                            float gainDb,
-                            bool updateProjectState = true);
+    void updateAfterOverlay();
+    void cancelPresetPreview();
+    void presetPreviewReady(std::shared_ptr<PresetPreviewResult> result);
+    void applyPresetGain(bool gainValid, float gainDb, const juce::String& description);
+    TrimPadKey makeTrimPadKey(uint32 audioVersion) const;
+    void updateStatsLabels();
     void handlePreviewButtonPress(BeforeAfterPreviewPlayer::Target target);
     void updatePreviewPlaybackButtons();
-    void syncBeforeAfterBuffers();
-    void timerCallback() override;
-    void rebuildTrimPadBuffer(const juce::AudioBuffer<float>& source,
-                              juce::AudioBuffer<float>& destination,
-                              int64 trimStart,
-                              int64 paddingSamples,
-                              int64 loopEndSample);
+
+    /** Re-point the before/after player at the processed buffers, resuming playback if it was running.
+        replaceBuffers fills them in; by default they are rebuilt from the reference audio here. */
+    void syncBeforeAfterBuffers(std::function<void()> replaceBuffers = nullptr);
+    static void rebuildTrimPadBuffer(const juce::AudioBuffer<float>& source,
+                                     juce::AudioBuffer<float>& destination,
+                                     int64 trimStart,
+                                     int64 paddingSamples,
+                                     int64 loopEndSample);
     void rebuildProcessedBuffers();
     void syncAdvancedControls();
     void updateManualTargetValueLabel();
@@ -154,7 +311,8 @@ private:
     void runBatchOperation(bool exportMode);
     void beginBatchOperation(bool exportMode,
                              std::vector<BatchTrackEntry> entries,
-                             PresetSettings presetSettings);
+                             PresetSettings presetSettings,
+                             std::shared_ptr<const BatchPlan> plan);
     void showBatchProgressDialog(bool exportMode, int totalTracks);
     void updateBatchProgressDialog(int processed, int total, const juce::String& latestLine);
     void finalizeBatchProgressDialog(const juce::String& finalSummary);
@@ -167,19 +325,23 @@ private:
     void handleTrackPreviewToggle(int rowNumber);
     void handleTrackReplaceRequest(int rowNumber);
     bool previewBatchTrack(int rowNumber);
-    bool loadTrackPreviewData(const BatchTrackEntry& entry,
-                              juce::AudioBuffer<float>& sourceBuffer,
-                              juce::AudioBuffer<float>& processedBuffer,
-                              double& sampleRate);
-    void configureBatchPreviewPlayback(const juce::AudioBuffer<float>& sourceBuffer,
-                                       const juce::AudioBuffer<float>& processedBuffer,
-                                       double sampleRate);
+    void cancelRowPreview();
+    void rowPreviewReady(std::shared_ptr<RowPreviewResult> result);
     void stopActiveTrackPreview();
     void refreshBatchTableComponents();
     MSUFileBrowser::TrackInfo makeTrackInfo(const BatchTrackEntry& entry) const;
     void startBatchWorker(bool exportMode,
                           std::vector<BatchTrackEntry> entries,
-                          PresetSettings presetSettings);
+                          PresetSettings presetSettings,
+                          std::shared_ptr<const BatchPlan> plan);
+    static juce::String describePresetSettings(const PresetSettings& settings);
+    static float getLimiterCeilingDb(const PresetSettings& settings);
+    static BatchPlanTrack planBatchTrack(const BatchTrackEntry& entry,
+                                         const PresetSettings& settings,
+                                         TrackAnalysisCache& cache,
+                                         const juce::AudioBuffer<float>* decodedAudio = nullptr,
+                                         double decodedSampleRate = 0.0);
+    static juce::String solvePackPlan(BatchPlan& plan, const std::vector<BatchTrackEntry>& entries);
     bool hasExistingBackups(const std::vector<BatchTrackEntry>& entries) const;
     void promptBackupOverwriteConfirmation(std::function<void()> onConfirm,
                                            std::function<void()> onCancel);
@@ -187,7 +349,8 @@ private:
                                int processed,
                                int failures,
                                juce::StringArray logLines,
-                               bool cancelled);
+                               bool cancelled,
+                               std::shared_ptr<const BatchPlan> plan);
     void cancelBatchOperation();
 
     MSUProjectState& projectState;
@@ -227,6 +390,7 @@ private:
     juce::Slider manualTargetSlider;
     juce::Label manualTargetValueLabel;
     juce::ToggleButton peakCeilingToggle { "Manual peak ceiling" };
+    juce::ToggleButton limiterToggle { "Limit peaks instead of lowering gain" };
     juce::Slider peakCeilingSlider;
     juce::Label peakCeilingValueLabel;
     juce::Label advancedHelpLabel;
@@ -236,6 +400,8 @@ private:
     juce::TableListBox batchTrackTable;
     juce::Label batchPresetNote;
     juce::Label batchPreviewNote;
+    juce::TextButton batchDryRunButton { "Batch Dry Run" };
+    juce::ToggleButton packMatchToggle { "Match loudness across the pack" };
     juce::TextButton batchExportButton { "Batch Export" };
     juce::TextButton batchCancelButton { "Cancel Batch" };
     double batchProgressValue = 0.0;
@@ -243,21 +409,24 @@ private:
 
     NormalizationAnalyzer::AudioStats latestStats;
     bool hasStats = false;
+    uint32 statsAudioVersion = 0;
     bool backupsEnabled = true;
-    juce::AudioBuffer<float> previewBuffer;
     bool previewValid = false;
     float pendingPreviewGainDb = 0.0f;
     juce::String pendingPresetDescription;
     double previewSampleRate = 0.0;
+    juce::ThreadPool previewPool { 1 };
+    uint32 previewRequestId = 0;             // only the latest request's result is applied
 
     juce::AudioFormatManager formatManager;
     juce::AudioThumbnailCache thumbnailCache;
     juce::AudioThumbnail beforeThumbnail;
-    juce::AudioThumbnail afterThumbnail;
     std::unique_ptr<WaveformOverlayView> waveformOverlay;
-    juce::AudioBuffer<float> referenceBuffer;
-    juce::AudioBuffer<float> beforeProcessedBuffer;
-    juce::AudioBuffer<float> afterProcessedBuffer;
+    SharedAudio referenceAudio;              // the project's audio snapshot, shared with preview jobs
+    uint32 referenceAudioVersion = 0;
+    juce::AudioBuffer<float> beforeProcessedBuffer;   // played for both targets, After with the preview gain
+    TrimPadKey processedBufferKey;
+    bool processedBufferValid = false;
     bool referenceValid = false;
     juce::File referenceSourceFile;
     double referenceSampleRate = 44100.0;
@@ -265,6 +434,8 @@ private:
     float manualTargetRmsDb = -18.0f;
     bool manualPeakEnabled = false;
     float manualPeakDbfs = -1.0f;
+    bool limiterEnabled = false;
+    bool packMatchEnabled = false;
     bool updatingAdvancedControls = false;
     juce::File currentMSUFile;
     juce::String currentGameTitle;
@@ -274,10 +445,13 @@ private:
     std::atomic<double> batchProgressPending { 0.0 };
     std::atomic<bool> batchInProgress { false };
     std::atomic<bool> batchCancelRequested { false };
+    std::shared_ptr<const BatchPlan> batchPlan;    // from the last completed dry run
     int activeBatchPreviewRow = -1;
-    juce::AudioBuffer<float> batchPreviewBeforeBuffer;
-    juce::AudioBuffer<float> batchPreviewAfterBuffer;
+    juce::AudioBuffer<float> batchPreviewBuffer;
     double batchPreviewSampleRate = 44100.0;
+    std::shared_ptr<TrackAnalysisCache> analysisCache = std::make_shared<TrackAnalysisCache>();
+    juce::ThreadPool rowPreviewPool { 1 };
+    uint32 rowPreviewRequestId = 0;
     bool batchPreviewActive = false;
     static constexpr int minContentHeight = 2100;
     juce::Component::SafePointer<juce::DialogWindow> batchProgressDialog;
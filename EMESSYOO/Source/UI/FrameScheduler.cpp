@@ -0,0 +1,51 @@
+#include "FrameScheduler.h"
+
+//==============================================================================
+bool PlaybackSnapshot::operator==(const PlaybackSnapshot& other) const
+{
+    return playerPosition == other.playerPosition
+        && playerPlaying == other.playerPlaying
+        && previewPlaying == other.previewPlaying
+        && studioPlaying == other.studioPlaying
+        && studioPlayingAfter == other.studioPlayingAfter
+        && studioPosition == other.studioPosition
+        && studioLength == other.studioLength
+        && batchProgress == other.batchProgress;
+}
+
+//==============================================================================
+FrameScheduler::FrameScheduler(juce::Component& host, SnapshotSource source)
+    : snapshotSource(std::move(source)),
+      vBlankAttachment(&host, [this] { onVBlank(); })
+{
+}
+
+void FrameScheduler::addClient(juce::Component& component, FrameCallback callback)
+{
+    clients.push_back({ &component, std::move(callback), {}, false });
+    requestFrame();
+}
+
+void FrameScheduler::onVBlank()
+{
+    if (clients.empty() || !snapshotSource)
+        return;
+
+    const bool forced = forceNextFrame.exchange(false, std::memory_order_relaxed);
+    const auto snapshot = snapshotSource();
+
+    for (auto& client : clients)
+    {
+        auto* component = client.component.getComponent();
+        const bool showing = component != nullptr && component->isShowing();
+
+        // Hidden clients catch up with one dispatch when they next appear
+        if (showing && (forced || !client.wasShowing || snapshot != client.lastSeen))
+        {
+            client.callback(snapshot);
+            client.lastSeen = snapshot;
+        }
+
+        client.wasShowing = showing;
+    }
+}
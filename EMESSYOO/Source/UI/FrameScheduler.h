@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+ * Playback state sampled once per display frame. Every client handed the same
+ * snapshot sees the same moment, however long the others take to draw.
+ */
+struct PlaybackSnapshot
+{
+    double playerPosition = 0.0;       // Loop Editor player, seconds
+    bool playerPlaying = false;
+    bool previewPlaying = false;       // MSU browser track preview
+    bool studioPlaying = false;        // Audio Level Studio before/after preview
+    bool studioPlayingAfter = false;
+    double studioPosition = 0.0;       // seconds
+    double studioLength = 0.0;         // seconds
+    double batchProgress = -1.0;       // 0..1 while a batch runs, otherwise -1
+
+    bool operator==(const PlaybackSnapshot& other) const;
+    bool operator!=(const PlaybackSnapshot& other) const { return !(*this == other); }
+};
+
+//==============================================================================
+/**
+ * Drives every playback-following UI update from the display's vertical blank.
+ *
+ * Each frame takes one PlaybackSnapshot and passes it to the clients whose
+ * component is currently showing, but only when the snapshot differs from the
+ * last one that client saw or the component has just become visible. An idle
+ * app therefore does nothing per frame beyond taking the snapshot.
+ */
+class FrameScheduler
+{
+public:
+    //==============================================================================
+    using SnapshotSource = std::function<PlaybackSnapshot()>;
+    using FrameCallback = std::function<void(const PlaybackSnapshot&)>;
+
+    /**
+     * @param host Component whose peer's vertical blank paces the frames
+     * @param source Reads the players' lock-free state; called once per frame on the message thread
+     */
+    FrameScheduler(juce::Component& host, SnapshotSource source);
+
+    /** Run callback on frames where component is showing and the snapshot has changed for it. */
+    void addClient(juce::Component& component, FrameCallback callback);
+
+    /** Dispatch to every visible client on the next frame, e.g. after state outside the snapshot changed. Thread-safe. */
+    void requestFrame() noexcept { forceNextFrame.store(true, std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Client
+    {
+        juce::Component::SafePointer<juce::Component> component;
+        FrameCallback callback;
+        PlaybackSnapshot lastSeen;
+        bool wasShowing = false;
+    };
+
+    SnapshotSource snapshotSource;
+    std::vector<Client> clients;
+    std::atomic<bool> forceNextFrame { true };
+
+    // Declared last so no frame can arrive while the members above are being destroyed
+    juce::VBlankAttachment vBlankAttachment;
+
+    void onVBlank();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};
@@ -0,0 +1,33 @@
+#include "LazyTabContent.h"
+
+//==============================================================================
+LazyTabContent::LazyTabContent(Factory createContent)
+    : factory(std::move(createContent))
+{
+}
+
+juce::Component& LazyTabContent::getOrCreateContent()
+{
+    if (content == nullptr)
+    {
+        jassert(factory != nullptr);
+        content = &factory();
+        addAndMakeVisible(content);
+        content->setBounds(getLocalBounds());
+    }
+
+    return *content;
+}
+
+void LazyTabContent::resized()
+{
+    if (content != nullptr)
+        content->setBounds(getLocalBounds());
+}
+
+void LazyTabContent::visibilityChanged()
+{
+    // TabbedComponent makes a page visible when its tab is selected
+    if (isVisible())
+        getOrCreateContent();
+}
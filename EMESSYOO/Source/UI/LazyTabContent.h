@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+//==============================================================================
+/**
+ * Placeholder tab page that builds its real content the first time it is shown.
+ *
+ * TabbedComponent wants a component for every tab up front; this stands in for
+ * a heavy page until the tab is opened, or until code that needs the page
+ * asks for it through getOrCreateContent(). The created component is owned by
+ * whoever the factory handed it out from and is sized to fill this one.
+ */
+class LazyTabContent : public juce::Component
+{
+public:
+    //==============================================================================
+    using Factory = std::function<juce::Component&()>;
+
+    explicit LazyTabContent(Factory createContent);
+    ~LazyTabContent() override = default;
+
+    /** Build the content now if it hasn't been yet. */
+    juce::Component& getOrCreateContent();
+    bool hasContent() const noexcept { return content != nullptr; }
+
+    //==============================================================================
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    Factory factory;
+    juce::Component* content = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LazyTabContent)
+};
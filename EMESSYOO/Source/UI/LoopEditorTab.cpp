@@ -1,17 +1,23 @@
 #include "LoopEditorTab.h"
 
 LoopEditorTab::LoopEditorTab(WaveformView& waveform,
+                                                         SpectrogramView& spectrogram,
+                                                         LoopSuggestionsPanel& suggestions,
                                                          TransportControls& transport,
                                                          MSUFileBrowser& browser,
                                                          int browserHeightIn,
                                                          int transportHeightIn)
         : waveformView(waveform),
+            spectrogramView(spectrogram),
+            loopSuggestions(suggestions),
             transportControls(transport),
             msuFileBrowser(browser),
             browserHeight(browserHeightIn),
             transportHeight(transportHeightIn)
 {
     addAndMakeVisible(waveformView);
+    addAndMakeVisible(spectrogramView);
+    addAndMakeVisible(loopSuggestions);
     addAndMakeVisible(transportControls);
     addAndMakeVisible(msuFileBrowser);
 }
@@ -26,6 +32,12 @@ void LoopEditorTab::resized()
     // Transport controls sit above the browser.
     transportControls.setBounds(bounds.removeFromBottom(transportHeight));
 
+    // Loop suggestions sit to the right of the waveform.
+    loopSuggestions.setBounds(bounds.removeFromRight(suggestionsWidth));
+
+    // Spectrogram lane sits under the waveform, sharing its time axis.
+    spectrogramView.setBounds(bounds.removeFromBottom(juce::jmin(spectrogramHeight, bounds.getHeight() / 3)));
+
     // Waveform view occupies the remaining space.
     waveformView.setBounds(bounds);
 }
@@ -2,19 +2,23 @@
 
 #include <JuceHeader.h>
 #include "WaveformView.h"
+#include "SpectrogramView.h"
 #include "TransportControls.h"
 #include "MSUFileBrowser.h"
+#include "LoopSuggestionsPanel.h"
 
 /**
  * Container component for the legacy Loop Editor UI. It simply
- * arranges the waveform, transport controls, and MSU browser within
- * the tab content area so MainComponent can host it inside a tabbed
- * layout.
+ * arranges the waveform with its spectrogram lane, loop suggestions,
+ * transport controls, and MSU browser within the tab content area so MainComponent can host it inside
+ * a tabbed layout.
  */
 class LoopEditorTab : public juce::Component
 {
 public:
     LoopEditorTab(WaveformView& waveformView,
+                  SpectrogramView& spectrogramView,
+                  LoopSuggestionsPanel& loopSuggestions,
                   TransportControls& transportControls,
                   MSUFileBrowser& msuFileBrowser,
                   int browserHeight,
@@ -25,8 +29,13 @@ public:
 
 private:
     WaveformView& waveformView;
+    SpectrogramView& spectrogramView;
+    LoopSuggestionsPanel& loopSuggestions;
     TransportControls& transportControls;
     MSUFileBrowser& msuFileBrowser;
     int browserHeight;
     int transportHeight;
+
+    static constexpr int suggestionsWidth = 260;
+    static constexpr int spectrogramHeight = 140;
 };
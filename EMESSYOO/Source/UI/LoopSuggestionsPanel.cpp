@@ -0,0 +1,225 @@
+#include "LoopSuggestionsPanel.h"
+#include "CustomLookAndFeel.h"
+
+namespace
+{
+    constexpr int maxSuggestions = 8;
+    constexpr int cancelTimeoutMs = 2000;
+}
+
+//==============================================================================
+LoopSuggestionsPanel::SearchJob::SearchJob(LoopSuggestionsPanel& panel,
+                                           std::shared_ptr<const juce::AudioBuffer<float>> buffer,
+                                           double sampleRate,
+                                           uint32 version,
+                                           const LoopFinder::Settings& settings)
+    : juce::ThreadPoolJob("Loop search"),
+      owner(&panel),
+      finder(panel.finder),
+      audio(std::move(buffer)),
+      audioSampleRate(sampleRate),
+      audioVersion(version),
+      searchSettings(settings)
+{
+}
+
+juce::ThreadPoolJob::JobStatus LoopSuggestionsPanel::SearchJob::runJob()
+{
+    auto results = finder.findLoops(*audio, audioSampleRate, searchSettings, [this] { return shouldExit(); });
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto panel = owner;
+    const auto version = audioVersion;
+    juce::MessageManager::callAsync([panel, version, results = std::move(results)]() mutable
+    {
+        if (panel != nullptr)
+            panel->searchFinished(version, std::move(results));
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+LoopSuggestionsPanel::LoopSuggestionsPanel(MSUProjectState& state)
+    : projectState(state)
+{
+    addAndMakeVisible(headingLabel);
+    headingLabel.setText("Loop Suggestions", juce::dontSendNotification);
+    headingLabel.setFont(juce::FontOptions(16.0f, juce::Font::bold));
+    headingLabel.setColour(juce::Label::textColourId, CustomLookAndFeel::textColor);
+
+    addAndMakeVisible(findButton);
+    findButton.setTooltip("Search the track for seamless loop points");
+    findButton.onClick = [this] { findLoops(); };
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setColour(juce::Label::textColourId, CustomLookAndFeel::textColorDark);
+    statusLabel.setJustificationType(juce::Justification::topLeft);
+
+    addAndMakeVisible(suggestionList);
+    suggestionList.setModel(this);
+    suggestionList.setRowHeight(rowHeight);
+    suggestionList.setColour(juce::ListBox::backgroundColourId, CustomLookAndFeel::darkBackground);
+
+    projectState.addChangeListener(this);
+    lastAudioVersion = projectState.getAudioVersion();
+    updateStatus();
+}
+
+LoopSuggestionsPanel::~LoopSuggestionsPanel()
+{
+    projectState.removeChangeListener(this);
+
+    // The job uses finder and this panel until it returns, so wait however long that takes
+    searchPool.removeAllJobs(true, -1);
+}
+
+//==============================================================================
+void LoopSuggestionsPanel::paint(juce::Graphics& g)
+{
+    g.fillAll(CustomLookAndFeel::darkPanel);
+}
+
+void LoopSuggestionsPanel::resized()
+{
+    auto bounds = getLocalBounds().reduced(8);
+    headingLabel.setBounds(bounds.removeFromTop(24));
+    bounds.removeFromTop(4);
+    findButton.setBounds(bounds.removeFromTop(28));
+    bounds.removeFromTop(4);
+    statusLabel.setBounds(bounds.removeFromTop(36));
+    bounds.removeFromTop(4);
+    suggestionList.setBounds(bounds);
+}
+
+void LoopSuggestionsPanel::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source != &projectState)
+        return;
+
+    // Suggestions describe one version of the audio; drop them once it changes
+    if (projectState.getAudioVersion() != lastAudioVersion)
+    {
+        lastAudioVersion = projectState.getAudioVersion();
+        cancelSearch();
+        suggestions.clear();
+        suggestionList.updateContent();
+        updateStatus();
+    }
+
+    // Loop points moved: refresh which suggestion is highlighted as applied
+    suggestionList.repaint();
+}
+
+//==============================================================================
+void LoopSuggestionsPanel::findLoops()
+{
+    if (!projectState.hasAudio())
+        return;
+
+    cancelSearch();
+
+    LoopFinder::Settings settings;
+    settings.searchStart = projectState.getTrimStart();
+    settings.maxCandidates = maxSuggestions;
+
+    searching = true;
+    searchPool.addJob(new SearchJob(*this, projectState.getAudioSnapshot(), projectState.getSampleRate(),
+                                    projectState.getAudioVersion(), settings), true);
+    updateStatus();
+}
+
+void LoopSuggestionsPanel::cancelSearch()
+{
+    searchPool.removeAllJobs(true, cancelTimeoutMs);
+    searching = false;
+}
+
+void LoopSuggestionsPanel::searchFinished(uint32 version, std::vector<LoopFinder::Candidate> results)
+{
+    if (version != projectState.getAudioVersion())
+        return;
+
+    searching = false;
+    suggestions = std::move(results);
+    suggestionsVersion = version;
+    suggestionList.updateContent();
+    suggestionList.repaint();
+    updateStatus();
+}
+
+void LoopSuggestionsPanel::applySuggestion(int row)
+{
+    if (row < 0 || row >= getNumRows() || suggestionsVersion != projectState.getAudioVersion())
+        return;
+
+    const auto& suggestion = suggestions[static_cast<size_t>(row)];
+
+    // End first: setLoopEnd only pulls the start back if it would end up past the new end
+    projectState.setLoopEnd(suggestion.loopEnd);
+    projectState.setLoopStart(suggestion.loopStart);
+}
+
+void LoopSuggestionsPanel::updateStatus()
+{
+    juce::String text;
+    if (!projectState.hasAudio())
+        text = "Load audio to search for loops.";
+    else if (searching)
+        text = "Searching...";
+    else if (suggestions.empty())
+        text = "Find Loops ranks the most seamless loop points in the track.";
+    else
+        text = "Click a suggestion to apply its loop points.";
+
+    statusLabel.setText(text, juce::dontSendNotification);
+    findButton.setEnabled(projectState.hasAudio() && !searching);
+}
+
+juce::String LoopSuggestionsPanel::formatTime(int64 samples) const
+{
+    const double rate = projectState.getSampleRate() > 0.0 ? projectState.getSampleRate() : 44100.0;
+    const double seconds = static_cast<double>(samples) / rate;
+    const int totalSeconds = static_cast<int>(seconds);
+    const int millis = static_cast<int>((seconds - totalSeconds) * 1000.0);
+
+    return juce::String::formatted("%02d:%02d.%03d", totalSeconds / 60, totalSeconds % 60, millis);
+}
+
+//==============================================================================
+int LoopSuggestionsPanel::getNumRows()
+{
+    return static_cast<int>(suggestions.size());
+}
+
+void LoopSuggestionsPanel::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (rowNumber < 0 || rowNumber >= getNumRows())
+        return;
+
+    const auto& suggestion = suggestions[static_cast<size_t>(rowNumber)];
+    const bool applied = suggestion.loopStart == projectState.getLoopStart()
+                      && suggestion.loopEnd == projectState.getLoopEnd();
+
+    if (applied)
+        g.fillAll(CustomLookAndFeel::greenAccent.withAlpha(0.35f));
+    else if (rowIsSelected)
+        g.fillAll(CustomLookAndFeel::darkControl);
+
+    g.setColour(CustomLookAndFeel::textColor);
+    g.setFont(14.0f);
+    g.drawText(juce::String(rowNumber + 1) + ".  " + formatTime(suggestion.loopStart) + " - " + formatTime(suggestion.loopEnd),
+               8, 2, width - 16, height / 2, juce::Justification::centredLeft);
+
+    g.setColour(CustomLookAndFeel::textColorDark);
+    g.setFont(12.0f);
+    g.drawText("Length " + formatTime(suggestion.loopEnd - suggestion.loopStart)
+                   + "   Match " + juce::String(juce::roundToInt(suggestion.score * 100.0f)) + "%",
+               8, height / 2, width - 16, height / 2 - 2, juce::Justification::centredLeft);
+}
+
+void LoopSuggestionsPanel::listBoxItemClicked(int row, const juce::MouseEvent&)
+{
+    applySuggestion(row);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../Core/MSUProjectState.h"
+#include "../Audio/LoopFinder.h"
+
+//==============================================================================
+/**
+ * Side panel of the Loop Editor that runs LoopFinder in the background and
+ * lists the best loop candidates. Clicking a suggestion applies its loop
+ * points to the project. Suggestions are discarded whenever the audio changes.
+ */
+class LoopSuggestionsPanel : public juce::Component,
+                             public juce::ChangeListener,
+                             private juce::ListBoxModel
+{
+public:
+    //==============================================================================
+    explicit LoopSuggestionsPanel(MSUProjectState& state);
+    ~LoopSuggestionsPanel() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    /** Start a search over the current audio, cancelling any search in progress. */
+    void findLoops();
+
+private:
+    //==============================================================================
+    // Searches the project's shared audio snapshot, so the project can replace its audio meanwhile
+    struct SearchJob : public juce::ThreadPoolJob
+    {
+        SearchJob(LoopSuggestionsPanel& panel, std::shared_ptr<const juce::AudioBuffer<float>> buffer,
+                  double sampleRate, uint32 version, const LoopFinder::Settings& settings);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<LoopSuggestionsPanel> owner;
+        LoopFinder& finder;
+        std::shared_ptr<const juce::AudioBuffer<float>> audio;
+        double audioSampleRate;
+        uint32 audioVersion;
+        LoopFinder::Settings searchSettings;
+    };
+
+    MSUProjectState& projectState;
+    LoopFinder finder;
+    juce::ThreadPool searchPool { 1 };
+
+    juce::Label headingLabel;
+    juce::TextButton findButton { "Find Loops" };
+    juce::Label statusLabel;
+    juce::ListBox suggestionList;
+
+    std::vector<LoopFinder::Candidate> suggestions;
+    uint32 suggestionsVersion = 0;
+    uint32 lastAudioVersion = 0;
+    bool searching = false;
+
+    static constexpr int rowHeight = 40;
+
+    void cancelSearch();
+    void searchFinished(uint32 version, std::vector<LoopFinder::Candidate> results);
+    void applySuggestion(int row);
+    void updateStatus();
+    juce::String formatTime(int64 samples) const;
+
+    //==============================================================================
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemClicked(int row, const juce::MouseEvent& event) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopSuggestionsPanel)
+};
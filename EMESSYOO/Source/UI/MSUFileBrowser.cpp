@@ -1,6 +1,229 @@
 #include "MSUFileBrowser.h"
+#include "../Audio/AudioImporter.h"
 #include "../Export/MSUManifestUpdater.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t scanBatchSize = 16;            // rows posted to the table at a time,
+    constexpr uint32 scanPostIntervalMs = 50;       // or whatever is ready after this long on a slow drive
+    constexpr int cancelTimeoutMs = 2000;
+    constexpr int64 pcmHeaderSize = 8;              // "MSU1" then the little-endian loop point
+    constexpr int64 pcmBytesPerFrame = 4;           // 16-bit stereo
+
+    juce::String formatSampleTime(int64 samples)
+    {
+        const auto tenths = static_cast<int64>(std::round(static_cast<double>(samples) * 10.0 / AudioImporter::MSU1_SAMPLE_RATE));
+        const auto seconds = tenths % 600;
+        return juce::String(tenths / 600) + ":" + juce::String(seconds / 10).paddedLeft('0', 2) + "." + juce::String(seconds % 10);
+    }
+}
+
+//==============================================================================
+MSUFileBrowser::ScanJob::ScanJob(MSUFileBrowser& browser, const juce::File& manifest, uint32 id)
+    : juce::ThreadPoolJob("MSU scan"),
+      owner(&browser),
+      msuFile(manifest),
+      scanId(id)
+{
+}
+
+juce::ThreadPoolJob::JobStatus MSUFileBrowser::ScanJob::runJob()
+{
+    DBG("Loading MSU directory: " + msuFile.getFullPathName());
+    
+    // Get the base name from the MSU file (e.g., "game.msu" -> "game")
+    const auto baseName = msuFile.getFileNameWithoutExtension();
+    const auto directory = msuFile.getParentDirectory();
+    auto browser = owner;
+    const auto id = scanId;
+    
+    // Try to find and load SNES ROM file for metadata
+    auto romFiles = directory.findChildFiles(juce::File::findFiles, false, baseName + ".sfc;" + baseName + ".smc");
+    
+    if (romFiles.size() == 0)
+    {
+        // Try case-insensitive search
+        romFiles = directory.findChildFiles(juce::File::findFiles, false, "*.sfc;*.smc");
+    }
+    
+    juce::String title;
+    juce::String region;
+    if (romFiles.size() > 0)
+    {
+        try
+        {
+            SNESROMReader romReader;
+            if (romReader.loadROMFile(romFiles[0]))
+            {
+                title = romReader.getGameTitle();
+                region = romReader.getRegion();
+                DBG("ROM Title: " + title + " [" + region + "]");
+            }
+        }
+        catch (...)
+        {
+            DBG("Error reading ROM file: " + romFiles[0].getFullPathName());
+            title = "";
+        }
+    }
+    
+    const auto romFile = romFiles.size() > 0 ? romFiles[0] : juce::File();
+    juce::MessageManager::callAsync([browser, id, title, region, romFile]
+    {
+        if (browser != nullptr)
+            browser->scanTitleReady(id, title, region, romFile);
+    });
+    
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+    
+    auto trackTitles = readTrackTitles(msuFile);
+    
+    // Scan directory for PCM files matching the pattern: basename-N.pcm, and
+    // put them in track order before checking any of them
+    auto pcmFiles = directory.findChildFiles(juce::File::findFiles, false, baseName + "-*.pcm");
+    DBG("Found " + juce::String(pcmFiles.size()) + " PCM files");
+    
+    std::vector<std::pair<int, juce::File>> numberedFiles;
+    for (auto& pcmFile : pcmFiles)
+    {
+        auto fileName = pcmFile.getFileNameWithoutExtension();
+        
+        // Extract track number from filename (e.g., "game-1" -> 1)
+        auto lastDash = fileName.lastIndexOf("-");
+        if (lastDash >= 0)
+        {
+            int trackNum = fileName.substring(lastDash + 1).getIntValue();
+            if (trackNum > 0)
+                numberedFiles.emplace_back(trackNum, pcmFile);
+        }
+    }
+    
+    std::stable_sort(numberedFiles.begin(), numberedFiles.end(),
+        [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+    
+    std::vector<TrackInfo> rows;
+    auto lastPost = juce::Time::getMillisecondCounter();
+    auto postRows = [&]
+    {
+        juce::MessageManager::callAsync([browser, id, batch = std::move(rows)]() mutable
+        {
+            if (browser != nullptr)
+                browser->scanRowsReady(id, std::move(batch));
+        });
+        rows.clear();
+        lastPost = juce::Time::getMillisecondCounter();
+    };
+    
+    for (const auto& [trackNum, pcmFile] : numberedFiles)
+    {
+        if (shouldExit())
+            return juce::ThreadPoolJob::jobHasFinished;
+        
+        TrackInfo info;
+        info.trackNumber = trackNum;
+        info.fileName = pcmFile.getFileName();
+        info.file = pcmFile;
+        info.exists = true;
+        const auto backupFile = pcmFile.getParentDirectory()
+                                      .getChildFile("Backup")
+                                      .getChildFile(pcmFile.getFileName());
+        info.backupExists = backupFile.existsAsFile();
+        
+        // Check if we have a title for this track
+        const auto knownTitle = trackTitles.find(trackNum);
+        if (knownTitle != trackTitles.end())
+            info.title = knownTitle->second;
+        
+        rows.push_back(std::move(info));
+        
+        if (rows.size() >= scanBatchSize
+            || juce::Time::getMillisecondCounter() - lastPost >= scanPostIntervalMs)
+            postRows();
+    }
+    
+    if (!rows.empty())
+        postRows();
+    
+    juce::MessageManager::callAsync([browser, id]
+    {
+        if (browser != nullptr)
+            browser->scanFinished(id);
+    });
+    
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+MSUFileBrowser::MetadataJob::MetadataJob(MSUFileBrowser& browser, std::vector<juce::File> files, size_t first, uint32 id)
+    : juce::ThreadPoolJob("PCM metadata"),
+      owner(&browser),
+      rowFiles(std::move(files)),
+      firstRow(first),
+      scanId(id)
+{
+}
+
+juce::ThreadPoolJob::JobStatus MSUFileBrowser::MetadataJob::runJob()
+{
+    std::vector<TrackMetadata> metadata;
+    metadata.reserve(rowFiles.size());
+
+    for (const auto& file : rowFiles)
+    {
+        if (shouldExit())
+            return juce::ThreadPoolJob::jobHasFinished;
+        metadata.push_back(probeTrackHeader(file));
+    }
+
+    auto browser = owner;
+    const auto id = scanId;
+    const auto first = firstRow;
+    juce::MessageManager::callAsync([browser, id, first, results = std::move(metadata)]() mutable
+    {
+        if (browser != nullptr)
+            browser->metadataReady(id, first, std::move(results));
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+MSUFileBrowser::ROMHashJob::ROMHashJob(MSUFileBrowser& browser, const juce::File& rom, uint32 id)
+    : juce::ThreadPoolJob("ROM hash"),
+      owner(&browser),
+      romFile(rom),
+      scanId(id)
+{
+}
+
+juce::ThreadPoolJob::JobStatus MSUFileBrowser::ROMHashJob::runJob()
+{
+    const auto hashes = SNESROMReader::hashROMFile(romFile, [this] { return shouldExit(); });
+    if (!hashes.has_value())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    const auto identity = ROMDatabase::getShared()->find(*hashes);
+    DBG("ROM " + romFile.getFileName() + ": CRC32 " + hashes->crc32 + ", SHA-1 " + hashes->sha1
+        + (identity.has_value() ? " = " + identity->name : juce::String(" (unknown)")));
+
+    auto browser = owner;
+    const auto id = scanId;
+    juce::MessageManager::callAsync([browser, id, result = *hashes, identity]
+    {
+        if (browser != nullptr)
+            browser->romIdentified(id, result, identity);
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
 MSUFileBrowser::MSUFileBrowser()
 {
     addAndMakeVisible(loadButton);
@@ -17,10 +240,15 @@ MSUFileBrowser::MSUFileBrowser()
     table.setModel(this);
     table.setColour(juce::ListBox::outlineColourId, juce::Colours::grey);
     table.setOutlineThickness(1);
+    table.addMouseListener(this, true);
     
     // Add columns
     table.getHeader().addColumn("Track", 1, 60, 50, 80, juce::TableHeaderComponent::notResizable);
     table.getHeader().addColumn("Title / File Name", 2, 300, 100, -1, juce::TableHeaderComponent::defaultFlags);
+    table.getHeader().addColumn("Duration", 7, 70, 60, 90, juce::TableHeaderComponent::notResizable);
+    table.getHeader().addColumn("Loop", 8, 70, 60, 90, juce::TableHeaderComponent::notResizable);
+    table.getHeader().addColumn("Loop Length", 9, 80, 70, 100, juce::TableHeaderComponent::notResizable);
+    table.getHeader().addColumn("Loudness", 10, 80, 70, 100, juce::TableHeaderComponent::notResizable);
     table.getHeader().addColumn("Status", 3, 80, 60, 100, juce::TableHeaderComponent::notResizable);
     table.getHeader().addColumn("Backup Exists", 4, 120, 90, 160, juce::TableHeaderComponent::notResizable);
     table.getHeader().addColumn("Preview", 5, 100, 80, 120, juce::TableHeaderComponent::notResizable);
@@ -29,6 +257,10 @@ MSUFileBrowser::MSUFileBrowser()
 
 MSUFileBrowser::~MSUFileBrowser()
 {
+    scanPool.removeAllJobs(true, cancelTimeoutMs);
+    metadataPool.removeAllJobs(true, cancelTimeoutMs);
+    romHashPool.removeAllJobs(true, cancelTimeoutMs);
+    table.removeMouseListener(this);
     table.setModel(nullptr);
 }
 
@@ -93,6 +325,23 @@ void MSUFileBrowser::paintCell(juce::Graphics& g, int rowNumber, int columnId, i
         case 4: // Backup Exists
             text = track.backupExists ? "Yes" : "";
             break;
+        case 7: // Duration
+            if (track.metadataLoaded && track.totalSamples > 0)
+                text = formatSampleTime(track.totalSamples);
+            break;
+        case 8: // Loop point
+            if (track.metadataLoaded && track.loopPoint >= 0)
+                text = formatSampleTime(track.loopPoint);
+            break;
+        case 9: // Loop length
+            if (track.metadataLoaded && track.loopPoint >= 0)
+                text = formatSampleTime(track.totalSamples - track.loopPoint);
+            break;
+        case 10: // Loudness, once the Audio Level Studio has analysed this version of the file
+            if (track.metadataLoaded && analysisCache != nullptr)
+                if (auto stats = analysisCache->find(track.analysisKey))
+                    text = juce::String(stats->rmsDb, 1) + " dB";
+            break;
         case 5: // Preview (button is drawn separately)
         case 6: // Action (button is drawn separately)
             return;
@@ -132,23 +381,263 @@ juce::Component* MSUFileBrowser::refreshComponentForCell(int rowNumber, int colu
     return nullptr;
 }
 
+void MSUFileBrowser::selectedRowsChanged(int lastRowSelected)
+{
+    juce::ignoreUnused(lastRowSelected);
+    requestPreviewPrefetch();
+}
+
+//==============================================================================
+void MSUFileBrowser::mouseMove(const juce::MouseEvent& event)
+{
+    const auto position = event.getEventRelativeTo(&table).getPosition();
+    const int row = table.getRowContainingPosition(position.x, position.y);
+
+    if (row == hoveredRow)
+        return;
+
+    hoveredRow = row;
+    if (hoveredRow >= 0)
+        requestPreviewPrefetch();
+}
+
+void MSUFileBrowser::mouseExit(const juce::MouseEvent& event)
+{
+    juce::ignoreUnused(event);
+    hoveredRow = -1;
+}
+
+void MSUFileBrowser::requestPreviewPrefetch()
+{
+    if (!onPrefetchRequested)
+        return;
+
+    juce::Array<juce::File> files;
+    auto addRow = [this, &files](int row)
+    {
+        if (row >= 0 && row < static_cast<int>(tracks.size()) && tracks[static_cast<size_t>(row)].exists)
+            files.addIfNotAlreadyThere(tracks[static_cast<size_t>(row)].file);
+    };
+
+    // The hovered row is the most likely next click, then the rows around the current one
+    addRow(hoveredRow);
+
+    const int anchorRow = currentPreviewRow >= 0 ? currentPreviewRow : table.getSelectedRow();
+    if (anchorRow >= 0)
+    {
+        addRow(anchorRow);
+        for (int offset = 1; offset <= prefetchNeighbourCount; ++offset)
+        {
+            addRow(anchorRow + offset);
+            addRow(anchorRow - offset);
+        }
+    }
+
+    if (!files.isEmpty())
+        onPrefetchRequested(files);
+}
+
 //==============================================================================
 void MSUFileBrowser::loadMSUFile(const juce::File& msuFile)
 {
     if (!msuFile.existsAsFile())
         return;
 
+    cancelScan();
+
+    // Rescanning the same manifest overwrites its rows in place rather than emptying the table first
+    if (msuFile != currentMSUFile)
+    {
+        tracks.clear();
+        gameTitle.clear();
+        romFile = juce::File();
+        romHashes.reset();
+        romIdentity.reset();
+        table.updateContent();
+    }
+
     currentMSUFile = msuFile;
-    parseMSUManifest(msuFile);
+    scanning = true;
+    scannedRowCount = 0;
+    if (gameTitle.isEmpty())
+        gameTitleLabel.setText("Scanning " + msuFile.getFileNameWithoutExtension() + "...", juce::dontSendNotification);
+
+    scanPool.addJob(new ScanJob(*this, msuFile, scanId), true);
+}
+
+void MSUFileBrowser::cancelScan()
+{
+    ++scanId;
+    scanning = false;
+    scanPool.removeAllJobs(true, 0);
+    metadataPool.removeAllJobs(true, 0);
+    romHashPool.removeAllJobs(true, 0);
+}
+
+void MSUFileBrowser::scanTitleReady(uint32 id, const juce::String& title, const juce::String& region,
+                                    const juce::File& scannedROM)
+{
+    if (id != scanId)
+        return;
+
+    gameTitle = title;
+    romRegion = region;
+
+    // A rescan of the same pack keeps the identity it already has
+    if (scannedROM != romFile || !romHashes.has_value())
+    {
+        romFile = scannedROM;
+        romHashes.reset();
+        romIdentity.reset();
+        if (romFile.existsAsFile())
+            romHashPool.addJob(new ROMHashJob(*this, romFile, scanId), true);
+    }
+
+    updateGameTitleLabel();
+}
+
+void MSUFileBrowser::metadataReady(uint32 id, size_t firstRow, std::vector<TrackMetadata> metadata)
+{
+    if (id != scanId)
+        return;
+
+    for (size_t i = 0; i < metadata.size() && firstRow + i < tracks.size(); ++i)
+    {
+        auto& track = tracks[firstRow + i];
+        const auto& result = metadata[i];
+        if (track.file != result.file || !result.valid)
+            continue;
+
+        track.metadataLoaded = true;
+        track.totalSamples = result.totalSamples;
+        track.loopPoint = result.loopPoint;
+        track.analysisKey = result.analysisKey;
+    }
+
+    table.repaint();
+}
+
+MSUFileBrowser::TrackMetadata MSUFileBrowser::probeTrackHeader(const juce::File& file)
+{
+    TrackMetadata metadata;
+    metadata.file = file;
+
+    // Size and modification time come from one stat, shared with the analysis cache key
+    metadata.analysisKey = TrackAnalysisCache::makeKey(file);
+    if (metadata.analysisKey.fileSize < pcmHeaderSize)
+        return metadata;
+
+    // Map just the header's page rather than opening a stream over the whole file
+    juce::MemoryMappedFile header(file, juce::Range<int64>(0, pcmHeaderSize), juce::MemoryMappedFile::readOnly);
+    if (header.getData() == nullptr || header.getSize() < static_cast<size_t>(pcmHeaderSize))
+        return metadata;
+
+    const auto* bytes = static_cast<const char*>(header.getData());
+    if (std::memcmp(bytes, "MSU1", 4) != 0)
+        return metadata;
+
+    metadata.totalSamples = (metadata.analysisKey.fileSize - pcmHeaderSize) / pcmBytesPerFrame;
+    metadata.loopPoint = static_cast<int64>(juce::ByteOrder::littleEndianInt(bytes + 4));
+    if (metadata.loopPoint >= metadata.totalSamples)
+        metadata.loopPoint = 0;
+
+    metadata.valid = true;
+    return metadata;
+}
+
+void MSUFileBrowser::romIdentified(uint32 id, const SNESROMReader::ROMHashes& hashes,
+                                   std::optional<ROMDatabase::Entry> identity)
+{
+    if (id != scanId)
+        return;
+
+    romHashes = hashes;
+    romIdentity = std::move(identity);
+    updateGameTitleLabel();
+}
+
+void MSUFileBrowser::updateGameTitleLabel()
+{
+    if (gameTitle.isEmpty())
+    {
+        gameTitleLabel.setText("ROM file not found - " + currentMSUFile.getFileNameWithoutExtension(), juce::dontSendNotification);
+        gameTitleLabel.setTooltip({});
+        return;
+    }
+
+    juce::String text = gameTitle + " (" + romRegion + ")";
+    juce::String tooltip;
+
+    if (romHashes.has_value())
+    {
+        tooltip << romFile.getFileName() << "\nCRC32 " << romHashes->crc32 << "\nSHA-1 " << romHashes->sha1;
+
+        if (romIdentity.has_value())
+            text << " - " << romIdentity->name;
+        else
+            tooltip << "\nNot in the ROM database. Add No-Intro DAT files to "
+                    << ROMDatabase::getDefaultDirectory().getFullPathName() << " to identify it.";
+    }
+
+    gameTitleLabel.setText(text, juce::dontSendNotification);
+    gameTitleLabel.setTooltip(tooltip);
+}
+
+void MSUFileBrowser::scanRowsReady(uint32 id, std::vector<TrackInfo> rows)
+{
+    if (id != scanId)
+        return;
+
+    // The columns from the PCM headers follow a moment later
+    std::vector<juce::File> files;
+    for (const auto& row : rows)
+        files.push_back(row.file);
+    metadataPool.addJob(new MetadataJob(*this, std::move(files), scannedRowCount, scanId), true);
+
+    for (auto& row : rows)
+    {
+        DBG("Added track " + juce::String(row.trackNumber) + ": " + row.fileName +
+            (row.title.isNotEmpty() ? " (" + row.title + ")" : ""));
+
+        if (scannedRowCount < tracks.size())
+            tracks[scannedRowCount] = std::move(row);
+        else
+            tracks.push_back(std::move(row));
+        ++scannedRowCount;
+    }
+
     table.updateContent();
+    table.repaint();
+}
+
+void MSUFileBrowser::scanFinished(uint32 id)
+{
+    if (id != scanId)
+        return;
+
+    // Drop rows left over from an earlier scan of a pack that has since lost tracks
+    tracks.resize(scannedRowCount);
+    scanning = false;
+    table.updateContent();
+    table.repaint();
+
+    DBG("Total tracks loaded: " + juce::String(tracks.size()));
+
+    if (onTracksLoaded)
+        onTracksLoaded(currentMSUFile, gameTitle, tracks);
 }
 
 void MSUFileBrowser::clearTracks()
 {
+    cancelScan();
     tracks.clear();
     currentMSUFile = juce::File();
     gameTitle.clear();
+    romFile = juce::File();
+    romHashes.reset();
+    romIdentity.reset();
     gameTitleLabel.setText("No ROM loaded", juce::dontSendNotification);
+    gameTitleLabel.setTooltip({});
     table.updateContent();
     if (onTracksCleared)
         onTracksCleared();
@@ -187,60 +676,10 @@ void MSUFileBrowser::launchLoadDialog()
         });
 }
 
-void MSUFileBrowser::parseMSUManifest(const juce::File& msuFile)
+std::map<int, juce::String> MSUFileBrowser::readTrackTitles(const juce::File& msuFile)
 {
-    tracks.clear();
-    gameTitle = "";
-    
-    DBG("Loading MSU directory: " + msuFile.getFullPathName());
-    
-    // Get the base name from the MSU file (e.g., "game.msu" -> "game")
-    auto baseName = msuFile.getFileNameWithoutExtension();
-    auto directory = msuFile.getParentDirectory();
-    
-    DBG("Base name: " + baseName);
-    DBG("Directory: " + directory.getFullPathName());
-    
-    // Try to find and load SNES ROM file for metadata
-    auto romFiles = directory.findChildFiles(juce::File::findFiles, false, baseName + ".sfc;" + baseName + ".smc");
-    
-    if (romFiles.size() == 0)
-    {
-        // Try case-insensitive search
-        romFiles = directory.findChildFiles(juce::File::findFiles, false, "*.sfc;*.smc");
-    }
-    
-    if (romFiles.size() > 0)
-    {
-        try
-        {
-            SNESROMReader romReader;
-            if (romReader.loadROMFile(romFiles[0]))
-            {
-                gameTitle = romReader.getGameTitle();
-                auto region = romReader.getRegion();
-                
-                if (gameTitle.isNotEmpty())
-                {
-                    gameTitleLabel.setText(gameTitle + " (" + region + ")", juce::dontSendNotification);
-                    DBG("ROM Title: " + gameTitle + " [" + region + "]");
-                }
-            }
-        }
-        catch (...)
-        {
-            DBG("Error reading ROM file: " + romFiles[0].getFullPathName());
-            gameTitle = "";
-        }
-    }
-    
-    if (gameTitle.isEmpty())
-    {
-        gameTitleLabel.setText("ROM file not found - " + baseName, juce::dontSendNotification);
-    }
-    
-    // Parse manifest files for track titles
     std::map<int, juce::String> trackTitles;
+    auto directory = msuFile.getParentDirectory();
     
     // Try to read .msu manifest file
     if (msuFile.existsAsFile())
@@ -343,58 +782,7 @@ void MSUFileBrowser::parseMSUManifest(const juce::File& msuFile)
         }
     }
     
-    // Scan directory for PCM files matching the pattern: basename-N.pcm
-    auto pcmFiles = directory.findChildFiles(juce::File::findFiles, false, baseName + "-*.pcm");
-    
-    DBG("Found " + juce::String(pcmFiles.size()) + " PCM files");
-    
-    for (auto& pcmFile : pcmFiles)
-    {
-        auto fileName = pcmFile.getFileNameWithoutExtension();
-        
-        // Extract track number from filename (e.g., "game-1" -> 1)
-        auto lastDash = fileName.lastIndexOf("-");
-        if (lastDash >= 0)
-        {
-            auto trackNumStr = fileName.substring(lastDash + 1);
-            int trackNum = trackNumStr.getIntValue();
-            
-            if (trackNum > 0)
-            {
-                TrackInfo info;
-                info.trackNumber = trackNum;
-                info.fileName = pcmFile.getFileName();
-                info.file = pcmFile;
-                info.exists = true;
-                const auto backupFile = pcmFile.getParentDirectory()
-                                              .getChildFile("Backup")
-                                              .getChildFile(pcmFile.getFileName());
-                info.backupExists = backupFile.existsAsFile();
-                
-                // Check if we have a title for this track
-                if (trackTitles.find(trackNum) != trackTitles.end())
-                {
-                    info.title = trackTitles[trackNum];
-                }
-                
-                DBG("Added track " + juce::String(info.trackNumber) + ": " + info.fileName + 
-                    (info.title.isNotEmpty() ? " (" + info.title + ")" : ""));
-                
-                tracks.push_back(info);
-            }
-        }
-    }
-    
-    // Sort tracks by track number
-    std::sort(tracks.begin(), tracks.end(), 
-        [](const TrackInfo& a, const TrackInfo& b) { 
-            return a.trackNumber < b.trackNumber; 
-        });
-    
-    DBG("Total tracks loaded: " + juce::String(tracks.size()));
-
-    if (onTracksLoaded)
-        onTracksLoaded(currentMSUFile, gameTitle, tracks);
+    return trackTitles;
 }
 
 //==============================================================================
@@ -1,12 +1,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
+#include <vector>
+#include "../Audio/TrackAnalysisCache.h"
+#include "../Core/ROMDatabase.h"
 #include "../Core/SNESROMReader.h"
 
 //==============================================================================
 /**
  * Browser component for MSU-1 track management.
  * Displays tracks from an MSU manifest and allows replacing individual tracks.
+ *
+ * Loading a manifest scans its directory on a background thread; rows appear
+ * in track-number order as their files are checked, and onTracksLoaded fires
+ * once the scan is complete.
  */
 class MSUFileBrowser : public juce::Component,
                        public juce::TableListBoxModel
@@ -26,6 +34,11 @@ public:
     void paintRowBackground(juce::Graphics& g, int rowNumber, int width, int height, bool rowIsSelected) override;
     void paintCell(juce::Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
     juce::Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, juce::Component* existingComponentToUpdate) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+    
+    //==============================================================================
+    void mouseMove(const juce::MouseEvent& event) override;
+    void mouseExit(const juce::MouseEvent& event) override;
     
     //==============================================================================
     struct TrackInfo
@@ -36,15 +49,30 @@ public:
         juce::File file;
         bool exists = false;
         bool backupExists = false;
+        
+        // Read from the PCM header in the background once the row appears
+        bool metadataLoaded = false;
+        int64 totalSamples = 0;
+        int64 loopPoint = -1;               // -1 when the header couldn't be read
+        TrackAnalysisCache::Key analysisKey;
     };
     
+    /** Start scanning a manifest's directory, replacing any scan in progress. */
     void loadMSUFile(const juce::File& msuFile);
     void clearTracks();
+    bool isScanning() const { return scanning; }
     void refreshTable() { table.updateContent(); }
     void setInitialDirectory(const juce::File& directory);
+    
+    /** Where the Loudness column looks up stats measured elsewhere; tracks never analysed show none. */
+    void setAnalysisCache(std::shared_ptr<TrackAnalysisCache> cache) { analysisCache = std::move(cache); }
     juce::File getCurrentMSUFile() const { return currentMSUFile; }
     const std::vector<TrackInfo>& getTracks() const { return tracks; }
     juce::String getGameTitle() const { return gameTitle; }
+    
+    /** The pack ROM's hashes and database match, once the background hash has finished. */
+    std::optional<SNESROMReader::ROMHashes> getROMHashes() const { return romHashes; }
+    std::optional<ROMDatabase::Entry> getROMIdentity() const { return romIdentity; }
     juce::File getCurrentDirectory() const
     {
         if (currentMSUFile.existsAsFile())
@@ -59,6 +87,7 @@ public:
             table.repaintRow(currentPreviewRow); // Repaint old row
         currentPreviewRow = row; 
         table.repaintRow(row); // Repaint new row
+        requestPreviewPrefetch();
     }
     void clearPreviewingRow() { if (currentPreviewRow >= 0) { int oldRow = currentPreviewRow; currentPreviewRow = -1; table.repaintRow(oldRow); } }
     int getPreviewingRow() const { return currentPreviewRow; }
@@ -66,6 +95,7 @@ public:
     std::function<void(const TrackInfo&)> onReplaceTrack;
     std::function<void(const TrackInfo&)> onPreviewTrack;
     std::function<void()> onStopPreview;
+    std::function<void(const juce::Array<juce::File>&)> onPrefetchRequested;
     std::function<void(const juce::File&)> onDirectoryChanged;
     std::function<void(const juce::File&, const juce::String&, const std::vector<TrackInfo>&)> onTracksLoaded;
     std::function<void()> onTracksCleared;
@@ -75,15 +105,85 @@ public:
     
 private:
     //==============================================================================
+    // Reads the ROM header, manifests and PCM listing off the message thread,
+    // posting rows back in track-number order as their files are checked
+    struct ScanJob : public juce::ThreadPoolJob
+    {
+        ScanJob(MSUFileBrowser& browser, const juce::File& manifest, uint32 id);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<MSUFileBrowser> owner;
+        juce::File msuFile;
+        uint32 scanId;
+    };
+
+    // Header fields of one PCM file, as the metadata columns show them
+    struct TrackMetadata
+    {
+        juce::File file;
+        bool valid = false;
+        int64 totalSamples = 0;
+        int64 loopPoint = -1;
+        TrackAnalysisCache::Key analysisKey;
+    };
+
+    // Probes the 8-byte headers of a batch of rows just added by the scan
+    struct MetadataJob : public juce::ThreadPoolJob
+    {
+        MetadataJob(MSUFileBrowser& browser, std::vector<juce::File> files, size_t firstRow, uint32 id);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<MSUFileBrowser> owner;
+        std::vector<juce::File> rowFiles;
+        size_t firstRow;
+        uint32 scanId;
+    };
+
+    // Hashes the ROM and looks it up in the offline database; separate from the
+    // scan so a large ROM doesn't hold up the track rows
+    struct ROMHashJob : public juce::ThreadPoolJob
+    {
+        ROMHashJob(MSUFileBrowser& browser, const juce::File& rom, uint32 id);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<MSUFileBrowser> owner;
+        juce::File romFile;
+        uint32 scanId;
+    };
+
     juce::TextButton loadButton;
     juce::Label gameTitleLabel;
     
     juce::File currentMSUFile;
     juce::String gameTitle;
+    juce::String romRegion;
+    juce::File romFile;
+    std::optional<SNESROMReader::ROMHashes> romHashes;
+    std::optional<ROMDatabase::Entry> romIdentity;
     int currentPreviewRow = -1;
+    int hoveredRow = -1;
     juce::File lastMSUDirectory;
     
-    void parseMSUManifest(const juce::File& msuFile);
+    juce::ThreadPool scanPool { 1 };
+    juce::ThreadPool romHashPool { 1 };
+    juce::ThreadPool metadataPool { 1 };
+    std::shared_ptr<TrackAnalysisCache> analysisCache;
+    uint32 scanId = 0;                  // only the latest scan's results are applied
+    bool scanning = false;
+    size_t scannedRowCount = 0;         // rows the current scan has delivered; older rows past it are stale
+    
+    void cancelScan();
+    void scanTitleReady(uint32 id, const juce::String& title, const juce::String& region, const juce::File& romFile);
+    void metadataReady(uint32 id, size_t firstRow, std::vector<TrackMetadata> metadata);
+    static TrackMetadata probeTrackHeader(const juce::File& file);
+    void romIdentified(uint32 id, const SNESROMReader::ROMHashes& hashes, std::optional<ROMDatabase::Entry> identity);
+    void updateGameTitleLabel();
+    void scanRowsReady(uint32 id, std::vector<TrackInfo> rows);
+    void scanFinished(uint32 id);
+    static std::map<int, juce::String> readTrackTitles(const juce::File& msuFile);
+    void requestPreviewPrefetch();
+    
+    static constexpr int prefetchNeighbourCount = 2;
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MSUFileBrowser)
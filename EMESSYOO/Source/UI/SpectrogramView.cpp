@@ -0,0 +1,463 @@
+#include "SpectrogramView.h"
+#include "CustomLookAndFeel.h"
+
+#include <array>
+#include <cmath>
+
+namespace
+{
+    // FFT length follows the zoom: about four columns' worth of samples, within these bounds
+    constexpr int minFftOrder = 9;    // 512
+    constexpr int maxFftOrder = 12;   // 4096
+    constexpr double columnsPerFft = 4.0;
+
+    // When a column spans more samples than one FFT, average this many frames across it
+    constexpr int maxFramesPerColumn = 4;
+
+    // Levels below this are drawn black
+    constexpr float floorDb = -100.0f;
+
+    constexpr int cancelTimeoutMs = 2000;
+}
+
+//==============================================================================
+SpectrogramView::TileJob::TileJob(SpectrogramView& view,
+                                  MonoAudio audio,
+                                  double sampleRate,
+                                  const TileKey& key,
+                                  int64 tileIndex,
+                                  uint32 generation)
+    : juce::ThreadPoolJob("Spectrogram tile"),
+      owner(&view),
+      mono(std::move(audio)),
+      audioSampleRate(sampleRate),
+      tileKey(key),
+      tile(tileIndex),
+      tileGeneration(generation)
+{
+}
+
+juce::ThreadPoolJob::JobStatus SpectrogramView::TileJob::runJob()
+{
+    auto image = renderTile(*mono, audioSampleRate, tileKey, tile, [this] { return shouldExit(); });
+    if (!image.isValid() || shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto view = owner;
+    const auto index = tile;
+    const auto generation = tileGeneration;
+    juce::MessageManager::callAsync([view, index, generation, image]
+    {
+        if (view != nullptr)
+            view->tileReady(generation, index, image);
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+SpectrogramView::MixdownJob::MixdownJob(SpectrogramView& view,
+                                        std::shared_ptr<const juce::AudioBuffer<float>> buffer,
+                                        uint32 version)
+    : juce::ThreadPoolJob("Spectrogram mixdown"),
+      owner(&view),
+      audio(std::move(buffer)),
+      audioVersion(version)
+{
+}
+
+juce::ThreadPoolJob::JobStatus SpectrogramView::MixdownJob::runJob()
+{
+    const int numChannels = audio->getNumChannels();
+    const int numSamples = audio->getNumSamples();
+    if (numChannels == 0 || numSamples == 0)
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto mono = std::make_shared<std::vector<float>>(audio->getReadPointer(0), audio->getReadPointer(0) + numSamples);
+    for (int ch = 1; ch < numChannels && !shouldExit(); ++ch)
+        juce::FloatVectorOperations::add(mono->data(), audio->getReadPointer(ch), numSamples);
+    if (numChannels > 1)
+        juce::FloatVectorOperations::multiply(mono->data(), 1.0f / static_cast<float>(numChannels), numSamples);
+
+    if (shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+
+    auto view = owner;
+    const auto version = audioVersion;
+    MonoAudio result = std::move(mono);
+    juce::MessageManager::callAsync([view, version, result]
+    {
+        if (view != nullptr)
+            view->monoAudioReady(version, result);
+    });
+
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+//==============================================================================
+SpectrogramView::SpectrogramView(MSUProjectState& state, WaveformView& waveformToFollow)
+    : projectState(state),
+      waveformView(waveformToFollow),
+      renderPool(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1))
+{
+    setOpaque(true);
+    projectState.addChangeListener(this);
+    invalidateMonoAudio();
+}
+
+SpectrogramView::~SpectrogramView()
+{
+    projectState.removeChangeListener(this);
+    renderPool.removeAllJobs(true, cancelTimeoutMs);
+}
+
+//==============================================================================
+void SpectrogramView::paint(juce::Graphics& g)
+{
+    g.fillAll(CustomLookAndFeel::darkBackground);
+
+    const auto content = getContentBounds();
+    g.setColour(CustomLookAndFeel::darkPanel);
+    g.fillRect(content);
+
+    // Painting means the lane is showing: now the mixdown is worth making
+    if (monoAudio == nullptr && projectState.hasAudio())
+        requestMonoAudio();
+
+    const double visibleLength = waveformView.getVisibleEnd() - waveformView.getVisibleStart();
+    if (!projectState.hasAudio() || monoAudio == nullptr || content.isEmpty() || visibleLength <= 0.0)
+    {
+        g.setColour(CustomLookAndFeel::textColorDark);
+        g.setFont(12.0f);
+        g.drawText("Spectrogram", content.reduced(6, 2), juce::Justification::topLeft);
+        return;
+    }
+
+    const auto key = makeTileKey(content);
+    if (!key.matches(tileKey))
+    {
+        // Zoom, size, audio or offsets changed: every tile is stale
+        renderPool.removeAllJobs(true, 0);
+        tileCache.clear();
+        pendingTiles.clear();
+        tileKey = key;
+        ++generation;
+    }
+
+    // Tiles sit at fixed columns of the whole timeline, as in WaveformView
+    const double scrollPixels = waveformView.getVisibleStart() / tileKey.secondsPerPixel;
+    const int64 firstTile = static_cast<int64>(std::floor(scrollPixels / tileWidth));
+    const int64 lastTile = static_cast<int64>(std::floor((scrollPixels + content.getWidth()) / tileWidth));
+    const int64 originX = content.getX() - static_cast<int64>(std::llround(scrollPixels));
+
+    cancelTilesOutside(firstTile - prefetchTiles, lastTile + prefetchTiles);
+    requestTiles(firstTile - prefetchTiles, lastTile + prefetchTiles);
+
+    {
+        juce::Graphics::ScopedSaveState saveState(g);
+        g.reduceClipRegion(content);
+        const auto clip = g.getClipBounds();
+
+        for (int64 tile = firstTile; tile <= lastTile; ++tile)
+        {
+            const int tileX = static_cast<int>(originX + tile * tileWidth);
+            const juce::Rectangle<int> tileBounds(tileX, content.getY(), tileWidth, content.getHeight());
+            if (!tileBounds.intersects(clip))
+                continue;
+
+            auto cached = tileCache.find(tile);
+            if (cached == tileCache.end())
+                continue;
+
+            cached->second.lastUsed = ++useCounter;
+            g.drawImageAt(cached->second.image, tileX, content.getY());
+        }
+
+        drawMarkers(g, content);
+    }
+
+    // Frequency scale: linear from 0 Hz at the bottom to Nyquist at the top
+    g.setColour(CustomLookAndFeel::textColor.withAlpha(0.7f));
+    g.setFont(10.0f);
+    const double nyquistKHz = projectState.getSampleRate() * 0.5 / 1000.0;
+    g.drawText(juce::String(nyquistKHz, 1) + " kHz", content.reduced(4, 2), juce::Justification::topLeft);
+    g.drawText(juce::String(nyquistKHz * 0.5, 1) + " kHz",
+               content.withTrimmedTop(content.getHeight() / 2 - 6).withHeight(12).reduced(4, 0),
+               juce::Justification::centredLeft);
+
+    g.setColour(CustomLookAndFeel::darkControl);
+    g.drawRect(content, 1);
+}
+
+void SpectrogramView::resized()
+{
+    repaint();
+}
+
+void SpectrogramView::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source != &projectState)
+        return;
+
+    if (projectState.getAudioVersion() != monoAudioVersion)
+        invalidateMonoAudio();
+
+    // Trim and padding changes alter the tile key; paint() notices and starts over
+    repaint();
+}
+
+//==============================================================================
+void SpectrogramView::invalidateMonoAudio()
+{
+    // Also cancels a mixdown of the old audio still in progress
+    renderPool.removeAllJobs(true, 0);
+    tileCache.clear();
+    pendingTiles.clear();
+    ++generation;
+
+    monoAudioVersion = projectState.getAudioVersion();
+    monoAudio.reset();
+    mixdownPending = false;
+}
+
+void SpectrogramView::requestMonoAudio()
+{
+    if (mixdownPending)
+        return;
+
+    // The job mixes from the project's snapshot, so nothing is copied here
+    mixdownPending = true;
+    renderPool.addJob(new MixdownJob(*this, projectState.getAudioSnapshot(), monoAudioVersion), true);
+}
+
+void SpectrogramView::monoAudioReady(uint32 version, MonoAudio mono)
+{
+    if (version != monoAudioVersion || !mixdownPending)
+        return;
+
+    mixdownPending = false;
+    monoAudio = std::move(mono);
+    repaint();
+}
+
+juce::Rectangle<int> SpectrogramView::getContentBounds() const
+{
+    // Same inset as WaveformView, so both share one time axis
+    return getLocalBounds().reduced(4);
+}
+
+SpectrogramView::TileKey SpectrogramView::makeTileKey(const juce::Rectangle<int>& content) const
+{
+    TileKey key;
+    key.secondsPerPixel = (waveformView.getVisibleEnd() - waveformView.getVisibleStart()) / content.getWidth();
+    key.height = content.getHeight();
+    key.audioVersion = monoAudioVersion;
+    key.effectiveStart = projectState.getEffectivePlaybackStart();
+    key.paddingSamples = projectState.getPaddingSamples();
+    return key;
+}
+
+void SpectrogramView::requestTiles(int64 firstTile, int64 lastTile)
+{
+    const double sampleRate = projectState.getSampleRate();
+    const int64 timelineSamples = static_cast<int64>(monoAudio->size()) - tileKey.effectiveStart + tileKey.paddingSamples;
+    const double timelinePixels = static_cast<double>(timelineSamples) / (tileKey.secondsPerPixel * sampleRate);
+    const int64 finalTile = static_cast<int64>(std::floor(timelinePixels / tileWidth));
+
+    for (int64 tile = juce::jmax<int64>(0, firstTile); tile <= juce::jmin(lastTile, finalTile); ++tile)
+    {
+        if (tileCache.count(tile) > 0 || pendingTiles.count(tile) > 0)
+            continue;
+
+        pendingTiles.insert(tile);
+        renderPool.addJob(new TileJob(*this, monoAudio, sampleRate, tileKey, tile, generation), true);
+    }
+}
+
+void SpectrogramView::cancelTilesOutside(int64 firstTile, int64 lastTile)
+{
+    // Queued tiles that scrolled out of reach would only delay the ones now on screen
+    struct OutsideRange : public juce::ThreadPool::JobSelector
+    {
+        int64 first, last;
+        OutsideRange(int64 f, int64 l) : first(f), last(l) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* tileJob = dynamic_cast<TileJob*>(job);
+            return tileJob != nullptr && (tileJob->tile < first || tileJob->tile > last);
+        }
+    };
+
+    OutsideRange selector(firstTile, lastTile);
+    renderPool.removeAllJobs(false, 0, &selector);
+
+    for (auto it = pendingTiles.begin(); it != pendingTiles.end();)
+    {
+        if (*it < firstTile || *it > lastTile)
+            it = pendingTiles.erase(it);
+        else
+            ++it;
+    }
+}
+
+void SpectrogramView::tileReady(uint32 tileGeneration, int64 tile, juce::Image image)
+{
+    if (tileGeneration != generation)
+        return;
+
+    pendingTiles.erase(tile);
+    tileCache[tile] = { std::move(image), ++useCounter };
+    evictTiles();
+    repaint();
+}
+
+void SpectrogramView::evictTiles()
+{
+    // Least recently drawn first
+    while (static_cast<int>(tileCache.size()) > maxCachedTiles)
+    {
+        auto oldest = tileCache.begin();
+        for (auto it = tileCache.begin(); it != tileCache.end(); ++it)
+        {
+            if (it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+        }
+        tileCache.erase(oldest);
+    }
+}
+
+void SpectrogramView::drawMarkers(juce::Graphics& g, const juce::Rectangle<int>& content) const
+{
+    const auto drawMarker = [&](int64 sample, juce::Colour colour)
+    {
+        const int x = xAtSample(sample, content);
+        if (x < content.getX() || x > content.getRight())
+            return;
+
+        g.setColour(colour.withAlpha(0.8f));
+        g.drawVerticalLine(x, static_cast<float>(content.getY()), static_cast<float>(content.getBottom()));
+    };
+
+    drawMarker(projectState.getTrimStart() - projectState.getPaddingSamples(), juce::Colours::yellow);
+
+    if (projectState.hasLoopPoints())
+    {
+        drawMarker(projectState.getLoopStart(), CustomLookAndFeel::greenAccentBright);
+        drawMarker(projectState.getLoopEnd(), juce::Colours::orange);
+    }
+}
+
+int SpectrogramView::xAtSample(int64 sample, const juce::Rectangle<int>& content) const
+{
+    const double sampleRate = projectState.getSampleRate();
+    const double visibleStart = waveformView.getVisibleStart();
+    const double visibleLength = waveformView.getVisibleEnd() - visibleStart;
+    if (sampleRate <= 0.0 || visibleLength <= 0.0)
+        return content.getX() - 1;
+
+    // Same timeline mapping as WaveformView: padding first, then audio from the effective start
+    const int64 timelineSample = juce::jmax<int64>(0, sample - projectState.getEffectivePlaybackStart()
+                                                          + projectState.getPaddingSamples());
+    const double ratio = (static_cast<double>(timelineSample) / sampleRate - visibleStart) / visibleLength;
+    return content.getX() + static_cast<int>(ratio * content.getWidth());
+}
+
+//==============================================================================
+juce::Image SpectrogramView::renderTile(const std::vector<float>& mono,
+                                        double sampleRate,
+                                        const TileKey& key,
+                                        int64 tileIndex,
+                                        const std::function<bool()>& shouldExit)
+{
+    const int height = key.height;
+    const double samplesPerPixel = key.secondsPerPixel * sampleRate;
+    if (height <= 0 || samplesPerPixel <= 0.0)
+        return {};
+
+    int fftOrder = minFftOrder;
+    while (fftOrder < maxFftOrder && (1 << fftOrder) < samplesPerPixel * columnsPerFft)
+        ++fftOrder;
+
+    const int fftSize = 1 << fftOrder;
+    const int numBins = fftSize / 2;
+    const int framesPerColumn = juce::jlimit(1, maxFramesPerColumn, static_cast<int>(samplesPerPixel / fftSize) + 1);
+
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> frame(static_cast<size_t>(fftSize) * 2);
+    std::vector<float> power(static_cast<size_t>(numBins) + 1);
+
+    // A full-scale sine through a Hann window peaks at fftSize / 4 in its bin
+    const float fullScalePower = static_cast<float>(fftSize) * static_cast<float>(fftSize) / 16.0f;
+
+    // Timeline sample t shows project sample t + offset; anything before the effective start is padding
+    const int64 numSamples = static_cast<int64>(mono.size());
+    const int64 offset = key.effectiveStart - key.paddingSamples;
+
+    juce::Image image(juce::Image::RGB, tileWidth, height, true, juce::SoftwareImageType());
+    juce::Image::BitmapData pixels(image, juce::Image::BitmapData::writeOnly);
+
+    for (int column = 0; column < tileWidth; ++column)
+    {
+        if (shouldExit && shouldExit())
+            return {};
+
+        const double columnStart = static_cast<double>(tileIndex * tileWidth + column) * samplesPerPixel
+                                 + static_cast<double>(offset);
+        std::fill(power.begin(), power.end(), 0.0f);
+
+        for (int f = 0; f < framesPerColumn; ++f)
+        {
+            const auto centre = static_cast<int64>(columnStart + (f + 0.5) * samplesPerPixel / framesPerColumn);
+            const int64 frameStart = centre - fftSize / 2;
+
+            std::fill(frame.begin(), frame.end(), 0.0f);
+            const int64 from = juce::jmax(frameStart, key.effectiveStart, int64(0));
+            const int64 to = juce::jmin(frameStart + fftSize, numSamples);
+            for (int64 i = from; i < to; ++i)
+                frame[static_cast<size_t>(i - frameStart)] = mono[static_cast<size_t>(i)];
+
+            window.multiplyWithWindowingTable(frame.data(), static_cast<size_t>(fftSize));
+            fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+            for (int bin = 0; bin <= numBins; ++bin)
+                power[static_cast<size_t>(bin)] += frame[static_cast<size_t>(bin)] * frame[static_cast<size_t>(bin)];
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            // Loudest bin under the row, so narrow tones survive when bins outnumber rows
+            const int binLow = static_cast<int>(static_cast<double>(height - 1 - y) / height * numBins);
+            const int binHigh = juce::jmax(binLow + 1, static_cast<int>(static_cast<double>(height - y) / height * numBins));
+
+            float rowPower = 0.0f;
+            for (int bin = binLow; bin < juce::jmin(binHigh, numBins + 1); ++bin)
+                rowPower = juce::jmax(rowPower, power[static_cast<size_t>(bin)]);
+
+            const float db = 10.0f * std::log10(rowPower / (fullScalePower * framesPerColumn) + 1.0e-12f);
+            pixels.setPixelColour(column, y, colourForLevel((db - floorDb) / -floorDb));
+        }
+    }
+
+    return image;
+}
+
+juce::Colour SpectrogramView::colourForLevel(float normalisedLevel)
+{
+    static const auto palette = []
+    {
+        juce::ColourGradient gradient(juce::Colours::black, 0.0f, 0.0f, juce::Colour(0xffffffc0), 1.0f, 0.0f, false);
+        gradient.addColour(0.3, juce::Colour(0xff1c1c78));
+        gradient.addColour(0.55, juce::Colour(0xff8e2a9e));
+        gradient.addColour(0.8, juce::Colour(0xfff07d1a));
+
+        std::array<juce::Colour, 256> colours;
+        for (size_t i = 0; i < colours.size(); ++i)
+            colours[i] = gradient.getColourAtPosition(static_cast<double>(i) / (colours.size() - 1));
+        return colours;
+    }();
+
+    const auto index = static_cast<size_t>(juce::jlimit(0, 255, juce::roundToInt(normalisedLevel * 255.0f)));
+    return palette[index];
+}
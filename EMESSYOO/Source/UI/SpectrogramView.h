@@ -0,0 +1,130 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "../Core/MSUProjectState.h"
+#include "WaveformView.h"
+
+//==============================================================================
+/**
+ * Spectrogram lane that follows a WaveformView's zoom and scroll position.
+ *
+ * The view is cut into fixed-width tiles along the timeline. Each tile's STFT
+ * is computed and coloured on a worker pool, with the FFT size and the
+ * number of frames averaged per column chosen from the current zoom, and the
+ * finished images are kept in a least-recently-used cache. Painting only
+ * draws cached tiles, so scrolling never waits on the analysis; tiles that
+ * are still being computed show as blank until they arrive.
+ *
+ * The tiles read a mono mixdown made on the pool once per audio version, the
+ * first time the lane is painted with that audio, so a hidden lane costs nothing.
+ */
+class SpectrogramView : public juce::Component,
+                        public juce::ChangeListener
+{
+public:
+    //==============================================================================
+    SpectrogramView(MSUProjectState& state, WaveformView& waveformToFollow);
+    ~SpectrogramView() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+private:
+    //==============================================================================
+    using MonoAudio = std::shared_ptr<const std::vector<float>>;
+
+    // Everything a tile depends on apart from its position
+    struct TileKey
+    {
+        double secondsPerPixel = 0.0;
+        int height = 0;
+        uint32 audioVersion = 0;
+        int64 effectiveStart = 0;
+        int64 paddingSamples = 0;
+
+        bool matches(const TileKey& other) const
+        {
+            // Scrolling recomputes the visible range, so allow for rounding in the zoom
+            return std::abs(secondsPerPixel - other.secondsPerPixel) <= secondsPerPixel * 1.0e-9
+                && height == other.height
+                && audioVersion == other.audioVersion
+                && effectiveStart == other.effectiveStart
+                && paddingSamples == other.paddingSamples;
+        }
+    };
+
+    // Computes one tile from the shared mono mixdown
+    struct TileJob : public juce::ThreadPoolJob
+    {
+        TileJob(SpectrogramView& view, MonoAudio audio, double sampleRate,
+                const TileKey& key, int64 tileIndex, uint32 generation);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<SpectrogramView> owner;
+        MonoAudio mono;
+        double audioSampleRate;
+        TileKey tileKey;
+        int64 tile;
+        uint32 tileGeneration;
+    };
+
+    // Mixes the project's shared audio snapshot down to mono for the tiles
+    struct MixdownJob : public juce::ThreadPoolJob
+    {
+        MixdownJob(SpectrogramView& view, std::shared_ptr<const juce::AudioBuffer<float>> buffer, uint32 version);
+        JobStatus runJob() override;
+
+        juce::Component::SafePointer<SpectrogramView> owner;
+        std::shared_ptr<const juce::AudioBuffer<float>> audio;
+        uint32 audioVersion;
+    };
+
+    struct CachedTile
+    {
+        juce::Image image;
+        uint64 lastUsed = 0;
+    };
+
+    static constexpr int tileWidth = 256;
+    static constexpr int maxCachedTiles = 48;
+    static constexpr int prefetchTiles = 1;  // tiles either side of the view computed ahead
+
+    MSUProjectState& projectState;
+    WaveformView& waveformView;
+    juce::ThreadPool renderPool;
+
+    MonoAudio monoAudio;
+    uint32 monoAudioVersion = 0;
+    bool mixdownPending = false;
+
+    TileKey tileKey;
+    uint32 generation = 0;                    // bumped whenever tileKey changes, to drop stale results
+    std::map<int64, CachedTile> tileCache;    // keyed by tile index along the timeline
+    std::set<int64> pendingTiles;
+    uint64 useCounter = 0;
+
+    void invalidateMonoAudio();
+    void requestMonoAudio();
+    void monoAudioReady(uint32 version, MonoAudio mono);
+    juce::Rectangle<int> getContentBounds() const;
+    TileKey makeTileKey(const juce::Rectangle<int>& content) const;
+    void requestTiles(int64 firstTile, int64 lastTile);
+    void cancelTilesOutside(int64 firstTile, int64 lastTile);
+    void tileReady(uint32 tileGeneration, int64 tile, juce::Image image);
+    void evictTiles();
+    void drawMarkers(juce::Graphics& g, const juce::Rectangle<int>& content) const;
+    int xAtSample(int64 sample, const juce::Rectangle<int>& content) const;
+
+    static juce::Image renderTile(const std::vector<float>& mono, double sampleRate,
+                                  const TileKey& key, int64 tileIndex,
+                                  const std::function<bool()>& shouldExit);
+    static juce::Colour colourForLevel(float normalisedLevel);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramView)
+};
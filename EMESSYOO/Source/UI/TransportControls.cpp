@@ -64,6 +64,27 @@ TransportControls::TransportControls(MSUProjectState& state, AudioPlayer& player
     trimNoPadButton.setToggleState(false, juce::dontSendNotification);
     trimNoPadButton.addListener(this);
     
+    addAndMakeVisible(seamAuditionButton);
+    seamAuditionButton.setButtonText("Seam Audition (R restarts)");
+    seamAuditionButton.setTooltip("Repeat the end of the loop straight into the loop start");
+    seamAuditionButton.setClickingTogglesState(true);
+    seamAuditionButton.setToggleState(audioPlayer.isSeamAuditionEnabled(), juce::dontSendNotification);
+    seamAuditionButton.addListener(this);
+    
+    addAndMakeVisible(seamLengthSlider);
+    seamLengthSlider.setRange(AudioPlayer::minSeamAuditionMs, AudioPlayer::maxSeamAuditionMs, 10.0);
+    seamLengthSlider.setSkewFactorFromMidPoint(1000.0);
+    seamLengthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    seamLengthSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 70, 20);
+    seamLengthSlider.setTextValueSuffix(" ms");
+    seamLengthSlider.setColour(juce::Slider::textBoxTextColourId, CustomLookAndFeel::textColor);
+    seamLengthSlider.setColour(juce::Slider::textBoxOutlineColourId, CustomLookAndFeel::darkControl);
+    seamLengthSlider.setValue(audioPlayer.getSeamAuditionLengthMs(), juce::dontSendNotification);
+    seamLengthSlider.onValueChange = [this]()
+    {
+        audioPlayer.setSeamAuditionLengthMs(seamLengthSlider.getValue());
+    };
+    
     // Setup labels
     addAndMakeVisible(positionLabel);
     positionLabel.setJustificationType(juce::Justification::centred);
@@ -73,15 +94,11 @@ TransportControls::TransportControls(MSUProjectState& state, AudioPlayer& player
     durationLabel.setJustificationType(juce::Justification::centred);
     durationLabel.setColour(juce::Label::textColourId, CustomLookAndFeel::textColorDark);
     
-    // Start timer for position updates
-    startTimer(50);
-    
-    updatePositionDisplay();
+    updatePositionDisplay(audioPlayer.getPosition());
 }
 
 TransportControls::~TransportControls()
 {
-    stopTimer();
 }
 
 //==============================================================================
@@ -100,6 +117,11 @@ void TransportControls::resized()
     topRow.removeFromLeft(8);
     durationLabel.setBounds(topRow.removeFromLeft(120));
     
+    // Seam audition controls sit on the right of the time display
+    seamLengthSlider.setBounds(topRow.removeFromRight(240));
+    topRow.removeFromRight(8);
+    seamAuditionButton.setBounds(topRow.removeFromRight(190));
+    
     bounds.removeFromTop(8);
     
     // Bottom row: transport buttons (expanded for 7 buttons)
@@ -156,6 +178,10 @@ void TransportControls::buttonClicked(juce::Button* button)
     {
         audioPlayer.setLooping(loopButton.getToggleState());
     }
+    else if (button == &seamAuditionButton)
+    {
+        audioPlayer.setSeamAuditionEnabled(seamAuditionButton.getToggleState());
+    }
     else if (button == &autoTrimPadButton)
     {
         if (autoTrimPadButton.getToggleState())
@@ -182,18 +208,12 @@ void TransportControls::buttonClicked(juce::Button* button)
     }
 }
 
-void TransportControls::timerCallback()
-{
-    updatePositionDisplay();
-}
-
 //==============================================================================
-void TransportControls::updatePositionDisplay()
+void TransportControls::updatePositionDisplay(double positionSeconds)
 {
-    double position = audioPlayer.getPosition();
     double duration = projectState.getLengthInSeconds();
     
-    positionLabel.setText(formatTime(position), juce::dontSendNotification);
+    positionLabel.setText(formatTime(positionSeconds), juce::dontSendNotification);
     durationLabel.setText("/ " + formatTime(duration), juce::dontSendNotification);
 }
 
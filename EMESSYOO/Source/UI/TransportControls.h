@@ -9,8 +9,7 @@
  * Transport controls for playback (play, pause, stop, loop toggle).
  */
 class TransportControls : public juce::Component,
-                          public juce::Button::Listener,
-                          public juce::Timer
+                          public juce::Button::Listener
 {
 public:
     //==============================================================================
@@ -21,7 +20,9 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     void buttonClicked(juce::Button* button) override;
-    void timerCallback() override;
+    
+    /** Refresh the time labels; driven by the frame scheduler */
+    void updatePositionDisplay(double positionSeconds);
     
     bool isAutoScrollEnabled() const { return autoScrollButton.getToggleState(); }
     bool isAutoTrimPadEnabled() const { return autoTrimPadButton.getToggleState(); }
@@ -44,6 +45,8 @@ private:
     juce::ToggleButton trimNoPadButton;
     juce::Label padAmountLabel;
     juce::Slider padAmountSlider;
+    juce::ToggleButton seamAuditionButton;
+    juce::Slider seamLengthSlider;
     
     juce::Label positionLabel;
     juce::Label durationLabel;
@@ -51,7 +54,6 @@ private:
     int64 detectFirstAudioSample(float thresholdDb = -60.0f) const;
     void resetTrimAndPadding();
     
-    void updatePositionDisplay();
     juce::String formatTime(double seconds) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TransportControls)
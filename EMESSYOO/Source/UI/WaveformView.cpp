@@ -4,13 +4,8 @@
 //==============================================================================
 WaveformView::WaveformView(MSUProjectState& state)
     : projectState(state),
-      thumbnailCache(5),
-      thumbnail(512, formatManager, thumbnailCache),
       scrollBar(false)
 {
-    // Register audio formats for thumbnail
-    formatManager.registerBasicFormats();
-    
     // Listen to project state changes
     projectState.addChangeListener(this);
     
@@ -21,17 +16,96 @@ WaveformView::WaveformView(MSUProjectState& state)
     
     // Enable keyboard focus for hotkeys
     setWantsKeyboardFocus(true);
+    setOpaque(true);
     
-    // Initial thumbnail update
-    updateThumbnail();
+    // Initial waveform build
+    rebuildPeaks();
 }
 
 WaveformView::~WaveformView()
 {
+    analysisPool.removeAllJobs(true, 2000);
     projectState.removeChangeListener(this);
     scrollBar.removeListener(this);
 }
 
+//==============================================================================
+WaveformView::AnalysisJob::AnalysisJob(WaveformView& view,
+                                       std::shared_ptr<const juce::AudioBuffer<float>> buffer,
+                                       double sampleRate,
+                                       uint32 version,
+                                       const juce::File& decodedFrom)
+    : juce::ThreadPoolJob("Waveform analysis"),
+      owner(&view),
+      audio(std::move(buffer)),
+      audioSampleRate(sampleRate),
+      audioVersion(version),
+      sourceFile(decodedFrom)
+{
+}
+
+juce::ThreadPoolJob::JobStatus WaveformView::AnalysisJob::runJob()
+{
+    auto exitCheck = [this] { return shouldExit(); };
+    auto view = owner;
+    
+    // Peaks first: they are what the user is waiting to see
+    uint64 peakCacheKey = 0;
+    auto result = loadCachedPeaks(peakCacheKey);
+    const bool cached = (result != nullptr);
+    
+    if (!cached)
+        result = PeakPyramid::build(*audio, audioSampleRate, audioVersion, exitCheck);
+    
+    if (result == nullptr || shouldExit())
+        return juce::ThreadPoolJob::jobHasFinished;
+    
+    juce::MessageManager::callAsync([view, result]
+    {
+        if (view != nullptr)
+            view->peaksReady(result);
+    });
+    
+    if (!cached && peakCacheKey != 0)
+        PeakFileCache::store(peakCacheKey, *result);
+    
+    auto index = ZeroCrossingIndex::build(*audio, audioVersion, exitCheck);
+    if (index != nullptr && !shouldExit())
+    {
+        juce::MessageManager::callAsync([view, index]
+        {
+            if (view != nullptr)
+                view->crossingsReady(index);
+        });
+    }
+    
+    return juce::ThreadPoolJob::jobHasFinished;
+}
+
+PeakPyramid::Ptr WaveformView::AnalysisJob::loadCachedPeaks(uint64& cacheKey) const
+{
+    cacheKey = 0;
+    
+    // Only audio that is still exactly the decoded file can be matched on disk
+    if (sourceFile == juce::File())
+        return nullptr;
+    
+    PeakFileCache::DecodeSettings decode;
+    decode.sampleRate = audioSampleRate;
+    decode.numChannels = audio->getNumChannels();
+    decode.numSamples = audio->getNumSamples();
+    
+    cacheKey = PeakFileCache::computeKey(sourceFile, decode);
+    auto cached = PeakFileCache::load(cacheKey, audioVersion);
+    
+    if (cached == nullptr
+        || cached->getNumSamples() != audio->getNumSamples()
+        || cached->getNumChannels() != audio->getNumChannels())
+        return nullptr;
+    
+    return cached;
+}
+
 //==============================================================================
 void WaveformView::paint(juce::Graphics& g)
 {
@@ -39,11 +113,12 @@ void WaveformView::paint(juce::Graphics& g)
     
     // Draw background
     g.fillAll(CustomLookAndFeel::darkBackground);
-    g.setColour(CustomLookAndFeel::darkPanel);
-    g.fillRect(bounds);
     
     if (!projectState.hasAudio())
     {
+        g.setColour(CustomLookAndFeel::darkPanel);
+        g.fillRect(bounds);
+        
         // Show "No audio loaded" message
         g.setColour(CustomLookAndFeel::textColorDark);
         g.setFont(16.0f);
@@ -51,44 +126,30 @@ void WaveformView::paint(juce::Graphics& g)
         return;
     }
     
-    // Draw waveform
-    g.setColour(CustomLookAndFeel::greenAccent);
-    thumbnail.drawChannels(g, bounds.reduced(2),
-                          visibleStart, visibleEnd,
-                          1.0f);
+    // Waveform, padding shading and time ruler come from cached tiles
+    drawTiles(g, bounds);
+    
+    if (peaks == nullptr)
+    {
+        g.setColour(CustomLookAndFeel::textColorDark);
+        g.setFont(14.0f);
+        g.drawText("Building waveform...", bounds, juce::Justification::centred);
+    }
     
-    // Highlight added padding region at start if present
+    // Label the added padding region at start if present
     if (projectState.getPaddingSamples() > 0 && projectState.getSampleRate() > 0.0)
     {
-        double paddingStartTime = 0.0;
         double paddingEndTime = static_cast<double>(projectState.getPaddingSamples()) / projectState.getSampleRate();
+        int paddingStartX = juce::jmax(bounds.getX(), xAtTimelineSeconds(0.0));
+        int paddingEndX = juce::jmin(bounds.getRight(), xAtTimelineSeconds(paddingEndTime));
         
-        if (paddingEndTime > visibleStart && paddingStartTime < visibleEnd)
+        if (paddingEndX > paddingStartX)
         {
-            double visibleRange = visibleEnd - visibleStart;
-            if (visibleRange <= 0.0)
-                visibleRange = 0.000001;
-            int paddingStartX = bounds.getX() + static_cast<int>(((paddingStartTime - visibleStart) / visibleRange) * bounds.getWidth());
-            int paddingEndX = bounds.getX() + static_cast<int>(((paddingEndTime - visibleStart) / visibleRange) * bounds.getWidth());
-            
-            paddingStartX = juce::jmax(bounds.getX(), paddingStartX);
-            paddingEndX = juce::jmin(bounds.getRight(), paddingEndX);
-            
-            if (paddingEndX > paddingStartX)
-            {
-                auto paddingBounds = juce::Rectangle<int>(paddingStartX, bounds.getY(), paddingEndX - paddingStartX, bounds.getHeight());
-                
-                g.setColour(CustomLookAndFeel::darkPanel.withAlpha(0.5f));
-                g.fillRect(paddingBounds);
-                
-                g.setColour(juce::Colours::blue.withAlpha(0.4f));
-                g.fillRect(paddingBounds);
-                
-                g.setColour(juce::Colours::lightblue);
-                juce::String label = "PAD: " + juce::String(static_cast<int>(paddingEndTime * 1000.0)) + " ms";
-                g.setFont(10.0f);
-                g.drawText(label, paddingBounds.reduced(4), juce::Justification::topLeft, false);
-            }
+            auto paddingBounds = juce::Rectangle<int>(paddingStartX, bounds.getY(), paddingEndX - paddingStartX, bounds.getHeight());
+            g.setColour(juce::Colours::lightblue);
+            juce::String label = "PAD: " + juce::String(static_cast<int>(paddingEndTime * 1000.0)) + " ms";
+            g.setFont(10.0f);
+            g.drawText(label, paddingBounds.reduced(4), juce::Justification::topLeft, false);
         }
     }
     
@@ -188,118 +249,21 @@ void WaveformView::paint(juce::Graphics& g)
         }
     }
     
-    // Draw playhead
+    drawHotkeyLegend(g, bounds);
+    
+    // Draw border
+    g.setColour(CustomLookAndFeel::darkControl);
+    g.drawRect(bounds, 1);
+    
+    // Draw playhead last; setPlayPosition repaints just the strips it leaves and enters
     if (playPosition >= visibleStart && playPosition <= visibleEnd)
     {
-        double ratio = (playPosition - visibleStart) / (visibleEnd - visibleStart);
-        int playheadX = bounds.getX() + static_cast<int>(ratio * bounds.getWidth());
+        int playheadX = xAtTimelineSeconds(playPosition);
         
         g.setColour(juce::Colours::white);
         g.drawLine(static_cast<float>(playheadX), static_cast<float>(bounds.getY()),
                   static_cast<float>(playheadX), static_cast<float>(bounds.getBottom()), 1.0f);
     }
-    
-    // Draw time ruler at bottom
-    if (projectState.hasAudio())
-    {
-        int rulerHeight = 20;
-        auto rulerBounds = juce::Rectangle<int>(bounds.getX(), bounds.getBottom() - rulerHeight,
-                                                 bounds.getWidth(), rulerHeight);
-        
-        // Draw ruler background
-        g.setColour(CustomLookAndFeel::darkControl.withAlpha(0.8f));
-        g.fillRect(rulerBounds);
-        
-        // Calculate appropriate time interval based on zoom level
-        double visibleDuration = visibleEnd - visibleStart;
-        double msPerPixel = (visibleDuration * 1000.0) / bounds.getWidth();
-        
-        // Determine tick interval in milliseconds
-        int majorTickInterval = 1000; // 1 second
-        int minorTickInterval = 100;  // 100ms
-        
-        if (msPerPixel > 50.0)
-        {
-            majorTickInterval = 10000; // 10 seconds
-            minorTickInterval = 1000;  // 1 second
-        }
-        else if (msPerPixel > 10.0)
-        {
-            majorTickInterval = 5000;  // 5 seconds
-            minorTickInterval = 500;   // 500ms
-        }
-        else if (msPerPixel < 0.5)
-        {
-            majorTickInterval = 100;   // 100ms
-            minorTickInterval = 10;    // 10ms
-        }
-        else if (msPerPixel < 2.0)
-        {
-            majorTickInterval = 500;   // 500ms
-            minorTickInterval = 50;    // 50ms
-        }
-        
-        // Draw ticks and labels
-        int startMs = static_cast<int>(visibleStart * 1000.0);
-        int endMs = static_cast<int>(visibleEnd * 1000.0);
-        
-        // Align to tick interval
-        int firstTick = (startMs / minorTickInterval) * minorTickInterval;
-        
-        g.setFont(9.0f);
-        
-        for (int ms = firstTick; ms <= endMs; ms += minorTickInterval)
-        {
-            double timeInSeconds = ms / 1000.0;
-            if (timeInSeconds < visibleStart || timeInSeconds > visibleEnd)
-                continue;
-            
-            double ratio = (timeInSeconds - visibleStart) / (visibleEnd - visibleStart);
-            int x = bounds.getX() + static_cast<int>(ratio * bounds.getWidth());
-            
-            bool isMajorTick = (ms % majorTickInterval == 0);
-            
-            if (isMajorTick)
-            {
-                // Major tick
-                g.setColour(CustomLookAndFeel::textColor);
-                g.drawLine(static_cast<float>(x), static_cast<float>(rulerBounds.getY()),
-                          static_cast<float>(x), static_cast<float>(rulerBounds.getY() + 8), 1.0f);
-                
-                // Label
-                juce::String label;
-                if (ms >= 1000)
-                {
-                    double seconds = ms / 1000.0;
-                    if (ms % 1000 == 0)
-                        label = juce::String(static_cast<int>(seconds)) + "s";
-                    else
-                        label = juce::String(seconds, 1) + "s";
-                }
-                else
-                {
-                    label = juce::String(ms) + "ms";
-                }
-                
-                g.drawText(label, x - 30, rulerBounds.getY() + 8, 60, 12,
-                          juce::Justification::centred, false);
-            }
-            else
-            {
-                // Minor tick
-                g.setColour(CustomLookAndFeel::textColorDark);
-                g.drawLine(static_cast<float>(x), static_cast<float>(rulerBounds.getY()),
-                          static_cast<float>(x), static_cast<float>(rulerBounds.getY() + 4), 1.0f);
-            }
-        }
-    }
-
-    if (projectState.hasAudio())
-        drawHotkeyLegend(g, bounds);
-    
-    // Draw border
-    g.setColour(CustomLookAndFeel::darkControl);
-    g.drawRect(bounds, 1);
 }
 
 void WaveformView::resized()
@@ -382,8 +346,9 @@ void WaveformView::mouseDown(const juce::MouseEvent& event)
         }
     }
     
-    // Otherwise, seek to clicked position
+    // Otherwise, seek to clicked position and scrub the playhead if dragged
     selectedHandle = None;  // Deselect any handle
+    currentDragMode = Scrub;
     if (onPositionClicked)
     {
         double timelineSeconds = timelineSecondsAtX(event.x);
@@ -398,20 +363,38 @@ void WaveformView::mouseDrag(const juce::MouseEvent& event)
     
     int64 dragSample = sampleAtX(event.x);
     
-    if (currentDragMode == TrimStart)
+    if (!isScrubbing && onScrubStart)
+    {
+        isScrubbing = true;
+        onScrubStart(dragSample);
+    }
+    else if (isScrubbing && onScrubMove)
+    {
+        onScrubMove(dragSample);
+    }
+    
+    if (currentDragMode == Scrub)
+    {
+        if (onPositionClicked)
+            onPositionClicked(timelineSecondsAtX(event.x));
+    }
+    else
     {
-        projectState.setTrimStart(dragSample);
+        placeHandle(currentDragMode, dragSample);
     }
-    else if (currentDragMode == LoopStart)
-        projectState.setLoopStart(dragSample);
-    else if (currentDragMode == LoopEnd)
-        projectState.setLoopEnd(dragSample);
 }
 
 void WaveformView::mouseUp(const juce::MouseEvent& event)
 {
     juce::ignoreUnused(event);
 
+    if (isScrubbing)
+    {
+        isScrubbing = false;
+        if (onScrubEnd)
+            onScrubEnd();
+    }
+
     currentDragMode = None;
     setMouseCursor(juce::MouseCursor::NormalCursor);
 }
@@ -486,8 +469,7 @@ bool WaveformView::keyPressed(const juce::KeyPress& key)
     // T: Move trim start to mouse cursor
     if (key.getKeyCode() == 'T' || key.getKeyCode() == 't')
     {
-        int64 sample = sampleAtX(clampedX);
-        projectState.setTrimStart(sample);
+        placeHandle(TrimStart, sampleAtX(clampedX));
         selectedHandle = TrimStart;
         repaint();
         return true;
@@ -496,8 +478,7 @@ bool WaveformView::keyPressed(const juce::KeyPress& key)
     // Z: Move loop start to mouse cursor
     if (key.getKeyCode() == 'Z' || key.getKeyCode() == 'z')
     {
-        int64 sample = sampleAtX(clampedX);
-        projectState.setLoopStart(sample);
+        placeHandle(LoopStart, sampleAtX(clampedX));
         selectedHandle = LoopStart;
         repaint();
         return true;
@@ -506,13 +487,19 @@ bool WaveformView::keyPressed(const juce::KeyPress& key)
     // X: Move loop end to mouse cursor
     if (key.getKeyCode() == 'X' || key.getKeyCode() == 'x')
     {
-        int64 sample = sampleAtX(clampedX);
-        projectState.setLoopEnd(sample);
+        placeHandle(LoopEnd, sampleAtX(clampedX));
         selectedHandle = LoopEnd;
         repaint();
         return true;
     }
     
+    // G: Toggle snapping markers to zero crossings
+    if (key.getKeyCode() == 'G' || key.getKeyCode() == 'g')
+    {
+        setSnapToZeroCrossings(!snapToZeroCrossings);
+        return true;
+    }
+    
     return false;
 }
 
@@ -547,14 +534,13 @@ void WaveformView::mouseWheelMove(const juce::MouseEvent& event, const juce::Mou
             
             // Apply zoom
             double newZoomLevel = zoomLevel * zoomFactor;
-            newZoomLevel = juce::jlimit(0.1, 100.0, newZoomLevel);
+            newZoomLevel = juce::jlimit(minZoomLevel, getMaxZoomLevel(), newZoomLevel);
             
-            double totalLength = projectState.hasAudio() ? 
-                (projectState.getAudioBuffer().getNumSamples() / projectState.getSampleRate()) : 0.0;
+            double totalLength = getPlaybackLengthSeconds();
             double newVisibleLength = totalLength / newZoomLevel;
             
             // Clamp visible length to not exceed total length
-            newVisibleLength = juce::jlimit(totalLength * 0.001, totalLength, newVisibleLength);
+            newVisibleLength = juce::jlimit(juce::jmin(getMinVisibleLength(), totalLength), totalLength, newVisibleLength);
             
             // Calculate new visible range to keep the time under mouse at the same ratio
             double newVisibleStart = timeUnderMouse - newVisibleLength * mouseRatio;
@@ -566,6 +552,7 @@ void WaveformView::mouseWheelMove(const juce::MouseEvent& event, const juce::Mou
             visibleEnd = visibleStart + newVisibleLength;
             
             scrollBar.setCurrentRange(visibleStart, newVisibleLength);
+            visibleRangeChanged();
             repaint();
             zoomAccumulator = 0.0f;
         }
@@ -578,47 +565,31 @@ void WaveformView::mouseWheelMove(const juce::MouseEvent& event, const juce::Mou
         fineTuneAccumulator += wheel.deltaY;
         const float stepThreshold = 0.01f;
         
+        // 100 samples per step, down to one pixel's worth when zoomed in
+        const double samplesPerPixel = (visibleEnd - visibleStart) * projectState.getSampleRate()
+            / juce::jmax(1, getLocalBounds().reduced(4).getWidth());
+        const int64 step = juce::jlimit<int64>(1, 100, static_cast<int64>(samplesPerPixel));
+        
         while (fineTuneAccumulator >= stepThreshold)
         {
-            if (selectedHandle == TrimStart)
-            {
-                int64 newPos = projectState.getTrimStart() + 100;
-                projectState.setTrimStart(newPos);
-            }
-            else if (selectedHandle == LoopStart)
-            {
-                int64 newPos = projectState.getLoopStart() + 100;
-                projectState.setLoopStart(newPos);
-            }
-            else if (selectedHandle == LoopEnd)
-            {
-                int64 newPos = projectState.getLoopEnd() + 100;
-                projectState.setLoopEnd(newPos);
-            }
+            nudgeSelectedHandle(step);
             fineTuneAccumulator -= stepThreshold;
         }
         
         while (fineTuneAccumulator <= -stepThreshold)
         {
-            if (selectedHandle == TrimStart)
-            {
-                int64 newPos = projectState.getTrimStart() - 100;
-                // Ensure it doesn't go negative
-                newPos = juce::jmax(int64(0), newPos);
-                projectState.setTrimStart(newPos);
-            }
-            else if (selectedHandle == LoopStart)
-            {
-                int64 newPos = projectState.getLoopStart() - 100;
-                projectState.setLoopStart(newPos);
-            }
-            else if (selectedHandle == LoopEnd)
-            {
-                int64 newPos = projectState.getLoopEnd() - 100;
-                projectState.setLoopEnd(newPos);
-            }
+            nudgeSelectedHandle(-step);
             fineTuneAccumulator += stepThreshold;
         }
+        return;
+    }
+    
+    // Pan with the plain wheel or a horizontal trackpad swipe
+    if (!event.mods.isAnyModifierKeyDown() && projectState.hasAudio())
+    {
+        const float delta = std::abs(wheel.deltaX) > std::abs(wheel.deltaY) ? wheel.deltaX : wheel.deltaY;
+        const double visibleLength = visibleEnd - visibleStart;
+        setVisibleStart(visibleStart - delta * visibleLength * panWheelFraction);
     }
 }
 
@@ -627,21 +598,25 @@ void WaveformView::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
     if (source == &projectState)
     {
-        int64 currentNumSamples = projectState.hasAudio() ? projectState.getNumSamples() : 0;
         int64 currentEffectiveStart = projectState.getEffectivePlaybackStart();
         int64 currentPadding = projectState.getPaddingSamples();
-        bool audioChanged = (currentNumSamples != lastNumSamples);
+        bool audioChanged = (projectState.getAudioVersion() != lastAudioVersion);
         bool effectiveChanged = (currentEffectiveStart != lastEffectiveStart);
         bool paddingChanged = (currentPadding != lastPaddingSamples);
         
-        if (audioChanged || effectiveChanged || paddingChanged)
+        if (audioChanged)
         {
-            updateThumbnail();
+            rebuildPeaks();
         }
-        else
+        else if (effectiveChanged || paddingChanged)
         {
-            repaint();
+            // Trim and padding are view offsets over the same peaks
+            lastEffectiveStart = currentEffectiveStart;
+            lastPaddingSamples = currentPadding;
+            updateVisibleRange();
         }
+        
+        repaint();
     }
 }
 
@@ -659,6 +634,7 @@ void WaveformView::scrollBarMoved(juce::ScrollBar* scrollBarThatHasMoved, double
     
     // Keep scrollbar in sync (but don't recompute from itself)
     scrollBar.setCurrentRange(visibleStart, visibleLength);
+    visibleRangeChanged();
     
     repaint();
 }
@@ -666,11 +642,43 @@ void WaveformView::scrollBarMoved(juce::ScrollBar* scrollBarThatHasMoved, double
 //==============================================================================
 void WaveformView::setZoomLevel(double newZoom)
 {
-    zoomLevel = juce::jlimit(0.1, 100.0, newZoom);
+    zoomLevel = juce::jlimit(minZoomLevel, getMaxZoomLevel(), newZoom);
     updateVisibleRange();
     repaint();
 }
 
+double WaveformView::getMaxZoomLevel() const
+{
+    const double totalLength = getPlaybackLengthSeconds();
+    const double minLength = getMinVisibleLength();
+    if (totalLength <= 0.0 || minLength <= 0.0)
+        return minZoomLevel;
+    
+    return juce::jmax(minZoomLevel, totalLength / minLength);
+}
+
+double WaveformView::getMinVisibleLength() const
+{
+    // Deep enough to place markers on individual samples
+    const double sampleRate = projectState.getSampleRate();
+    return sampleRate > 0.0 ? minVisibleSamples / sampleRate : 0.0;
+}
+
+void WaveformView::setVisibleStart(double newStart)
+{
+    const double totalLength = getPlaybackLengthSeconds();
+    const double visibleLength = visibleEnd - visibleStart;
+    const double clampedStart = juce::jlimit(0.0, juce::jmax(0.0, totalLength - visibleLength), newStart);
+    if (clampedStart == visibleStart)
+        return;
+    
+    visibleStart = clampedStart;
+    visibleEnd = visibleStart + visibleLength;
+    scrollBar.setCurrentRange(visibleStart, visibleLength);
+    visibleRangeChanged();
+    repaint();
+}
+
 void WaveformView::setPlayPosition(double seconds)
 {
     double adjustedSeconds = seconds;
@@ -679,6 +687,8 @@ void WaveformView::setPlayPosition(double seconds)
         double paddingSeconds = static_cast<double>(projectState.getPaddingSamples()) / projectState.getSampleRate();
         adjustedSeconds = juce::jmax(0.0, seconds - paddingSeconds);
     }
+    const double previousPosition = playPosition;
+    const double previousVisibleStart = visibleStart;
     playPosition = adjustedSeconds;
     
     // Auto-scroll to keep playhead visible
@@ -694,89 +704,532 @@ void WaveformView::setPlayPosition(double seconds)
             newVisibleStart = juce::jlimit(0.0, totalLength - visibleLength, newVisibleStart);
             
             // Only update if actually changing
-            if (std::abs(newVisibleStart - visibleStart) > 0.001)
+            if (std::abs(newVisibleStart - visibleStart) > visibleLength * 0.001)
             {
                 visibleStart = newVisibleStart;
                 visibleEnd = visibleStart + visibleLength;
                 scrollBar.setCurrentRange(visibleStart, visibleLength);
+                visibleRangeChanged();
             }
         }
     }
     
-    repaint();
+    if (visibleStart != previousVisibleStart)
+    {
+        repaint();
+        return;
+    }
+    
+    // Only the strips the playhead leaves and enters need redrawing
+    if (playPosition != previousPosition)
+    {
+        repaintPlayhead(previousPosition);
+        repaintPlayhead(playPosition);
+    }
+}
+
+void WaveformView::repaintPlayhead(double seconds)
+{
+    if (seconds < visibleStart || seconds > visibleEnd)
+        return;
+    
+    auto bounds = getLocalBounds().reduced(4);
+    repaint(xAtTimelineSeconds(seconds) - 2, bounds.getY(), 5, bounds.getHeight());
 }
 
 //==============================================================================
-void WaveformView::updateThumbnail()
+int64 WaveformView::getHandleSample(DragMode handle) const
 {
+    if (handle == TrimStart)
+        return projectState.getTrimStart();
+    if (handle == LoopStart)
+        return projectState.getLoopStart();
+    if (handle == LoopEnd)
+        return projectState.getLoopEnd();
+    return -1;
+}
+
+void WaveformView::setHandleSample(DragMode handle, int64 sample)
+{
+    if (handle == TrimStart)
+        projectState.setTrimStart(juce::jmax<int64>(0, sample));
+    else if (handle == LoopStart)
+        projectState.setLoopStart(sample);
+    else if (handle == LoopEnd)
+        projectState.setLoopEnd(sample);
+}
+
+void WaveformView::nudgeSelectedHandle(int64 delta)
+{
+    const int64 current = getHandleSample(selectedHandle);
+    if (current < 0 || delta == 0)
+        return;
+    
+    // Snap to a crossing ahead in the direction of travel, at most two steps away
+    const int64 target = current + delta;
+    const int64 reach = std::abs(delta) * 2;
+    const int64 searchStart = delta > 0 ? current + 1 : current - reach;
+    const int64 searchEnd = delta > 0 ? current + reach : current - 1;
+    setHandleSample(selectedHandle, snapHandle(selectedHandle, target, searchStart, searchEnd));
+}
+
+void WaveformView::placeHandle(DragMode handle, int64 sample)
+{
+    const int64 radius = getSnapRadiusSamples();
+    setHandleSample(handle, snapHandle(handle, sample, sample - radius, sample + radius));
+}
+
+int64 WaveformView::snapHandle(DragMode handle, int64 target, int64 searchStart, int64 searchEnd) const
+{
+    if (!snapToZeroCrossings || crossings == nullptr || crossings->getVersion() != projectState.getAudioVersion())
+        return target;
+    
+    auto marker = ZeroCrossingIndex::Marker::Trim;
+    int64 otherMarker = -1;
+    if (handle == LoopStart)
+    {
+        marker = ZeroCrossingIndex::Marker::LoopStart;
+        otherMarker = projectState.getLoopEnd();
+    }
+    else if (handle == LoopEnd)
+    {
+        marker = ZeroCrossingIndex::Marker::LoopEnd;
+        otherMarker = projectState.getLoopStart();
+    }
+    
+    const int64 snapped = crossings->findSnapPosition(projectState.getAudioBuffer(), target,
+                                                      searchStart, searchEnd, marker, otherMarker);
+    return snapped >= 0 ? snapped : target;
+}
+
+int64 WaveformView::getSnapRadiusSamples() const
+{
+    const int width = juce::jmax(1, getLocalBounds().reduced(4).getWidth());
+    const double samplesPerPixel = (visibleEnd - visibleStart) * projectState.getSampleRate() / width;
+    return juce::jmax(minSnapRadiusSamples, static_cast<int64>(samplesPerPixel * snapRadiusPixels));
+}
+
+void WaveformView::rebuildPeaks()
+{
+    analysisPool.removeAllJobs(true, 0);
+    lastAudioVersion = projectState.getAudioVersion();
+    
     if (!projectState.hasAudio())
     {
-        thumbnail.clear();
+        peaks.reset();
+        crossings.reset();
         visibleStart = 0.0;
         visibleEnd = 0.0;
         lastNumSamples = 0;
         lastEffectiveStart = 0;
         lastPaddingSamples = 0;
-        lastThumbnailLengthSeconds = 0.0;
         return;
     }
     
-    const auto& sourceBuffer = projectState.getAudioBuffer();
-    int64 paddingSamples = projectState.getPaddingSamples();
-    int64 effectiveStart = projectState.getEffectivePlaybackStart();
-    int64 totalSamples = sourceBuffer.getNumSamples();
-    paddingSamples = juce::jlimit<int64>(0, totalSamples, paddingSamples);
-    effectiveStart = juce::jlimit<int64>(0, totalSamples, effectiveStart);
+    crossings.reset();
+    analysisPool.addJob(new AnalysisJob(*this, projectState.getAudioSnapshot(), projectState.getSampleRate(),
+                                        lastAudioVersion,
+                                        projectState.isAudioFromSourceFile() ? projectState.getSourceFile() : juce::File()),
+                        true);
+    
+    lastEffectiveStart = projectState.getEffectivePlaybackStart();
+    lastPaddingSamples = projectState.getPaddingSamples();
+    
+    // Same-length edits (e.g. gain) keep the view and the old peaks until the new ones arrive
+    const int64 numSamples = projectState.getNumSamples();
+    const bool keepView = (numSamples == lastNumSamples);
+    
+    if (!keepView)
+        peaks.reset();
     
-    // If we have padding, create a padded buffer for the thumbnail
-    if (paddingSamples > 0)
+    if (keepView)
     {
-        // Calculate the effective audio region (from effectiveStart onwards)
-        int sourceOffset = static_cast<int>(effectiveStart);
-        int sourceLength = juce::jmax(0, sourceBuffer.getNumSamples() - sourceOffset);
-        int totalLength = static_cast<int>(paddingSamples) + sourceLength;
+        updateVisibleRange();
+        return;
+    }
+    
+    lastNumSamples = numSamples;
+    
+    // Initialize visible range to show entire waveform
+    visibleStart = 0.0;
+    visibleEnd = getPlaybackLengthSeconds() / zoomLevel;
+    updateVisibleRange();
+}
+
+void WaveformView::crossingsReady(ZeroCrossingIndex::Ptr newCrossings)
+{
+    if (newCrossings != nullptr && newCrossings->getVersion() == projectState.getAudioVersion())
+        crossings = std::move(newCrossings);
+}
+
+void WaveformView::peaksReady(PeakPyramid::Ptr newPeaks)
+{
+    if (newPeaks == nullptr || newPeaks->getVersion() != projectState.getAudioVersion())
+        return;
+    
+    peaks = std::move(newPeaks);
+    repaint();
+}
+
+void WaveformView::drawTiles(juce::Graphics& g, const juce::Rectangle<int>& bounds)
+{
+    const int width = bounds.getWidth();
+    const double visibleLength = visibleEnd - visibleStart;
+    if (width <= 0 || bounds.getHeight() <= 0 || visibleLength <= 0.0)
+        return;
+    
+    TileKey key;
+    key.secondsPerPixel = visibleLength / width;
+    key.height = bounds.getHeight();
+    key.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    key.peaks = peaks.get();
+    key.audioVersion = projectState.getAudioVersion();
+    key.effectiveStart = projectState.getEffectivePlaybackStart();
+    key.paddingSamples = projectState.getPaddingSamples();
+    
+    if (!key.matches(tileKey))
+    {
+        tileCache.clear();
+        tileKey = key;
+    }
+    
+    // Tiles sit at fixed columns of the whole timeline, so scrolling only moves them
+    const double scrollPixels = visibleStart / tileKey.secondsPerPixel;
+    const int64 firstTile = static_cast<int64>(std::floor(scrollPixels / tileWidth));
+    const int64 lastTile = static_cast<int64>(std::floor((scrollPixels + width) / tileWidth));
+    const int64 originX = bounds.getX() - static_cast<int64>(std::llround(scrollPixels));
+    const auto clip = g.getClipBounds();
+    
+    juce::Graphics::ScopedSaveState saveState(g);
+    g.reduceClipRegion(bounds);
+    
+    for (int64 tile = firstTile; tile <= lastTile; ++tile)
+    {
+        const int tileX = static_cast<int>(originX + tile * tileWidth);
+        const juce::Rectangle<int> tileBounds(tileX, bounds.getY(), tileWidth, bounds.getHeight());
+        if (!tileBounds.intersects(clip))
+            continue;
         
-        // Create temporary buffer with padding
-        juce::AudioBuffer<float> paddedBuffer(sourceBuffer.getNumChannels(), totalLength);
-        paddedBuffer.clear();
+        auto& image = tileCache[tile];
+        if (!image.isValid())
+            image = renderTile(tile);
         
-        // Copy audio after padding region
-        for (int ch = 0; ch < sourceBuffer.getNumChannels(); ++ch)
+        g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / tileKey.scale)
+                                          .translated(static_cast<float>(tileX), static_cast<float>(bounds.getY())));
+    }
+    
+    // Drop the tiles furthest from the view once the cache is full
+    while (static_cast<int>(tileCache.size()) > maxCachedTiles)
+    {
+        const auto front = tileCache.begin();
+        const auto back = std::prev(tileCache.end());
+        if (firstTile - front->first > back->first - lastTile)
+            tileCache.erase(front);
+        else
+            tileCache.erase(back);
+    }
+}
+
+juce::Image WaveformView::renderTile(int64 tileIndex) const
+{
+    const float scale = tileKey.scale;
+    const int height = tileKey.height;
+    juce::Image image(juce::Image::RGB,
+                      juce::jmax(1, juce::roundToInt(tileWidth * scale)),
+                      juce::jmax(1, juce::roundToInt(height * scale)),
+                      false);
+    
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    g.fillAll(CustomLookAndFeel::darkPanel);
+    
+    const int64 firstColumn = tileIndex * tileWidth;
+    const double secondsPerPixel = tileKey.secondsPerPixel;
+    
+    // Shade the added padding region at start if present
+    if (tileKey.paddingSamples > 0 && projectState.getSampleRate() > 0.0)
+    {
+        const double paddingEndTime = static_cast<double>(tileKey.paddingSamples) / projectState.getSampleRate();
+        const double paddingEndX = paddingEndTime / secondsPerPixel - static_cast<double>(firstColumn);
+        
+        if (paddingEndX > 0.0)
         {
-            paddedBuffer.copyFrom(ch, static_cast<int>(paddingSamples), 
-                                sourceBuffer, ch, sourceOffset, sourceLength);
+            const float startX = static_cast<float>(juce::jmax(0.0, -static_cast<double>(firstColumn)));
+            const float endX = static_cast<float>(juce::jmin(static_cast<double>(tileWidth), paddingEndX));
+            
+            if (endX > startX)
+            {
+                juce::Rectangle<float> paddingBounds(startX, 0.0f, endX - startX, static_cast<float>(height));
+                g.setColour(CustomLookAndFeel::darkPanel.withAlpha(0.5f));
+                g.fillRect(paddingBounds);
+                g.setColour(juce::Colours::blue.withAlpha(0.4f));
+                g.fillRect(paddingBounds);
+            }
         }
+    }
+    
+    if (peaks != nullptr)
+        drawWaveform(g, { 0, 2, tileWidth, height - 4 }, firstColumn, secondsPerPixel);
+    
+    drawRuler(g, { 0, height - rulerHeight, tileWidth, rulerHeight }, firstColumn, secondsPerPixel);
+    return image;
+}
+
+void WaveformView::drawWaveform(juce::Graphics& g, const juce::Rectangle<int>& area,
+                                int64 firstColumn, double secondsPerPixel) const
+{
+    const double sampleRate = projectState.getSampleRate();
+    const int width = area.getWidth();
+    if (width <= 0 || sampleRate <= 0.0 || secondsPerPixel <= 0.0)
+        return;
+    
+    // Timeline sample t shows project sample t + offset; the padding before
+    // the effective start is silence
+    const int64 effectiveStart = projectState.getEffectivePlaybackStart();
+    const int64 offset = effectiveStart - projectState.getPaddingSamples();
+    const double samplesPerPixel = secondsPerPixel * sampleRate;
+    
+    const int numChannels = peaks->getNumChannels();
+    const float laneHeight = static_cast<float>(area.getHeight()) / static_cast<float>(numChannels);
+    
+    // Below one sample per pixel there is nothing to summarise; draw the samples
+    if (samplesPerPixel < 1.0)
+    {
+        drawSamples(g, area, firstColumn, samplesPerPixel, laneHeight);
+        return;
+    }
+    
+    juce::RectangleList<float> peakRects;
+    juce::RectangleList<float> rmsRects;
+    peakRects.ensureStorageAllocated(width * numChannels);
+    rmsRects.ensureStorageAllocated(width * numChannels);
+    
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float laneTop = static_cast<float>(area.getY()) + laneHeight * static_cast<float>(ch);
+        const float centreY = laneTop + laneHeight * 0.5f;
+        const float halfHeight = laneHeight * 0.5f;
         
-        thumbnail.reset(projectState.getNumChannels(),
-                       projectState.getSampleRate(),
-                       totalLength);
+        for (int px = 0; px < width; ++px)
+        {
+            const double column = static_cast<double>(firstColumn + px);
+            const auto columnStart = static_cast<int64>(std::floor(column * samplesPerPixel)) + offset;
+            const auto columnEnd = static_cast<int64>(std::floor((column + 1.0) * samplesPerPixel)) + offset;
+            const int64 startSample = juce::jmax(columnStart, effectiveStart);
+            const int64 endSample = juce::jmax(columnEnd, columnStart + 1);
+            if (startSample >= peaks->getNumSamples())
+                break;
+            if (endSample <= startSample)
+                continue;
+            
+            const auto peak = getColumnPeak(ch, startSample, endSample);
+            const float x = static_cast<float>(area.getX() + px);
+            const float top = centreY - juce::jlimit(-1.0f, 1.0f, peak.maxValue) * halfHeight;
+            const float bottom = centreY - juce::jlimit(-1.0f, 1.0f, peak.minValue) * halfHeight;
+            peakRects.addWithoutMerging({ x, top, 1.0f, juce::jmax(1.0f, bottom - top) });
+            
+            const float rmsHeight = juce::jmin(1.0f, peak.rms) * halfHeight;
+            if (rmsHeight >= 0.5f)
+                rmsRects.addWithoutMerging({ x, centreY - rmsHeight, 1.0f, rmsHeight * 2.0f });
+        }
+    }
+    
+    g.setColour(CustomLookAndFeel::greenAccent);
+    g.fillRectList(peakRects);
+    g.setColour(CustomLookAndFeel::greenAccentBright.withAlpha(0.6f));
+    g.fillRectList(rmsRects);
+}
+
+void WaveformView::drawSamples(juce::Graphics& g, const juce::Rectangle<int>& area, int64 firstColumn,
+                               double samplesPerPixel, float laneHeight) const
+{
+    const auto& buffer = projectState.getAudioBuffer();
+    const int64 effectiveStart = projectState.getEffectivePlaybackStart();
+    const int64 offset = effectiveStart - projectState.getPaddingSamples();
+    const int64 numSamples = buffer.getNumSamples();
+    const double pixelsPerSample = 1.0 / samplesPerPixel;
+    
+    // One extra sample either side so lines run on across tile edges
+    const auto firstSample = static_cast<int64>(std::floor(static_cast<double>(firstColumn) * samplesPerPixel)) - 1;
+    const auto lastSample = static_cast<int64>(std::ceil(static_cast<double>(firstColumn + area.getWidth()) * samplesPerPixel)) + 1;
+    const bool drawDots = pixelsPerSample >= sampleDotMinSpacing;
+    
+    for (int ch = 0; ch < juce::jmin(buffer.getNumChannels(), peaks->getNumChannels()); ++ch)
+    {
+        const float* data = buffer.getReadPointer(ch);
+        const float laneTop = static_cast<float>(area.getY()) + laneHeight * static_cast<float>(ch);
+        const float centreY = laneTop + laneHeight * 0.5f;
+        const float halfHeight = laneHeight * 0.5f;
+        
+        juce::Path line;
+        juce::Path dots;
+        bool lineStarted = false;
         
-        thumbnail.addBlock(0, paddedBuffer, 0, totalLength);
+        for (int64 timelineSample = juce::jmax<int64>(0, firstSample); timelineSample <= lastSample; ++timelineSample)
+        {
+            const int64 projectSample = timelineSample + offset;
+            if (projectSample < effectiveStart)
+                continue;
+            if (projectSample >= numSamples)
+                break;
+            
+            const float x = static_cast<float>(area.getX() + static_cast<double>(timelineSample) * pixelsPerSample
+                                               - static_cast<double>(firstColumn));
+            const float y = centreY - juce::jlimit(-1.0f, 1.0f, data[projectSample]) * halfHeight;
+            
+            if (lineStarted)
+                line.lineTo(x, y);
+            else
+                line.startNewSubPath(x, y);
+            lineStarted = true;
+            
+            if (drawDots)
+                dots.addEllipse(x - 2.0f, y - 2.0f, 4.0f, 4.0f);
+        }
+        
+        g.setColour(CustomLookAndFeel::greenAccent);
+        g.strokePath(line, juce::PathStrokeType(1.5f));
+        
+        if (drawDots)
+        {
+            g.setColour(CustomLookAndFeel::greenAccentBright);
+            g.fillPath(dots);
+        }
     }
-    else
+}
+
+void WaveformView::drawRuler(juce::Graphics& g, const juce::Rectangle<int>& rulerBounds,
+                             int64 firstColumn, double secondsPerPixel) const
+{
+    // Draw ruler background
+    g.setColour(CustomLookAndFeel::darkControl.withAlpha(0.8f));
+    g.fillRect(rulerBounds);
+    
+    // Calculate appropriate time interval based on zoom level
+    double msPerPixel = secondsPerPixel * 1000.0;
+    
+    // Determine tick interval in microseconds, so deep zoom can tick below a millisecond
+    int64 majorTickInterval = 1000000; // 1 second
+    int64 minorTickInterval = 100000;  // 100ms
+    
+    if (msPerPixel > 50.0)
+    {
+        majorTickInterval = 10000000; // 10 seconds
+        minorTickInterval = 1000000;  // 1 second
+    }
+    else if (msPerPixel > 10.0)
+    {
+        majorTickInterval = 5000000;  // 5 seconds
+        minorTickInterval = 500000;   // 500ms
+    }
+    else if (msPerPixel < 0.0005)
+    {
+        majorTickInterval = 100;      // 100us
+        minorTickInterval = 10;       // 10us
+    }
+    else if (msPerPixel < 0.005)
+    {
+        majorTickInterval = 1000;     // 1ms
+        minorTickInterval = 100;      // 100us
+    }
+    else if (msPerPixel < 0.05)
+    {
+        majorTickInterval = 10000;    // 10ms
+        minorTickInterval = 1000;     // 1ms
+    }
+    else if (msPerPixel < 0.5)
+    {
+        majorTickInterval = 100000;   // 100ms
+        minorTickInterval = 10000;    // 10ms
+    }
+    else if (msPerPixel < 2.0)
     {
-        // No padding - use original buffer from effectiveStart
-        int sourceOffset = static_cast<int>(effectiveStart);
-        int sourceLength = juce::jmax(0, sourceBuffer.getNumSamples() - sourceOffset);
+        majorTickInterval = 500000;   // 500ms
+        minorTickInterval = 50000;    // 50ms
+    }
+    
+    // Include ticks just outside the tile so labels straddling its edges are drawn in both halves
+    const int labelHalfWidth = 30;
+    const double usPerPixel = msPerPixel * 1000.0;
+    int64 startUs = juce::jmax<int64>(0, static_cast<int64>((firstColumn - labelHalfWidth) * usPerPixel));
+    int64 endUs = static_cast<int64>((firstColumn + rulerBounds.getWidth() + labelHalfWidth) * usPerPixel);
+    endUs = juce::jmin(endUs, static_cast<int64>(getPlaybackLengthSeconds() * 1000000.0));
+    
+    // Align to tick interval
+    int64 firstTick = (startUs / minorTickInterval) * minorTickInterval;
+    
+    g.setFont(9.0f);
+    
+    for (int64 us = firstTick; us <= endUs; us += minorTickInterval)
+    {
+        int x = rulerBounds.getX() + static_cast<int>(std::floor(us / usPerPixel - static_cast<double>(firstColumn)));
         
-        thumbnail.reset(projectState.getNumChannels(),
-                       projectState.getSampleRate(),
-                       sourceLength);
+        bool isMajorTick = (us % majorTickInterval == 0);
         
-        thumbnail.addBlock(0, sourceBuffer, sourceOffset, sourceLength);
+        if (isMajorTick)
+        {
+            // Major tick
+            g.setColour(CustomLookAndFeel::textColor);
+            g.drawLine(static_cast<float>(x), static_cast<float>(rulerBounds.getY()),
+                      static_cast<float>(x), static_cast<float>(rulerBounds.getY() + 8), 1.0f);
+            
+            g.drawText(formatRulerLabel(us, majorTickInterval), x - labelHalfWidth, rulerBounds.getY() + 8,
+                      labelHalfWidth * 2, 12, juce::Justification::centred, false);
+        }
+        else
+        {
+            // Minor tick
+            g.setColour(CustomLookAndFeel::textColorDark);
+            g.drawLine(static_cast<float>(x), static_cast<float>(rulerBounds.getY()),
+                      static_cast<float>(x), static_cast<float>(rulerBounds.getY() + 4), 1.0f);
+        }
     }
+}
+
+juce::String WaveformView::formatRulerLabel(int64 microseconds, int64 majorTickInterval)
+{
+    // Enough decimals to tell neighbouring major ticks apart
+    auto decimalsFor = [majorTickInterval](int64 unit)
+    {
+        int decimals = 0;
+        for (int64 step = unit; step > majorTickInterval && decimals < 6; step /= 10)
+            ++decimals;
+        return decimals;
+    };
     
-    // Initialize visible range to show entire waveform
-    const double totalLengthSeconds = getPlaybackLengthSeconds();
-    visibleStart = 0.0;
-    visibleEnd = totalLengthSeconds / zoomLevel;
+    if (microseconds >= 1000000)
+    {
+        if (microseconds % 1000000 == 0)
+            return juce::String(microseconds / 1000000) + "s";
+        return juce::String(microseconds / 1000000.0, juce::jmax(1, decimalsFor(1000000))) + "s";
+    }
     
-    updateVisibleRange();
+    if (microseconds % 1000 == 0)
+        return juce::String(microseconds / 1000) + "ms";
+    return juce::String(microseconds / 1000.0, decimalsFor(1000)) + "ms";
+}
+
+PeakPyramid::Peak WaveformView::getColumnPeak(int channel, int64 startSample, int64 endSample) const
+{
+    const auto& buffer = projectState.getAudioBuffer();
     
-    lastNumSamples = projectState.getNumSamples();
-    lastEffectiveStart = effectiveStart;
-    lastPaddingSamples = paddingSamples;
-    lastThumbnailLengthSeconds = totalLengthSeconds;
+    // Narrower than a level-0 peak: read the samples themselves
+    if (endSample - startSample < PeakPyramid::baseBlockSize
+        && channel < buffer.getNumChannels()
+        && endSample <= buffer.getNumSamples())
+    {
+        const float* data = buffer.getReadPointer(channel, static_cast<int>(startSample));
+        const int count = static_cast<int>(endSample - startSample);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, count);
+        
+        float sumOfSquares = 0.0f;
+        for (int i = 0; i < count; ++i)
+            sumOfSquares += data[i] * data[i];
+        
+        return { range.getStart(), range.getEnd(), std::sqrt(sumOfSquares / static_cast<float>(count)) };
+    }
+    
+    return peaks->getRange(channel, startSample, endSample);
 }
 
 void WaveformView::updateVisibleRange()
@@ -788,7 +1241,7 @@ void WaveformView::updateVisibleRange()
     double visibleLength = totalLength / zoomLevel;
     
     // Don't let visibleLength get silly
-    const double minLength = totalLength * 0.001;
+    const double minLength = juce::jmin(getMinVisibleLength(), totalLength);
     visibleLength = juce::jlimit(minLength, totalLength, visibleLength);
     
     // Clamp start so the window stays inside the file
@@ -798,14 +1251,25 @@ void WaveformView::updateVisibleRange()
     // Scrollbar is in seconds too - setCurrentRange(start, size)
     scrollBar.setRangeLimits(0.0, totalLength);
     scrollBar.setCurrentRange(visibleStart, visibleLength);
+    visibleRangeChanged();
+}
+
+void WaveformView::visibleRangeChanged()
+{
+    if (onVisibleRangeChanged)
+        onVisibleRangeChanged();
 }
 
 double WaveformView::getPlaybackLengthSeconds() const
 {
-    double totalLength = thumbnail.getTotalLength();
-    if (totalLength <= 0.0 && projectState.hasAudio())
-        totalLength = projectState.getLengthInSeconds();
-    return totalLength;
+    if (!projectState.hasAudio() || projectState.getSampleRate() <= 0.0)
+        return 0.0;
+    
+    // Padding plus the audio from the effective start onwards
+    const int64 totalSamples = projectState.getNumSamples();
+    const int64 paddingSamples = juce::jlimit<int64>(0, totalSamples, projectState.getPaddingSamples());
+    const int64 effectiveStart = juce::jlimit<int64>(0, totalSamples, projectState.getEffectivePlaybackStart());
+    return static_cast<double>(totalSamples - effectiveStart + paddingSamples) / projectState.getSampleRate();
 }
 
 int64 WaveformView::sampleAtX(int x) const
@@ -813,27 +1277,31 @@ int64 WaveformView::sampleAtX(int x) const
     auto bounds = getLocalBounds().reduced(4);
     double ratio = (x - bounds.getX()) / static_cast<double>(bounds.getWidth());
     double seconds = visibleStart + ratio * (visibleEnd - visibleStart);
-    int64 thumbnailSample = static_cast<int64>(seconds * projectState.getSampleRate());
+    // Round so clicks at sample-level zoom land on the nearest drawn sample
+    int64 timelineSample = static_cast<int64>(std::floor(seconds * projectState.getSampleRate() + 0.5));
     
-    // Convert from thumbnail position to projectState position
+    // Convert from timeline position to projectState position
     int64 effectiveStart = projectState.getEffectivePlaybackStart();
     int64 paddingSamples = projectState.getPaddingSamples();
-    int64 projectSample = effectiveStart + thumbnailSample - paddingSamples;
+    int64 projectSample = effectiveStart + timelineSample - paddingSamples;
     projectSample = juce::jlimit<int64>(0, projectState.getNumSamples(), projectSample);
     return projectSample;
 }
 
 int WaveformView::xAtSample(int64 sample) const
 {
-    auto bounds = getLocalBounds().reduced(4);
-    
-    // Convert from projectState position to thumbnail position
+    // Convert from projectState position to timeline position
     int64 effectiveStart = projectState.getEffectivePlaybackStart();
     int64 paddingSamples = projectState.getPaddingSamples();
-    int64 thumbnailSample = sample - effectiveStart + paddingSamples;
-    thumbnailSample = juce::jmax<int64>(0, thumbnailSample);
+    int64 timelineSample = sample - effectiveStart + paddingSamples;
+    timelineSample = juce::jmax<int64>(0, timelineSample);
     
-    double seconds = thumbnailSample / projectState.getSampleRate();
+    return xAtTimelineSeconds(timelineSample / projectState.getSampleRate());
+}
+
+int WaveformView::xAtTimelineSeconds(double seconds) const
+{
+    auto bounds = getLocalBounds().reduced(4);
     double range = juce::jmax(0.000001, visibleEnd - visibleStart);
     double ratio = (seconds - visibleStart) / range;
     return bounds.getX() + static_cast<int>(ratio * bounds.getWidth());
@@ -863,7 +1331,10 @@ void WaveformView::drawHotkeyLegend(juce::Graphics& g, const juce::Rectangle<int
         "CTRL+Scroll = Zoom",
         "Z = Add Loop Start Point",
         "X = Add Loop End Point",
-        "Space = Play/Pause"
+        "Space = Play/Pause",
+        "Drag = Scrub",
+        "Scroll = Pan",
+        "G = Toggle Zero-Crossing Snap"
     };
     constexpr int legendLineCount = static_cast<int>(sizeof(legendLines) / sizeof(legendLines[0]));
     auto legendFont = g.getCurrentFont().withHeight(11.0f);
@@ -884,6 +1355,9 @@ void WaveformView::drawHotkeyLegend(juce::Graphics& g, const juce::Rectangle<int
         legendWidth,
         legendHeight);
 
+    if (!g.clipRegionIntersects(legendBounds))
+        return;
+
     g.setColour(CustomLookAndFeel::darkControl.withAlpha(0.85f));
     g.fillRoundedRectangle(legendBounds.toFloat(), 6.0f);
 
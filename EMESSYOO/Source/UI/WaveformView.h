@@ -1,7 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
 #include "../Core/MSUProjectState.h"
+#include "../Audio/PeakPyramid.h"
+#include "../Audio/PeakFileCache.h"
+#include "../Audio/ZeroCrossingIndex.h"
 
 //==============================================================================
 /**
@@ -23,6 +27,22 @@ public:
 /**
  * Displays waveform with zoom and scroll capabilities.
  * Will host loop markers for visual editing.
+ *
+ * The waveform is drawn from a PeakPyramid built on a background thread once
+ * per audio version. Trim and padding only shift how the timeline maps onto
+ * it, so dragging markers never rebuilds anything. Pyramids for audio that
+ * came straight from a file are kept in the PeakFileCache, so reopening the
+ * file shows the waveform without building.
+ *
+ * The waveform, padding shading and ruler are rendered into fixed-width tiles
+ * that are reused while scrolling and only re-rendered when the zoom, size,
+ * audio or trim/padding offsets change. Markers and the playhead are drawn
+ * over them, and playback only repaints the strips the playhead moves across.
+ * Zooming in past one sample per pixel draws the samples themselves as a
+ * line, with a dot on each sample once they are far enough apart.
+ *
+ * With snapping on, dragged, nudged and hotkey-placed markers move to the
+ * nearby zero crossing that splices most cleanly against the other loop marker.
  */
 class WaveformView : public juce::Component,
                      public juce::ChangeListener,
@@ -51,50 +71,154 @@ public:
     void setZoomLevel(double newZoom);
     double getZoomLevel() const { return zoomLevel; }
     
+    // Zoom at which minVisibleSamples fill the view
+    double getMaxZoomLevel() const;
+    
     void setPlayPosition(double seconds);
     void setAutoScrollEnabled(bool enabled) { autoScrollEnabled = enabled; }
     
+    void setSnapToZeroCrossings(bool enabled) { snapToZeroCrossings = enabled; repaint(); }
+    bool isSnapToZeroCrossingsEnabled() const { return snapToZeroCrossings; }
+    
+    // Visible window of the timeline, in seconds from the start of the padding
+    double getVisibleStart() const { return visibleStart; }
+    double getVisibleEnd() const { return visibleEnd; }
+    
     std::function<void(double)> onPositionClicked;
     
+    // Called whenever zooming or scrolling moves the visible window
+    std::function<void()> onVisibleRangeChanged;
+    
+    // Scrub callbacks, in project sample positions: fired when a drag starts,
+    // as the dragged playhead/handle moves, and when the mouse is released
+    std::function<void(int64)> onScrubStart;
+    std::function<void(int64)> onScrubMove;
+    std::function<void()> onScrubEnd;
+    
 private:
     //==============================================================================
     MSUProjectState& projectState;
     
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbnailCache;
-    juce::AudioThumbnail thumbnail;
     PassThroughScrollBar scrollBar;
     
+    // Loads the pyramid from the disk cache or builds it, then the zero-crossing
+    // index, from the project's shared snapshot, so the project can replace its
+    // audio while the job runs. Audio still exactly as decoded from sourceFile is
+    // keyed for the disk cache here too, since that means reading the file
+    struct AnalysisJob : public juce::ThreadPoolJob
+    {
+        AnalysisJob(WaveformView& view, std::shared_ptr<const juce::AudioBuffer<float>> buffer,
+                    double sampleRate, uint32 version, const juce::File& decodedFrom);
+        JobStatus runJob() override;
+        PeakPyramid::Ptr loadCachedPeaks(uint64& cacheKey) const;
+        
+        juce::Component::SafePointer<WaveformView> owner;
+        std::shared_ptr<const juce::AudioBuffer<float>> audio;
+        double audioSampleRate;
+        uint32 audioVersion;
+        juce::File sourceFile;  // invalid unless the audio is still the decoded file
+    };
+    
+    PeakPyramid::Ptr peaks;
+    ZeroCrossingIndex::Ptr crossings;
+    juce::ThreadPool analysisPool { 1 };
+    bool snapToZeroCrossings = true;
+    
+    static constexpr int snapRadiusPixels = 8;
+    static constexpr int64 minSnapRadiusSamples = 32;
+    
+    // Everything a rendered tile depends on apart from its position
+    struct TileKey
+    {
+        double secondsPerPixel = 0.0;
+        int height = 0;
+        float scale = 1.0f;
+        const PeakPyramid* peaks = nullptr;
+        uint32 audioVersion = 0;
+        int64 effectiveStart = 0;
+        int64 paddingSamples = 0;
+        
+        bool matches(const TileKey& other) const
+        {
+            // Scrolling recomputes the visible range, so allow for rounding in the zoom
+            return std::abs(secondsPerPixel - other.secondsPerPixel) <= secondsPerPixel * 1.0e-9
+                && height == other.height
+                && juce::approximatelyEqual(scale, other.scale)
+                && peaks == other.peaks
+                && audioVersion == other.audioVersion
+                && effectiveStart == other.effectiveStart
+                && paddingSamples == other.paddingSamples;
+        }
+    };
+    
+    static constexpr double minZoomLevel = 0.1;
+    static constexpr double minVisibleSamples = 16.0;
+    static constexpr double sampleDotMinSpacing = 6.0;  // pixels between samples before dots are drawn
+    static constexpr double panWheelFraction = 0.25;    // share of the view panned per wheel unit
+    
+    static constexpr int tileWidth = 256;
+    static constexpr int maxCachedTiles = 32;
+    static constexpr int rulerHeight = 20;
+    
+    TileKey tileKey;
+    std::map<int64, juce::Image> tileCache;  // keyed by tile index along the timeline
+    
     double zoomLevel = 1.0;
     double visibleStart = 0.0;
     double visibleEnd = 0.0;
     
     double playPosition = 0.0;
     bool autoScrollEnabled = true;
+    uint32 lastAudioVersion = 0;
     int64 lastNumSamples = 0;
     int64 lastEffectiveStart = 0;
     int64 lastPaddingSamples = 0;
-    double lastThumbnailLengthSeconds = 0.0;
     
     enum DragMode
     {
         None,
         TrimStart,
         LoopStart,
-        LoopEnd
+        LoopEnd,
+        Scrub
     };
     
     DragMode currentDragMode = None;
     DragMode selectedHandle = None;  // For fine-tuning with wheel
+    bool isScrubbing = false;
     
     float fineTuneAccumulator = 0.0f;
     float zoomAccumulator = 0.0f;
     
-    void updateThumbnail();
+    void rebuildPeaks();
+    void peaksReady(PeakPyramid::Ptr newPeaks);
+    void crossingsReady(ZeroCrossingIndex::Ptr newCrossings);
+    
+    int64 getHandleSample(DragMode handle) const;
+    void setHandleSample(DragMode handle, int64 sample);
+    void nudgeSelectedHandle(int64 delta);
+    void placeHandle(DragMode handle, int64 sample);
+    int64 snapHandle(DragMode handle, int64 target, int64 searchStart, int64 searchEnd) const;
+    int64 getSnapRadiusSamples() const;
+    void drawTiles(juce::Graphics& g, const juce::Rectangle<int>& bounds);
+    juce::Image renderTile(int64 tileIndex) const;
+    void drawWaveform(juce::Graphics& g, const juce::Rectangle<int>& area,
+                      int64 firstColumn, double secondsPerPixel) const;
+    void drawSamples(juce::Graphics& g, const juce::Rectangle<int>& area, int64 firstColumn,
+                     double samplesPerPixel, float laneHeight) const;
+    void drawRuler(juce::Graphics& g, const juce::Rectangle<int>& rulerBounds,
+                   int64 firstColumn, double secondsPerPixel) const;
+    static juce::String formatRulerLabel(int64 microseconds, int64 majorTickInterval);
+    void setVisibleStart(double newStart);
+    double getMinVisibleLength() const;
+    void repaintPlayhead(double seconds);
+    PeakPyramid::Peak getColumnPeak(int channel, int64 startSample, int64 endSample) const;
     void updateVisibleRange();
+    void visibleRangeChanged();
     double getPlaybackLengthSeconds() const;
     int64 sampleAtX(int x) const;
     int xAtSample(int64 sample) const;
+    int xAtTimelineSeconds(double seconds) const;
     int getTrimHandleX() const;
     double timelineSecondsAtX(int x) const;
     void drawHotkeyLegend(juce::Graphics& g, const juce::Rectangle<int>& waveformBounds) const;